@@ -0,0 +1,222 @@
+/** \file Benchmark.cpp
+* Times the phases of the analysis of generated models: parse, assemble,
+* solve and post-process.
+*/
+
+#include "BinaryIntegration.h"
+#include "JSONIntegration.h"
+#include "ModelGenerators.h"
+#include "Parallel.h"
+#include "ResultsIntegration.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//! The best times of the phases of one benchmark case, in seconds.
+struct TBenchmarkTimes {
+    double fGenerate = 1e300;
+    double fParseJSON = 1e300;
+    double fParseBinary = 1e300;
+    double fAssemble = 1e300;
+    double fSolve = 1e300;
+    double fPostProcess = 1e300;
+};
+
+//! Gets the seconds elapsed since a given time.
+double secondsSince(std::chrono::steady_clock::time_point Start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+//! Parses a list of comma separated integers.
+std::vector<int> parseSizes(const std::string& Text) {
+    std::vector<int> sizes;
+    std::stringstream stream(Text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        sizes.push_back((int)std::atof(item.c_str()));
+    }
+    return sizes;
+}
+
+//! Gets the solver type of a command line name.
+bool parseSolver(const std::string& Name, ESolverType& Type) {
+    const char* names[] = {"dense", "skyline", "amd", "nd", "pcg"};
+    const ESolverType types[] = {EDenseCholesky, ESkylineLDLt, ESparseCholeskyAMD,
+                                 ESparseCholeskyND, EPreconditionedCG};
+    for (int i = 0; i < 5; i++) {
+        if (Name == names[i]) {
+            Type = types[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char** argv) {
+    std::vector<EModelType> types;
+    std::vector<int> sizes = {10, 100, 1000, 10000, 100000};
+    std::string solverName = "amd";
+    ESolverType solver = ESparseCholeskyAMD;
+    int nThreads = 0, nRepeats = 3;
+    unsigned seed = 1;
+    bool parse = true;
+    bool condenseHinges = false;
+    int nSubdomains = 1;
+
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (hasValue && option == "--model") {
+            std::string name = argv[++i];
+            for (int t = 0; t < ENModelTypes; t++) {
+                if (name == "all" || name == getModelTypeName((EModelType)t)) {
+                    types.push_back((EModelType)t);
+                }
+            }
+            if (types.empty()) {
+                std::cerr << "Unknown model " << name << std::endl;
+                return 1;
+            }
+        } else if (hasValue && option == "--elements") {
+            sizes = parseSizes(argv[++i]);
+        } else if (hasValue && option == "--solver") {
+            solverName = argv[++i];
+            if (!parseSolver(solverName, solver)) {
+                std::cerr << "Unknown solver " << solverName << std::endl;
+                return 1;
+            }
+        } else if (hasValue && option == "--threads") {
+            nThreads = std::atoi(argv[++i]);
+        } else if (hasValue && option == "--repeat") {
+            nRepeats = std::max(1, std::atoi(argv[++i]));
+        } else if (hasValue && option == "--seed") {
+            seed = (unsigned)std::atoi(argv[++i]);
+        } else if (option == "--no-parse") {
+            parse = false;
+        } else if (option == "--condense-hinges") {
+            condenseHinges = true;
+        } else if (hasValue && option == "--subdomains") {
+            nSubdomains = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--model portal|pratt|warren|grid|random|all]"
+                      << " [--elements N[,N...]] [--solver dense|skyline|amd|nd|pcg]"
+                      << " [--threads N] [--repeat R] [--seed S] [--no-parse]"
+                      << " [--condense-hinges] [--subdomains P]" << std::endl;
+            return 1;
+        }
+    }
+    if (types.empty()) {
+        for (int t = 0; t < ENModelTypes; t++) {
+            types.push_back((EModelType)t);
+        }
+    }
+
+    std::filesystem::path temporary = std::filesystem::temp_directory_path();
+    std::string binaryName = (temporary / "jstatics_benchmark.jsb").string();
+    std::string resultsName = (temporary / "jstatics_benchmark.jsr").string();
+
+    std::cout << "Solver " << solverName << ", " << getNumberOfThreads(nThreads)
+              << " threads, best of " << nRepeats << " runs (seconds)"
+              << (condenseHinges ? ", condensed hinges" : "");
+    if (nSubdomains > 1) std::cout << ", " << nSubdomains << " subdomains";
+    std::cout << "." << std::endl;
+    std::cout << std::left << std::setw(8) << "model" << std::right
+              << std::setw(9) << "elements" << std::setw(9) << "DOF"
+              << std::setw(11) << "generate" << std::setw(11) << "parseJSON"
+              << std::setw(11) << "parseBin" << std::setw(11) << "assemble"
+              << std::setw(11) << "solve" << std::setw(11) << "post" << std::endl;
+
+    for (EModelType type : types) {
+        for (int size : sizes) {
+            TBenchmarkTimes times;
+            int nElements = 0, nDOF = 0;
+
+            for (int r = 0; r < nRepeats; r++) {
+                TStructure structure;
+                std::vector<TNodalLoad> nodalLoads;
+                std::vector<TDistributedLoad> distrLoads;
+                std::vector<TElementEndMoment> endMoments;
+                auto start = std::chrono::steady_clock::now();
+                generateModel(type, size, seed, &structure, nodalLoads, distrLoads,
+                              endMoments);
+                times.fGenerate = std::min(times.fGenerate, secondsSince(start));
+
+                // Parses the model back from its JSON text and binary file.
+                if (parse) {
+                    nlohmann::json J;
+                    exportData(J, &structure, nodalLoads, distrLoads, endMoments);
+                    std::istringstream text(J.dump());
+                    J = nlohmann::json();
+                    TStructure parsed;
+                    std::vector<TNodalLoad> parsedNodalLoads;
+                    std::vector<TDistributedLoad> parsedDistrLoads;
+                    std::vector<TElementEndMoment> parsedEndMoments;
+                    start = std::chrono::steady_clock::now();
+                    importData(text, &parsed, parsedNodalLoads, parsedDistrLoads,
+                               parsedEndMoments);
+                    times.fParseJSON = std::min(times.fParseJSON, secondsSince(start));
+
+                    exportBinary(binaryName, &structure, nodalLoads, distrLoads, endMoments);
+                    TStructure mapped;
+                    parsedNodalLoads.clear();
+                    parsedDistrLoads.clear();
+                    parsedEndMoments.clear();
+                    start = std::chrono::steady_clock::now();
+                    importBinary(binaryName, &mapped, parsedNodalLoads, parsedDistrLoads,
+                                 parsedEndMoments);
+                    times.fParseBinary = std::min(times.fParseBinary, secondsSince(start));
+                }
+
+                // The profile of the solve splits assembly, solution and
+                // internal loads.
+                structure.setSolverType(solver);
+                structure.setNumberOfThreads(nThreads);
+                structure.setCondenseHinges(condenseHinges);
+                structure.setNumberOfSubdomains(nSubdomains);
+                std::vector<TPZFMatrix<double>> internalLoads;
+                structure.solve(nodalLoads, distrLoads, endMoments, internalLoads);
+                const TSolveProfile& profile = structure.getProfile();
+                double assemble = profile.getSeconds(EEnumerateEquations) +
+                                  profile.getSeconds(EPopulateK) +
+                                  profile.getSeconds(EPopulateQ) +
+                                  profile.getSeconds(EPopulateQ0);
+                double solve = profile.getSeconds(ESolveDU) + profile.getSeconds(ESolveQU);
+                times.fAssemble = std::min(times.fAssemble, assemble);
+                times.fSolve = std::min(times.fSolve, solve);
+
+                start = std::chrono::steady_clock::now();
+                exportResults(resultsName, &structure);
+                double post = profile.getSeconds(EInternalLoads) + secondsSince(start);
+                times.fPostProcess = std::min(times.fPostProcess, post);
+
+                nElements = (int)internalLoads.size();
+                nDOF = structure.getUDOF();
+            }
+
+            std::cout << std::left << std::setw(8) << getModelTypeName(type) << std::right
+                      << std::setw(9) << nElements << std::setw(9) << nDOF
+                      << std::scientific << std::setprecision(3)
+                      << std::setw(11) << times.fGenerate;
+            if (parse) {
+                std::cout << std::setw(11) << times.fParseJSON
+                          << std::setw(11) << times.fParseBinary;
+            } else {
+                std::cout << std::setw(11) << "-" << std::setw(11) << "-";
+            }
+            std::cout << std::setw(11) << times.fAssemble << std::setw(11) << times.fSolve
+                      << std::setw(11) << times.fPostProcess << std::defaultfloat
+                      << std::endl;
+        }
+    }
+
+    std::remove(binaryName.c_str());
+    std::remove(resultsName.c_str());
+    return 0;
+}
@@ -0,0 +1,50 @@
+/** \file ModelConverter.cpp
+* Converts model files between the JSON and the binary formats.
+*/
+
+#include "BinaryIntegration.h"
+#include "JSONIntegration.h"
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <input> <output>" << std::endl;
+        std::cerr << "Converts a JSON model into a binary one, or a binary "
+                     "model into JSON." << std::endl;
+        return 1;
+    }
+    std::string inputName = argv[1];
+    std::string outputName = argv[2];
+
+    TStructure structure;
+    std::vector<TNodalLoad> nodalLoads;
+    std::vector<TDistributedLoad> distrLoads;
+    std::vector<TElementEndMoment> endMoments;
+
+    if (isBinaryModel(inputName)) {
+        // Binary to JSON.
+        importBinary(inputName, &structure, nodalLoads, distrLoads, endMoments);
+        nlohmann::json J;
+        exportData(J, &structure, nodalLoads, distrLoads, endMoments);
+        std::ofstream output(outputName);
+        output << std::setw(4) << J << std::endl;
+        if (!output) {
+            std::cerr << "Cannot write " << outputName << std::endl;
+            return 1;
+        }
+    } else {
+        // JSON to binary.
+        std::ifstream input(inputName);
+        if (!input) {
+            std::cerr << "Cannot read " << inputName << std::endl;
+            return 1;
+        }
+        importData(input, &structure, nodalLoads, distrLoads, endMoments);
+        exportBinary(outputName, &structure, nodalLoads, distrLoads, endMoments);
+    }
+
+    std::cout << "Converted " << structure.getNodes().size() << " nodes and "
+              << structure.getElements().size() << " elements." << std::endl;
+    return 0;
+}
@@ -1,48 +1,166 @@
+#include "Batch.h"
 #include "JSONIntegration.h"
+#include "Parallel.h"
+#include "ResultsIntegration.h"
 #include "TDistributedLoad.h"
 #include "TElement.h"
 #include "TElementEndMoment.h"
 #include "TNodalLoad.h"
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 
 using json = nlohmann::json;
 
-int main() {
+//! Solves the models of a directory, glob or manifest on a pool of threads.
+int runBatch(int argc, char** argv) {
+    std::string source, outputDirectory, summaryName, profileName;
+    int nThreads = 0;
+    for (int i = 2; i < argc; i++) {
+        std::string option = argv[i];
+        if (i + 1 < argc && option == "--threads") {
+            nThreads = std::atoi(argv[++i]);
+        } else if (i + 1 < argc && option == "--output") {
+            outputDirectory = argv[++i];
+        } else if (i + 1 < argc && option == "--summary") {
+            summaryName = argv[++i];
+        } else if (i + 1 < argc && option == "--profile") {
+            profileName = argv[++i];
+        } else if (source.empty()) {
+            source = option;
+        } else {
+            source.clear();
+            break;
+        }
+    }
+    if (source.empty()) {
+        cerr << "Usage: " << argv[0] << " --batch <directory|glob|manifest>"
+             << " [--threads N] [--output <directory>] [--summary <file>]"
+             << " [--profile <file>]" << endl;
+        return 1;
+    }
+
+    std::vector<std::string> fileNames = findModelFiles(source);
+    if (fileNames.empty()) {
+        cerr << "No models found in " << source << endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<TBatchResult> results;
+    solveBatch(fileNames, outputDirectory, nThreads, results);
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start).count();
+
+    // Writes the summaries of all models into one file, in input order.
+    if (!summaryName.empty()) {
+        ofstream summary(summaryName);
+        for (size_t i = 0; i < results.size(); i++) {
+            summary << "Model " << results[i].fFileName << endl;
+            if (results[i].fSolved) {
+                summary << results[i].fSummary;
+            } else {
+                summary << "  not solved: " << results[i].fMessage << endl;
+            }
+        }
+    }
+
+    // Writes the cost of each phase, added over all models.
+    if (!profileName.empty()) {
+        TSolveProfile profile;
+        for (size_t i = 0; i < results.size(); i++) {
+            profile.add(results[i].fProfile);
+        }
+        ofstream report(profileName);
+        profile.printJSON(report);
+    }
+
+    int nSolved = 0;
+    for (size_t i = 0; i < results.size(); i++) {
+        if (results[i].fSolved) {
+            nSolved++;
+        } else {
+            cerr << results[i].fFileName << ": " << results[i].fMessage << endl;
+        }
+    }
+    cout << "Solved " << nSolved << " of " << results.size() << " models in "
+         << seconds << " s (" << nSolved / seconds << " models/s, "
+         << getNumberOfThreads(nThreads) << " threads)." << endl;
+    return (nSolved == (int)results.size()) ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        return runBatch(argc, argv);
+    }
+    // By default only the summary of the results is printed. The node
+    // equations, K and the internal loads of each element are printed with
+    // --verbose; K is written as a dense NDOF x NDOF matrix.
+    bool printProfile = false, verbose = false;
+    std::string resultsName = "Results.jsr";
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--profile") {
+            printProfile = true;
+        } else if (option == "--verbose") {
+            verbose = true;
+        } else if (i + 1 < argc && option == "--results") {
+            resultsName = argv[++i];
+        } else {
+            cerr << "Usage: " << argv[0] << " [--verbose] [--profile]"
+                 << " [--results <file>]" << endl;
+            cerr << "       " << argv[0] << " --batch <directory|glob|manifest>"
+                 << " [options]" << endl;
+            return 1;
+        }
+    }
+
     // Reads input JSON file and converts it into a TStructure object and vectors
-    // of each type of load.
+    // of each type of load, streaming it without building the JSON document.
     ifstream input("InputJSON.json");
-    json J;
-    input >> J;
 
     TStructure structure;
     std::vector<TNodalLoad> nodalLoads;
     std::vector<TDistributedLoad> distrLoads;
     std::vector<TElementEndMoment> endMoments;
-    importData(J, &structure, nodalLoads, distrLoads, endMoments);
+    importData(input, &structure, nodalLoads, distrLoads, endMoments);
 
     // Solves structure.
     std::vector<TPZFMatrix<double>> internalLoads;
-    TPZFMatrix<double> loadVector, displacementVector;
     structure.solve(nodalLoads, distrLoads, endMoments, internalLoads);
+    TSolveProfile profile = structure.getProfile();
+
+    if (verbose) {
+        // Displays the node equation numbering matrix.
+        cout << "Node equations:" << endl;
+        structure.getNodeEquations().Print(cout);
 
-    // Displays the node equation numbering matrix.
-    cout << "Node equations:" << endl;
-    structure.enumerateEquations();
-    structure.getNodeEquations().Print(cout);
+        // Displays the Global Stiffness Matrix K.
+        cout << "Stiffness matrix K:" << endl;
+        structure.getK().Print(cout);
 
-    // Displays the Global Stiffness Matrix K.
-    cout << "Stiffness matrix K:" << endl;
-    structure.getK().Print(cout);
+        // Displays results.
+        cout << "Displacement vector:" << endl;
+        structure.getD().Print(cout);
+        cout << "Load vector:" << endl;
+        structure.getQ().Print(cout);
+
+        for (size_t i = 0; i < internalLoads.size(); i++) {
+            cout << "Internal loads at element " << i << ":" << endl;
+            internalLoads[i].Print(cout);
+        }
+    }
 
-    // Displays results.
-    cout << "Displacement vector:" << endl;
-    displacementVector.Print(cout);
-    cout << "Load vector:" << endl;
-    loadVector.Print(cout);
+    // Writes the results into a binary file for post-processing and prints
+    // their summary.
+    exportResults(resultsName, &structure);
+    cout << "Summary:" << endl;
+    printResultsSummary(cout, &structure);
 
-    for (size_t i = 0; i < internalLoads.size(); i++) {
-        cout << "Internal loads at element " << i << ":" << endl;
-        internalLoads[i].Print(cout);
+    // Displays the cost of each phase of the solve as JSON.
+    if (printProfile) {
+        cout << "Profile:" << endl;
+        profile.printJSON(cout);
     }
 
 #ifdef _WIN32
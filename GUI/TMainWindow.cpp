@@ -317,17 +317,19 @@ void TMainWindow::setCurrentFile(const QString &fileName) {
         emit updateNewAction(false);
     } else {
         // Reads input JSON file and converts into a TStructure object
-        // and vectors of each type of load.
+        // and vectors of each type of load. The TStructure object is kept
+        // between saves, so that it can reuse its factorization when only
+        // the loads were edited.
         std::ifstream input(fCurFile.toStdString().c_str());
-        nlohmann::json J;
-        input >> J;
 
-        fStructure = new TStructure();
+        if (fStructure == nullptr) {
+            fStructure = new TStructure();
+        }
         std::vector<TNodalLoad> nodalLoads;
         std::vector<TDistributedLoad> distrLoads;
         std::vector<TElementEndMoment> endMoments;
         //	std::vector<TSupportDisplacement> supportDisplacaments;
-        importData(J, fStructure, nodalLoads, distrLoads, endMoments);
+        importData(input, fStructure, nodalLoads, distrLoads, endMoments);
 
         // Solves structure.
         std::vector<TPZFMatrix<double>> internalLoads(0, 0);
@@ -460,7 +462,7 @@ void TMainWindow::on_saveChangesButton_clicked() { save(); }
 
 void TMainWindow::drawReactions(QGraphicsScene *Scene) {
     // Draws reactions.
-    TPZFMatrix<double> reactions = fStructure->getQU();
+    TDenseBlock reactions = fStructure->getQU();
 
     std::vector<TSupport> supports = fStructure->getSupports();
     int CDOF = 0;
@@ -1249,7 +1251,7 @@ void TMainWindow::populateDisplacement(double drawingSize) {
 
         // Fills the local displacements d with the global displacement matrix
         // at the proper DOF indexes.
-        TPZFMatrix<double> d(6, 1, 0);
+        TElementVector d;
         d(0, 0) = D[fx0DOF];
         d(1, 0) = D[fy0DOF];
         d(2, 0) = D[m0DOF];
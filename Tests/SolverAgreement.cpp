@@ -0,0 +1,264 @@
+/** \file SolverAgreement.cpp
+* Checks that every solver and solve mode gives the results of the dense
+* Cholesky solve on the generated models.
+*/
+
+#include "ModelGenerators.h"
+#include "TLoadCase.h"
+#include "TLoadCaseResult.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+//! The number of elements of the generated models.
+const int kNElements = 200;
+//! The seed of the generated models.
+const unsigned kSeed = 7;
+//! The largest relative difference accepted from the direct solvers.
+const double kDirectTolerance = 1e-8;
+//! The largest relative difference accepted from the iterative solver.
+const double kIterativeTolerance = 1e-6;
+
+//! A generated model and its load cases.
+struct TTestModel {
+    TStructure fStructure;
+    std::vector<TNodalLoad> fNodalLoads;
+    std::vector<TDistributedLoad> fDistributedLoads;
+    std::vector<TElementEndMoment> fEndMoments;
+    std::vector<TLoadCase> fLoadCases;
+};
+
+//! Generates a model with three load cases: all the loads, the nodal loads and the distributed loads.
+void buildModel(EModelType Type, TTestModel& Model) {
+    generateModel(Type, kNElements, kSeed, &Model.fStructure, Model.fNodalLoads,
+                  Model.fDistributedLoads, Model.fEndMoments);
+    Model.fLoadCases = {
+        TLoadCase("all", Model.fNodalLoads, Model.fDistributedLoads, Model.fEndMoments),
+        TLoadCase("nodal", Model.fNodalLoads),
+        TLoadCase("distributed", {}, Model.fDistributedLoads)};
+}
+
+//! Gets the largest difference of the element end displacements and internal loads of two solves, relative to the first one.
+double compareResults(TStructure& Reference, const std::vector<TLoadCaseResult>& ReferenceResults,
+                      TStructure& Structure, const std::vector<TLoadCaseResult>& Results) {
+    // The DOF are compared through the elements, since the numbering
+    // depends on the solve mode.
+    std::vector<TElement> referenceElements = Reference.getElements();
+    std::vector<TElement> elements = Structure.getElements();
+    if (elements.size() != referenceElements.size() ||
+        Results.size() != ReferenceResults.size()) {
+        return 1e300;
+    }
+
+    double maxD = 1e-300, errorD = 0.;
+    double maxQ = 1e-300, errorQ = 0.;
+    for (size_t c = 0; c < Results.size(); c++) {
+        const TPZFMatrix<double>& referenceD = ReferenceResults[c].getD();
+        const TPZFMatrix<double>& D = Results[c].getD();
+        const std::vector<TPZFMatrix<double>>& referenceQ = ReferenceResults[c].getInternalLoads();
+        const std::vector<TPZFMatrix<double>>& q = Results[c].getInternalLoads();
+        for (size_t e = 0; e < elements.size(); e++) {
+            for (int j = 0; j < 6; j++) {
+                double a = referenceD.GetVal(referenceElements[e].getEquations()[j], 0);
+                double b = D.GetVal(elements[e].getEquations()[j], 0);
+                maxD = std::max(maxD, std::fabs(a));
+                errorD = std::max(errorD, std::fabs(a - b));
+                maxQ = std::max(maxQ, std::fabs(referenceQ[e].GetVal(j, 0)));
+                errorQ = std::max(errorQ, std::fabs(referenceQ[e].GetVal(j, 0) - q[e].GetVal(j, 0)));
+            }
+        }
+    }
+    return std::max(errorD / maxD, errorQ / maxQ);
+}
+
+//! Groups the elements of a model in square blocks, about three per side.
+std::vector<std::vector<int>> getBlocks(TStructure& Structure) {
+    std::vector<TNode> nodes = Structure.getNodes();
+    double minX = 1e300, maxX = -1e300, minY = 1e300, maxY = -1e300;
+    for (const TNode& node : nodes) {
+        minX = std::min(minX, node.getX());
+        maxX = std::max(maxX, node.getX());
+        minY = std::min(minY, node.getY());
+        maxY = std::max(maxY, node.getY());
+    }
+    double size = std::max(maxX - minX, maxY - minY) / 3. + 1e-9;
+
+    std::map<std::pair<int, int>, std::vector<int>> blocks;
+    std::vector<TElement> elements = Structure.getElements();
+    for (int e = 0; e < (int)elements.size(); e++) {
+        const TNode& node0 = nodes[elements[e].getNode0ID()];
+        const TNode& node1 = nodes[elements[e].getNode1ID()];
+        double x = 0.5 * (node0.getX() + node1.getX()) - minX;
+        double y = 0.5 * (node0.getY() + node1.getY()) - minY;
+        blocks[{(int)std::floor(x / size), (int)std::floor(y / size)}].push_back(e);
+    }
+
+    std::vector<std::vector<int>> substructures;
+    for (const auto& block : blocks) {
+        substructures.push_back(block.second);
+    }
+    return substructures;
+}
+
+//! Changes the material of a few elements and toggles a few hinges.
+void modifyModel(std::vector<TMaterial>& Materials, std::vector<TElement>& Elements) {
+    int nElements = Elements.size();
+    TMaterial material = Materials[Elements[0].getMaterialID()];
+    material.setE(2. * material.getE());
+    material.setI(1.5 * material.getI());
+    Materials.push_back(material);
+    Elements[nElements / 3].setMaterialID(Materials.size() - 1);
+    Elements[nElements / 2].setMaterialID(Materials.size() - 1);
+    Elements[2 * nElements / 3].setHinge0(!Elements[2 * nElements / 3].getHinge0());
+}
+
+//! Counts the checks that ran and those that failed.
+struct TTestCounter {
+    int fChecks = 0;
+    int fFailures = 0;
+
+    //! Records and prints one check.
+    void check(bool Passed, const std::string& Name, double Error) {
+        fChecks++;
+        if (!Passed) fFailures++;
+        std::printf("%s %-48s rel. difference %.2e\n", Passed ? "PASS" : "FAIL",
+                    Name.c_str(), Error);
+    }
+};
+
+//! The settings of one solve mode checked against the dense solve.
+struct TSolveMode {
+    const char* fName;
+    ESolverType fSolver;
+    EPreconditioner fPreconditioner;
+    bool fRenumber;
+    bool fSymmetric;
+    bool fCondenseHinges;
+    bool fSubstructures;
+    int fSubdomains;
+    int fThreads;
+};
+
+//! Solves a model in each solve mode and compares it with the dense solve.
+void checkSolveModes(EModelType Type, TTestCounter& Counter) {
+    const TSolveMode modes[] = {
+        {"skyline", ESkylineLDLt, EJacobi, false, true, false, false, 1, 1},
+        {"skyline, RCM renumbering", ESkylineLDLt, EJacobi, true, true, false, false, 1, 1},
+        {"dense, RCM renumbering", EDenseCholesky, EJacobi, true, true, false, false, 1, 1},
+        {"sparse AMD", ESparseCholeskyAMD, EJacobi, false, true, false, false, 1, 1},
+        {"sparse AMD, full storage, 4 threads", ESparseCholeskyAMD, EJacobi, false, false, false, false, 1, 4},
+        {"sparse ND", ESparseCholeskyND, EJacobi, false, true, false, false, 1, 1},
+        {"PCG, Jacobi", EPreconditionedCG, EJacobi, false, true, false, false, 1, 1},
+        {"PCG, block Jacobi", EPreconditionedCG, EBlockJacobi, false, true, false, false, 1, 1},
+        {"PCG, IC(0)", EPreconditionedCG, EIncompleteCholesky, false, true, false, false, 1, 1},
+        {"dense, condensed hinges", EDenseCholesky, EJacobi, false, true, true, false, 1, 1},
+        {"sparse AMD, condensed hinges", ESparseCholeskyAMD, EJacobi, false, true, true, false, 1, 1},
+        {"sparse AMD, substructures", ESparseCholeskyAMD, EJacobi, false, true, false, true, 1, 1},
+        {"skyline, substructures, condensed hinges", ESkylineLDLt, EJacobi, false, true, true, true, 1, 1},
+        {"sparse AMD, 4 subdomains", ESparseCholeskyAMD, EJacobi, false, true, false, false, 4, 1},
+        {"sparse ND, 4 subdomains, 2 threads", ESparseCholeskyND, EJacobi, false, true, false, false, 4, 2},
+        {"dense, 4 subdomains, condensed hinges", EDenseCholesky, EJacobi, false, true, true, false, 4, 1}};
+
+    TTestModel reference;
+    buildModel(Type, reference);
+    std::vector<TLoadCaseResult> referenceResults;
+    reference.fStructure.solve(reference.fLoadCases, referenceResults);
+
+    for (const TSolveMode& mode : modes) {
+        TTestModel model;
+        buildModel(Type, model);
+        TStructure& structure = model.fStructure;
+        structure.setSolverType(mode.fSolver);
+        structure.setPreconditioner(mode.fPreconditioner);
+        structure.setTolerance(1e-12);
+        structure.setRenumbering(mode.fRenumber);
+        structure.setSymmetricStorage(mode.fSymmetric);
+        structure.setCondenseHinges(mode.fCondenseHinges);
+        structure.setNumberOfSubdomains(mode.fSubdomains);
+        structure.setNumberOfThreads(mode.fThreads);
+        if (mode.fSubstructures) {
+            structure.setSubstructures(getBlocks(structure));
+        }
+
+        std::vector<TLoadCaseResult> results;
+        structure.solve(model.fLoadCases, results);
+        double error = compareResults(reference.fStructure, referenceResults, structure, results);
+        double tolerance = (mode.fSolver == EPreconditionedCG) ? kIterativeTolerance
+                                                               : kDirectTolerance;
+        Counter.check(error < tolerance, std::string(getModelTypeName(Type)) + ": " + mode.fName,
+                      error);
+    }
+}
+
+//! Solves a model again with other loads, reusing the factorization, and compares it with a new dense solve.
+void checkLoadReuse(EModelType Type, ESolverType Solver, TTestCounter& Counter) {
+    TTestModel model;
+    buildModel(Type, model);
+    model.fStructure.setSolverType(Solver);
+    std::vector<TLoadCaseResult> results;
+    model.fStructure.solve(model.fLoadCases, results);
+
+    std::vector<TLoadCase> loadCases = {TLoadCase("end moments", {}, {}, model.fEndMoments),
+                                        TLoadCase("distributed", {}, model.fDistributedLoads)};
+    model.fStructure.solve(loadCases, results);
+    bool reused = model.fStructure.getReusedFactorization();
+
+    TTestModel reference;
+    buildModel(Type, reference);
+    std::vector<TLoadCase> referenceCases = {
+        TLoadCase("end moments", {}, {}, reference.fEndMoments),
+        TLoadCase("distributed", {}, reference.fDistributedLoads)};
+    std::vector<TLoadCaseResult> referenceResults;
+    reference.fStructure.solve(referenceCases, referenceResults);
+
+    double error = compareResults(reference.fStructure, referenceResults, model.fStructure, results);
+    Counter.check(reused && error < kDirectTolerance,
+                  std::string(getModelTypeName(Type)) + ": load-only reuse", error);
+}
+
+//! Reanalyzes a model after a few changes and compares it with a new dense solve of the changed model.
+void checkReanalysis(EModelType Type, ESolverType Solver, TTestCounter& Counter) {
+    TTestModel model;
+    buildModel(Type, model);
+    model.fStructure.setSolverType(Solver);
+    std::vector<TLoadCaseResult> results;
+    model.fStructure.solve(model.fLoadCases, results);
+
+    std::vector<TMaterial> materials = model.fStructure.getMaterials();
+    std::vector<TElement> elements = model.fStructure.getElements();
+    modifyModel(materials, elements);
+    bool updated = model.fStructure.reanalyze(materials, elements, model.fLoadCases, results);
+
+    TTestModel reference;
+    buildModel(Type, reference);
+    std::vector<TMaterial> referenceMaterials = reference.fStructure.getMaterials();
+    std::vector<TElement> referenceElements = reference.fStructure.getElements();
+    modifyModel(referenceMaterials, referenceElements);
+    reference.fStructure.setMaterials(referenceMaterials);
+    reference.fStructure.setElements(referenceElements);
+    std::vector<TLoadCaseResult> referenceResults;
+    reference.fStructure.solve(reference.fLoadCases, referenceResults);
+
+    double error = compareResults(reference.fStructure, referenceResults, model.fStructure, results);
+    Counter.check(updated && error < kDirectTolerance,
+                  std::string(getModelTypeName(Type)) + ": reanalysis, " +
+                      (Solver == ESkylineLDLt ? "skyline" : "sparse AMD"),
+                  error);
+}
+
+int main() {
+    TTestCounter counter;
+    for (int type = 0; type < ENModelTypes; type++) {
+        checkSolveModes((EModelType)type, counter);
+        checkLoadReuse((EModelType)type, ESparseCholeskyAMD, counter);
+        checkReanalysis((EModelType)type, ESkylineLDLt, counter);
+        checkReanalysis((EModelType)type, ESparseCholeskyAMD, counter);
+    }
+
+    std::printf("%d of %d checks passed.\n", counter.fChecks - counter.fFailures,
+                counter.fChecks);
+    return (counter.fFailures == 0) ? 0 : 1;
+}
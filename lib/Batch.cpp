@@ -0,0 +1,203 @@
+/** \file Batch.cpp
+* Contains the definition of functions that find many model files and solve
+* them on a pool of threads.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include "Batch.h"
+#include "BinaryIntegration.h"
+#include "JSONIntegration.h"
+#include "Parallel.h"
+#include "ResultsIntegration.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+//! Checks if a file name matches a pattern with '*' and '?' wildcards.
+bool matchesPattern(const std::string& Name, const std::string& Pattern)
+{
+    // Greedy match that backtracks to the last '*'.
+    size_t n = 0, p = 0;
+    size_t starP = std::string::npos, starN = 0;
+    while (n < Name.size()) {
+        if (p < Pattern.size() && (Pattern[p] == '?' || Pattern[p] == Name[n])) {
+            n++;
+            p++;
+        } else if (p < Pattern.size() && Pattern[p] == '*') {
+            starP = p++;
+            starN = n;
+        } else if (starP != std::string::npos) {
+            p = starP + 1;
+            n = ++starN;
+        } else {
+            return false;
+        }
+    }
+    while (p < Pattern.size() && Pattern[p] == '*') p++;
+    return p == Pattern.size();
+}
+
+//! Checks if a file has the extension of a JSON or binary model.
+bool isModelFile(const fs::path& Path)
+{
+    std::string extension = Path.extension().string();
+    return extension == ".json" || extension == ".jsb";
+}
+
+//! Gets the names of the results files of a batch, one per model.
+std::vector<std::string> getResultsNames(const std::vector<std::string>& FileNames,
+                                         const std::string& OutputDirectory)
+{
+    int nModels = FileNames.size();
+    std::vector<std::string> names(nModels);
+    if (OutputDirectory.empty()) return names;
+
+    // Tries the model name, then the file name, then the position and the
+    // file name, until the name of each model is unique in the batch.
+    std::map<std::string, int> count;
+    for (int i = 0; i < nModels; i++) {
+        names[i] = fs::path(FileNames[i]).stem().string();
+        count[names[i]]++;
+    }
+    std::map<std::string, int> fileCount;
+    for (int i = 0; i < nModels; i++) {
+        if (count[names[i]] > 1) names[i] = fs::path(FileNames[i]).filename().string();
+        fileCount[names[i]]++;
+    }
+    for (int i = 0; i < nModels; i++) {
+        if (fileCount[names[i]] > 1) {
+            names[i] = std::to_string(i + 1) + "_" +
+                       fs::path(FileNames[i]).filename().string();
+        }
+        names[i] = (fs::path(OutputDirectory) / (names[i] + ".jsr")).string();
+    }
+    return names;
+}
+
+//! Reads and solves one model of a batch.
+void solveModel(const std::string& FileName, const std::string& ResultsName,
+                int NThreads, TBatchResult& Result)
+{
+    auto start = std::chrono::steady_clock::now();
+    Result.fFileName = FileName;
+    Result.fResultsName = ResultsName;
+
+    TStructure structure;
+    structure.setNumberOfThreads(NThreads);
+    std::vector<TNodalLoad> nodalLoads;
+    std::vector<TDistributedLoad> distrLoads;
+    std::vector<TElementEndMoment> endMoments;
+
+    if (isBinaryModel(FileName)) {
+        importBinary(FileName, &structure, nodalLoads, distrLoads, endMoments);
+    } else {
+        std::ifstream input(FileName);
+        if (!input) {
+            Result.fMessage = "cannot read the file";
+            return;
+        }
+        importData(input, &structure, nodalLoads, distrLoads, endMoments);
+    }
+
+    std::vector<TPZFMatrix<double>> internalLoads;
+    structure.solve(nodalLoads, distrLoads, endMoments, internalLoads);
+
+    if (!ResultsName.empty()) {
+        exportResults(ResultsName, &structure);
+    }
+
+    std::ostringstream summary;
+    printResultsSummary(summary, &structure);
+
+    Result.fSolved = true;
+    Result.fNNodes = (int)structure.getNodeEquations().Rows();
+    Result.fNElements = (int)internalLoads.size();
+    Result.fSummary = summary.str();
+    Result.fProfile = structure.getProfile();
+    Result.fSeconds = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+//! Finds the model files of a batch.
+std::vector<std::string> findModelFiles(const std::string& Source)
+{
+    std::vector<std::string> fileNames;
+    std::error_code error;
+    fs::path source(Source);
+
+    if (fs::is_directory(source, error)) {
+        for (const fs::directory_entry& entry : fs::directory_iterator(source, error)) {
+            if (entry.is_regular_file(error) && isModelFile(entry.path())) {
+                fileNames.push_back(entry.path().string());
+            }
+        }
+        std::sort(fileNames.begin(), fileNames.end());
+    } else if (Source.find_first_of("*?") != std::string::npos) {
+        // Only the file name part may have wildcards.
+        fs::path directory = source.parent_path();
+        std::string pattern = source.filename().string();
+        if (directory.empty()) directory = ".";
+        for (const fs::directory_entry& entry : fs::directory_iterator(directory, error)) {
+            if (entry.is_regular_file(error) &&
+                matchesPattern(entry.path().filename().string(), pattern)) {
+                fileNames.push_back(entry.path().string());
+            }
+        }
+        std::sort(fileNames.begin(), fileNames.end());
+    } else {
+        std::ifstream manifest(Source);
+        std::string line;
+        while (std::getline(manifest, line)) {
+            size_t first = line.find_first_not_of(" \t\r");
+            size_t last = line.find_last_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') continue;
+            fs::path path(line.substr(first, last - first + 1));
+            if (path.is_relative()) path = source.parent_path() / path;
+            fileNames.push_back(path.string());
+        }
+    }
+
+    return fileNames;
+}
+
+//! Solves many independent models on a pool of threads.
+void solveBatch(const std::vector<std::string>& FileNames,
+                const std::string& OutputDirectory, int NThreads,
+                std::vector<TBatchResult>& Results)
+{
+    int nModels = FileNames.size();
+    Results.assign(nModels, TBatchResult());
+    if (!OutputDirectory.empty()) {
+        std::error_code error;
+        fs::create_directories(OutputDirectory, error);
+    }
+
+    // Parallelism is over the models; nesting threads inside each model
+    // would only oversubscribe the cores.
+    int nWorkers = getNumberOfThreads(NThreads);
+    int modelThreads = (nWorkers > 1) ? 1 : NThreads;
+
+    // A failure (DebugStop throws) is reported for its model only.
+    std::vector<std::string> resultsNames = getResultsNames(FileNames, OutputDirectory);
+    parallelForEach(0, nModels, nWorkers, [&](int i) {
+        try {
+            solveModel(FileNames[i], resultsNames[i], modelThreads, Results[i]);
+        } catch (const std::exception& error) {
+            Results[i].fSolved = false;
+            Results[i].fMessage = std::string("cannot solve the model (") +
+                                  error.what() + ")";
+        } catch (...) {
+            Results[i].fSolved = false;
+            Results[i].fMessage = "cannot solve the model";
+        }
+    });
+}
@@ -0,0 +1,71 @@
+/** \file Batch.h
+* Contains the declaration of functions that find many model files and solve
+* them on a pool of threads.
+*/
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <string>
+#include <vector>
+#include "TSolveProfile.h"
+
+//! The outcome of solving one model of a batch.
+struct TBatchResult {
+    // fFileName - path of the model file.
+    std::string fFileName;
+    // fSolved - whether the model was read and solved.
+    bool fSolved = false;
+    // fMessage - reason why the model was not solved.
+    std::string fMessage;
+    // fResultsName - path of the binary results file, empty if none.
+    std::string fResultsName;
+    // fNNodes, fNElements - size of the model.
+    int fNNodes = 0;
+    int fNElements = 0;
+    // fSeconds - time spent reading, solving and writing the model.
+    double fSeconds = 0.;
+    // fSummary - text summary of the results (see printResultsSummary()).
+    std::string fSummary;
+    // fProfile - cost of each phase of the solve (see TStructure::getProfile()).
+    TSolveProfile fProfile;
+};
+
+//! Finds the model files of a batch.
+/*!
+The source can be:
+- a directory, whose JSON (.json) and binary (.jsb) models are taken;
+- a glob, with '*' and '?' wildcards in its file name part (e.g.
+  "models/frame_*.json");
+- a manifest file, with one model path per line. Empty lines and lines
+  starting with '#' are skipped, and relative paths are taken from the
+  directory of the manifest.
+\param Source the directory, glob or manifest.
+\return the paths of the model files, sorted for directories and globs and
+in the manifest order otherwise.
+*/
+std::vector<std::string> findModelFiles(const std::string& Source);
+
+//! Solves many independent models on a pool of threads.
+/*!
+Each model is read (from JSON or binary, see isBinaryModel()) into its own
+TStructure object and solved. The models are handed out to the threads one
+at a time, so large and small models are balanced. When more than one thread
+is used, each model is solved with a single thread. A model that cannot be
+read or solved (e.g. a DebugStop on a malformed or unstable model) is
+reported in its result and the others are still solved.
+\param FileNames the paths of the model files.
+\param OutputDirectory the directory where the binary results of each model
+are written (see exportResults()), created if needed. Empty to write no
+results file. The results of a model are named "<model name>.jsr" when no
+other model of the batch has the same name, "<model name>.<extension>.jsr"
+when the extension tells them apart, and "<position>_<file name>.jsr"
+otherwise, with the 1-based position of the model in FileNames.
+\param NThreads the number of threads (see getNumberOfThreads()).
+\param Results receives the outcome of each model, in the order of FileNames.
+*/
+void solveBatch(const std::vector<std::string>& FileNames,
+                const std::string& OutputDirectory, int NThreads,
+                std::vector<TBatchResult>& Results);
+
+#endif // BATCH_H
@@ -0,0 +1,437 @@
+/** \file BinaryIntegration.cpp
+* Contains the definition of functions that write the structure and loads
+* objects into a binary model file and read them back.
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#ifdef _WIN32
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "BinaryIntegration.h"
+
+namespace {
+
+//! The sections of a binary model file, in file order.
+enum ESection {
+    ENodes,
+    EMaterials,
+    ESupports,
+    EElements,
+    ENodalLoads,
+    EDistributedLoads,
+    EEndMoments,
+    ESubstructures,
+    ENSections
+};
+
+//! The header of a binary model file.
+struct TBinaryHeader {
+    char fMagic[8];
+    uint32_t fVersion;
+    uint32_t fByteOrder;
+    uint64_t fCount[ENSections];
+    uint64_t fOffset[ENSections];
+};
+
+//! The records of each section.
+struct TNodeRecord {
+    double fX, fY;
+};
+struct TMaterialRecord {
+    double fE, fA, fI;
+};
+struct TSupportRecord {
+    int32_t fNode;
+    // Bits 0, 1 and 2 restrict Fx, Fy and M.
+    int32_t fConditions;
+};
+struct TElementRecord {
+    int32_t fNode0, fNode1, fMaterial;
+    // Bits 0 and 1 mark hinges at nodes 0 and 1.
+    int32_t fHinges;
+};
+struct TNodalLoadRecord {
+    int32_t fNode, fPadding;
+    double fFx, fFy, fM;
+};
+struct TDistributedLoadRecord {
+    int32_t fElement, fLoadPlane;
+    double fNode0Load, fNode1Load;
+};
+struct TEndMomentRecord {
+    int32_t fElement, fNode;
+    double fM;
+};
+struct TSubstructureRecord {
+    int32_t fElement, fSubstructure;
+};
+
+const char kMagic[8] = {'J', 'S', 'T', 'A', 'T', 'B', 'I', 'N'};
+const uint32_t kByteOrderMark = 0x01020304;
+const uint64_t kAlignment = 64;
+
+//! The size of the record of each section.
+const uint64_t kRecordSize[ENSections] = {
+    sizeof(TNodeRecord),        sizeof(TMaterialRecord),
+    sizeof(TSupportRecord),     sizeof(TElementRecord),
+    sizeof(TNodalLoadRecord),   sizeof(TDistributedLoadRecord),
+    sizeof(TEndMomentRecord),   sizeof(TSubstructureRecord)};
+
+//! A read-only view of the contents of a file, memory-mapped when possible.
+class TMappedFile
+{
+public:
+    //! Default constructor.
+    /*!
+    \param FileName the path of the file to be mapped.
+    */
+    TMappedFile(const std::string& FileName) : fData(nullptr), fSize(0)
+    {
+#ifdef _WIN32
+        std::ifstream input(FileName, std::ios::binary | std::ios::ate);
+        if (!input) return;
+        fSize = (uint64_t)input.tellg();
+        fBuffer.resize((fSize + 7) / 8);
+        input.seekg(0);
+        input.read((char*)fBuffer.data(), fSize);
+        fData = (const char*)fBuffer.data();
+#else
+        int file = open(FileName.c_str(), O_RDONLY);
+        if (file < 0) return;
+        struct stat status;
+        if (fstat(file, &status) == 0 && status.st_size > 0) {
+            void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE,
+                              file, 0);
+            if (data != MAP_FAILED) {
+                fData = (const char*)data;
+                fSize = (uint64_t)status.st_size;
+            }
+        }
+        close(file);
+#endif
+    }
+
+    //! Destructor.
+    ~TMappedFile()
+    {
+#ifndef _WIN32
+        if (fData != nullptr) munmap((void*)fData, fSize);
+#endif
+    }
+
+    TMappedFile(const TMappedFile&) = delete;
+    TMappedFile& operator=(const TMappedFile&) = delete;
+
+    //! Gets the contents of the file, or nullptr if it could not be read.
+    const char* data() const
+    {
+        return fData;
+    }
+
+    //! Gets the size of the file.
+    uint64_t size() const
+    {
+        return fSize;
+    }
+
+private:
+    //! The first byte of the file contents.
+    const char* fData;
+    //! The size of the file.
+    uint64_t fSize;
+#ifdef _WIN32
+    //! The file contents, 8-byte aligned.
+    std::vector<uint64_t> fBuffer;
+#endif
+};
+
+//! Checks the header of a binary model and the bounds of its sections.
+bool isValidHeader(const char* Data, uint64_t Size)
+{
+    if (Data == nullptr || Size < sizeof(TBinaryHeader)) return false;
+    const TBinaryHeader* header = (const TBinaryHeader*)Data;
+    if (std::memcmp(header->fMagic, kMagic, sizeof(kMagic)) != 0) return false;
+    if (header->fVersion != kBinaryModelVersion) return false;
+    if (header->fByteOrder != kByteOrderMark) return false;
+    for (int s = 0; s < ENSections; s++) {
+        if (header->fOffset[s] % kAlignment != 0) return false;
+        if (header->fCount[s] > Size / kRecordSize[s]) return false;
+        if (header->fOffset[s] + header->fCount[s] * kRecordSize[s] > Size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Gets the records of a section of a binary model.
+template <class TRecord>
+const TRecord* getRecords(const char* Data, ESection Section)
+{
+    const TBinaryHeader* header = (const TBinaryHeader*)Data;
+    return (const TRecord*)(Data + header->fOffset[Section]);
+}
+
+} // namespace
+
+//! Writes the structure and loads objects into a binary model file.
+void exportBinary(const std::string& FileName, TStructure* Structure,
+                  const std::vector<TNodalLoad>& NodalLoads,
+                  const std::vector<TDistributedLoad>& DistributedLoads,
+                  const std::vector<TElementEndMoment>& EndMoments)
+{
+    std::vector<TNode> nodes = Structure->getNodes();
+    std::vector<TMaterial> materials = Structure->getMaterials();
+    std::vector<TSupport> supports = Structure->getSupports();
+    std::vector<TElement> elements = Structure->getElements();
+    const std::vector<std::vector<int>>& substructures =
+        Structure->getSubstructures();
+    uint64_t nSubstructureElements = 0;
+    for (const std::vector<int>& substructure : substructures) {
+        nSubstructureElements += substructure.size();
+    }
+
+    TBinaryHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.fMagic, kMagic, sizeof(kMagic));
+    header.fVersion = kBinaryModelVersion;
+    header.fByteOrder = kByteOrderMark;
+    header.fCount[ENodes] = nodes.size();
+    header.fCount[EMaterials] = materials.size();
+    header.fCount[ESupports] = supports.size();
+    header.fCount[EElements] = elements.size();
+    header.fCount[ENodalLoads] = NodalLoads.size();
+    header.fCount[EDistributedLoads] = DistributedLoads.size();
+    header.fCount[EEndMoments] = EndMoments.size();
+    header.fCount[ESubstructures] = nSubstructureElements;
+    uint64_t offset = sizeof(TBinaryHeader);
+    for (int s = 0; s < ENSections; s++) {
+        offset = (offset + kAlignment - 1) / kAlignment * kAlignment;
+        header.fOffset[s] = offset;
+        offset += header.fCount[s] * kRecordSize[s];
+    }
+
+    std::ofstream output(FileName, std::ios::binary);
+    if (!output) {
+        // Stops debug if the file cannot be created.
+        DebugStop();
+    }
+    output.write((const char*)&header, sizeof(header));
+
+    uint64_t written = sizeof(TBinaryHeader);
+    auto writeSection = [&](ESection Section, const void* Records) {
+        static const char padding[kAlignment] = {};
+        output.write(padding, header.fOffset[Section] - written);
+        uint64_t size = header.fCount[Section] * kRecordSize[Section];
+        output.write((const char*)Records, size);
+        written = header.fOffset[Section] + size;
+    };
+
+    std::vector<TNodeRecord> nodeRecords(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        nodeRecords[i] = {nodes[i].getX(), nodes[i].getY()};
+    }
+    writeSection(ENodes, nodeRecords.data());
+
+    std::vector<TMaterialRecord> materialRecords(materials.size());
+    for (size_t i = 0; i < materials.size(); i++) {
+        materialRecords[i] = {materials[i].getE(), materials[i].getA(),
+                              materials[i].getI()};
+    }
+    writeSection(EMaterials, materialRecords.data());
+
+    std::vector<TSupportRecord> supportRecords(supports.size());
+    for (size_t i = 0; i < supports.size(); i++) {
+        int conditions = (supports[i].RestrictsFx() ? 1 : 0) |
+                         (supports[i].RestrictsFy() ? 2 : 0) |
+                         (supports[i].RestrictsM() ? 4 : 0);
+        supportRecords[i] = {supports[i].getNodeID(), conditions};
+    }
+    writeSection(ESupports, supportRecords.data());
+
+    std::vector<TElementRecord> elementRecords(elements.size());
+    for (size_t i = 0; i < elements.size(); i++) {
+        int hinges = (elements[i].getHinge0() ? 1 : 0) |
+                     (elements[i].getHinge1() ? 2 : 0);
+        elementRecords[i] = {elements[i].getNode0ID(), elements[i].getNode1ID(),
+                             elements[i].getMaterialID(), hinges};
+    }
+    writeSection(EElements, elementRecords.data());
+
+    std::vector<TNodalLoadRecord> nodalRecords(NodalLoads.size());
+    for (size_t i = 0; i < NodalLoads.size(); i++) {
+        nodalRecords[i] = {NodalLoads[i].getNodeID(), 0, NodalLoads[i].getFx(),
+                           NodalLoads[i].getFy(), NodalLoads[i].getM()};
+    }
+    writeSection(ENodalLoads, nodalRecords.data());
+
+    std::vector<TDistributedLoadRecord> distributedRecords(DistributedLoads.size());
+    for (size_t i = 0; i < DistributedLoads.size(); i++) {
+        distributedRecords[i] = {DistributedLoads[i].getElementID(),
+                                 DistributedLoads[i].getLoadPlane() ? 1 : 0,
+                                 DistributedLoads[i].getNode0Load(),
+                                 DistributedLoads[i].getNode1Load()};
+    }
+    writeSection(EDistributedLoads, distributedRecords.data());
+
+    std::vector<TEndMomentRecord> momentRecords(EndMoments.size());
+    for (size_t i = 0; i < EndMoments.size(); i++) {
+        momentRecords[i] = {EndMoments[i].getElementID(), EndMoments[i].getNode(),
+                            EndMoments[i].getM()};
+    }
+    writeSection(EEndMoments, momentRecords.data());
+
+    std::vector<TSubstructureRecord> substructureRecords;
+    substructureRecords.reserve(nSubstructureElements);
+    for (size_t i = 0; i < substructures.size(); i++) {
+        for (int id : substructures[i]) {
+            substructureRecords.push_back({id, (int32_t)i});
+        }
+    }
+    writeSection(ESubstructures, substructureRecords.data());
+
+    if (!output) {
+        // Stops debug if the file could not be written.
+        DebugStop();
+    }
+}
+
+//! Reads a binary model file into structure and loads objects.
+void importBinary(const std::string& FileName, TStructure* Parent,
+                  std::vector<TNodalLoad>& NodalLoads,
+                  std::vector<TDistributedLoad>& DistributedLoads,
+                  std::vector<TElementEndMoment>& EndMoments)
+{
+    TMappedFile file(FileName);
+    if (!isValidHeader(file.data(), file.size())) {
+        // Stops debug if the file is not a binary model of this version.
+        DebugStop();
+    }
+    const char* data = file.data();
+    const TBinaryHeader* header = (const TBinaryHeader*)data;
+
+    int nNodes = (int)header->fCount[ENodes];
+    const TNodeRecord* nodeRecords = getRecords<TNodeRecord>(data, ENodes);
+    std::vector<TNode> nodes;
+    nodes.reserve(nNodes);
+    for (int i = 0; i < nNodes; i++) {
+        nodes.emplace_back(nodeRecords[i].fX, nodeRecords[i].fY);
+    }
+    Parent->setNodes(nodes);
+    std::vector<TNode>().swap(nodes);
+
+    int nMaterials = (int)header->fCount[EMaterials];
+    const TMaterialRecord* materialRecords =
+        getRecords<TMaterialRecord>(data, EMaterials);
+    std::vector<TMaterial> materials(nMaterials);
+    for (int i = 0; i < nMaterials; i++) {
+        materials[i].setE(materialRecords[i].fE);
+        materials[i].setA(materialRecords[i].fA);
+        materials[i].setI(materialRecords[i].fI);
+    }
+    Parent->setMaterials(materials);
+
+    int nSupports = (int)header->fCount[ESupports];
+    const TSupportRecord* supportRecords =
+        getRecords<TSupportRecord>(data, ESupports);
+    std::vector<TSupport> supports(nSupports);
+    for (int i = 0; i < nSupports; i++) {
+        supports[i].setStructure(Parent);
+        supports[i].setNodeID(supportRecords[i].fNode);
+        supports[i].setFx((supportRecords[i].fConditions & 1) != 0);
+        supports[i].setFy((supportRecords[i].fConditions & 2) != 0);
+        supports[i].setM((supportRecords[i].fConditions & 4) != 0);
+    }
+    Parent->setSupports(supports);
+
+    int nElements = (int)header->fCount[EElements];
+    const TElementRecord* elementRecords =
+        getRecords<TElementRecord>(data, EElements);
+    std::vector<TElement> elements(nElements);
+    for (int i = 0; i < nElements; i++) {
+        elements[i].setStructure(Parent);
+        elements[i].setNode0ID(elementRecords[i].fNode0);
+        elements[i].setNode1ID(elementRecords[i].fNode1);
+        elements[i].setMaterialID(elementRecords[i].fMaterial);
+        elements[i].setHinge0((elementRecords[i].fHinges & 1) != 0);
+        elements[i].setHinge1((elementRecords[i].fHinges & 2) != 0);
+    }
+    Parent->setElements(elements);
+    std::vector<TElement>().swap(elements);
+    // Also clears the substructures of a previously loaded model.
+    int nSubstructureElements = (int)header->fCount[ESubstructures];
+    const TSubstructureRecord* substructureRecords =
+        getRecords<TSubstructureRecord>(data, ESubstructures);
+    std::vector<std::vector<int>> substructures;
+    std::vector<bool> checker(nElements, false);
+    for (int i = 0; i < nSubstructureElements; i++) {
+        int id = substructureRecords[i].fElement;
+        int substructure = substructureRecords[i].fSubstructure;
+        // Stops debug if an element does not exist or is in two
+        // substructures, or if the records are not grouped by substructure.
+        if (id < 0 || id >= nElements || checker[id]) DebugStop();
+        if (substructure != (int)substructures.size() - 1) {
+            if (substructure != (int)substructures.size()) DebugStop();
+            substructures.emplace_back();
+        }
+        checker[id] = true;
+        substructures.back().push_back(id);
+    }
+    Parent->setSubstructures(substructures);
+
+    int nNodalLoads = (int)header->fCount[ENodalLoads];
+    const TNodalLoadRecord* nodalRecords =
+        getRecords<TNodalLoadRecord>(data, ENodalLoads);
+    NodalLoads.reserve(NodalLoads.size() + nNodalLoads);
+    for (int i = 0; i < nNodalLoads; i++) {
+        TNodalLoad load;
+        load.setStructure(Parent);
+        load.setNodeID(nodalRecords[i].fNode);
+        load.setFx(nodalRecords[i].fFx);
+        load.setFy(nodalRecords[i].fFy);
+        load.setM(nodalRecords[i].fM);
+        NodalLoads.push_back(load);
+    }
+
+    int nDistributedLoads = (int)header->fCount[EDistributedLoads];
+    const TDistributedLoadRecord* distributedRecords =
+        getRecords<TDistributedLoadRecord>(data, EDistributedLoads);
+    DistributedLoads.reserve(DistributedLoads.size() + nDistributedLoads);
+    for (int i = 0; i < nDistributedLoads; i++) {
+        TDistributedLoad load;
+        load.setStructure(Parent);
+        load.setElementID(distributedRecords[i].fElement);
+        load.setNode0Load(distributedRecords[i].fNode0Load);
+        load.setNode1Load(distributedRecords[i].fNode1Load);
+        load.setLoadPlane(distributedRecords[i].fLoadPlane != 0);
+        DistributedLoads.push_back(load);
+    }
+
+    int nEndMoments = (int)header->fCount[EEndMoments];
+    const TEndMomentRecord* momentRecords =
+        getRecords<TEndMomentRecord>(data, EEndMoments);
+    EndMoments.reserve(EndMoments.size() + nEndMoments);
+    for (int i = 0; i < nEndMoments; i++) {
+        TElementEndMoment load;
+        load.setStructure(Parent);
+        load.setElementID(momentRecords[i].fElement);
+        load.setNode(momentRecords[i].fNode);
+        load.setM(momentRecords[i].fM);
+        EndMoments.push_back(load);
+    }
+}
+
+//! Checks if a file starts with the header of a binary model.
+bool isBinaryModel(const std::string& FileName)
+{
+    std::ifstream input(FileName, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    input.read(magic, sizeof(magic));
+    return input && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
@@ -0,0 +1,61 @@
+/** \file BinaryIntegration.h
+* Contains the declaration of functions that write the structure and loads
+* objects into a binary model file and read them back.
+*/
+
+#ifndef BINARYINTEGRATION_H
+#define BINARYINTEGRATION_H
+
+#include <string>
+#include <vector>
+#include "TStructure.h"
+#include "TNodalLoad.h"
+#include "TDistributedLoad.h"
+#include "TElementEndMoment.h"
+
+//! The version of the binary model format written by exportBinary.
+const unsigned kBinaryModelVersion = 2;
+
+//! Writes the structure and loads objects into a binary model file.
+/*!
+The file starts with a 144-byte header: the magic "JSTATBIN", the format
+version, a byte order mark and, for each section (nodes, materials,
+supports, elements, nodal loads, distributed loads, element end moments and
+substructures), the number of records and the offset of its first one. The
+substructures section holds one (element, substructure) pair per element,
+grouped by substructure. Each section is a
+flat array of fixed-size records, aligned to 64 bytes, in native byte order.
+\param FileName the path of the file to be written.
+\param Structure the pointer to the TStructure object to be written.
+\param NodalLoads the nodal loads to be written.
+\param DistributedLoads the distributed loads to be written.
+\param EndMoments the element end moments to be written.
+*/
+void exportBinary(const std::string& FileName, TStructure* Structure,
+                  const std::vector<TNodalLoad>& NodalLoads,
+                  const std::vector<TDistributedLoad>& DistributedLoads,
+                  const std::vector<TElementEndMoment>& EndMoments);
+
+//! Reads a binary model file into structure and loads objects.
+/*!
+The file is memory-mapped and the objects are built directly from its
+record arrays, with no text parsing.
+\param FileName the path of the file to be read.
+\param Parent the pointer to the TStructure object to be filled.
+\param NodalLoads the address of the TNodalLoad vector to be filled.
+\param DistributedLoads the address of the TDistributedLoad vector to be filled.
+\param EndMoments the address of the TElementEndMoment vector to be filled.
+*/
+void importBinary(const std::string& FileName, TStructure* Parent,
+                  std::vector<TNodalLoad>& NodalLoads,
+                  std::vector<TDistributedLoad>& DistributedLoads,
+                  std::vector<TElementEndMoment>& EndMoments);
+
+//! Checks if a file starts with the header of a binary model.
+/*!
+\param FileName the path of the file.
+\return true if the file is a binary model file.
+*/
+bool isBinaryModel(const std::string& FileName);
+
+#endif // BINARYINTEGRATION_H
@@ -0,0 +1,140 @@
+/** \file ElementKernels.cpp
+* Contains the definition of functions that compute element quantities for
+* many elements at once.
+*/
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+#include "ElementKernels.h"
+
+namespace {
+
+//! Operations on a single double, used for the remaining elements.
+struct TScalarLane {
+    typedef double Type;
+    static const int kWidth = 1;
+    static Type load(const double* p) { return *p; }
+    static void store(double* p, Type v) { *p = v; }
+    static Type set(double x) { return x; }
+    static Type add(Type a, Type b) { return a + b; }
+    static Type sub(Type a, Type b) { return a - b; }
+    static Type mul(Type a, Type b) { return a * b; }
+    static Type div(Type a, Type b) { return a / b; }
+};
+
+#ifdef __AVX2__
+//! Operations on 4 doubles of an AVX2 register.
+struct TAVX2Lane {
+    typedef __m256d Type;
+    static const int kWidth = 4;
+    static Type load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, Type v) { _mm256_storeu_pd(p, v); }
+    static Type set(double x) { return _mm256_set1_pd(x); }
+    static Type add(Type a, Type b) { return _mm256_add_pd(a, b); }
+    static Type sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+    static Type mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+    static Type div(Type a, Type b) { return _mm256_div_pd(a, b); }
+};
+#endif
+
+#ifdef __AVX512F__
+//! Operations on 8 doubles of an AVX-512 register.
+struct TAVX512Lane {
+    typedef __m512d Type;
+    static const int kWidth = 8;
+    static Type load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, Type v) { _mm512_storeu_pd(p, v); }
+    static Type set(double x) { return _mm512_set1_pd(x); }
+    static Type add(Type a, Type b) { return _mm512_add_pd(a, b); }
+    static Type sub(Type a, Type b) { return _mm512_sub_pd(a, b); }
+    static Type mul(Type a, Type b) { return _mm512_mul_pd(a, b); }
+    static Type div(Type a, Type b) { return _mm512_div_pd(a, b); }
+};
+#endif
+
+//! Computes the stiffness of the elements [First, NElements), Lane::kWidth at a time.
+/*!
+\return the first element that was not computed (less than Lane::kWidth remain).
+*/
+template <class Lane>
+int computeElementsK(int First, int NElements, const double* L,
+                     const double* Cos, const double* Sin, const double* E,
+                     const double* A, const double* I, double* K)
+{
+    typedef typename Lane::Type V;
+    const V zero = Lane::set(0.);
+    const V one = Lane::set(1.);
+    const V two = Lane::set(2.);
+    const V four = Lane::set(4.);
+    const V six = Lane::set(6.);
+    const V twelve = Lane::set(12.);
+
+    int e = First;
+    for (; e + Lane::kWidth <= NElements; e += Lane::kWidth) {
+        V lx = Lane::load(Cos + e);
+        V ly = Lane::load(Sin + e);
+        V EE = Lane::load(E + e);
+
+        // Stiffness terms shared by several entries of K.
+        V invL = Lane::div(one, Lane::load(L + e));
+        V invL2 = Lane::mul(invL, invL);
+        V invL3 = Lane::mul(invL2, invL);
+        V EI = Lane::mul(EE, Lane::load(I + e));
+        V EA_L = Lane::mul(Lane::mul(EE, Lane::load(A + e)), invL);
+        V EI_L = Lane::mul(EI, invL);
+        V EI_L2 = Lane::mul(EI, invL2);
+        V EI_L3_12 = Lane::mul(twelve, Lane::mul(EI, invL3));
+        V kxx = Lane::add(Lane::mul(EA_L, Lane::mul(lx, lx)),
+                          Lane::mul(EI_L3_12, Lane::mul(ly, ly)));
+        V kyy = Lane::add(Lane::mul(EA_L, Lane::mul(ly, ly)),
+                          Lane::mul(EI_L3_12, Lane::mul(lx, lx)));
+        V kxy = Lane::mul(Lane::sub(EA_L, EI_L3_12), Lane::mul(lx, ly));
+        V kxm = Lane::mul(Lane::mul(six, EI_L2), ly);
+        V kym = Lane::mul(Lane::mul(six, EI_L2), lx);
+        V kmm = Lane::mul(four, EI_L);
+        V kmm2 = Lane::mul(two, EI_L);
+
+        // Upper triangle of K, by rows.
+        V entries[kElementKEntries] = {
+            kxx, kxy, Lane::sub(zero, kxm), Lane::sub(zero, kxx),
+            Lane::sub(zero, kxy), Lane::sub(zero, kxm),
+            kyy, kym, Lane::sub(zero, kxy), Lane::sub(zero, kyy), kym,
+            kmm, kxm, Lane::sub(zero, kym), kmm2,
+            kxx, kxy, kxm,
+            kyy, Lane::sub(zero, kym),
+            kmm};
+        for (int k = 0; k < kElementKEntries; k++) {
+            Lane::store(K + (long long)k * NElements + e, entries[k]);
+        }
+    }
+    return e;
+}
+
+} // namespace
+
+//! Computes the global stiffness matrices of many frame elements at once.
+void computeElementsK(int NElements, const double* L, const double* Cos,
+                      const double* Sin, const double* E, const double* A,
+                      const double* I, double* K)
+{
+    int e = 0;
+#if defined(__AVX512F__)
+    e = computeElementsK<TAVX512Lane>(e, NElements, L, Cos, Sin, E, A, I, K);
+#elif defined(__AVX2__)
+    e = computeElementsK<TAVX2Lane>(e, NElements, L, Cos, Sin, E, A, I, K);
+#endif
+    computeElementsK<TScalarLane>(e, NElements, L, Cos, Sin, E, A, I, K);
+}
+
+//! Gets the instruction set used by computeElementsK.
+const char* getElementKernelISA()
+{
+#if defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(__AVX2__)
+    return "AVX2";
+#else
+    return "scalar";
+#endif
+}
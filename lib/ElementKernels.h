@@ -0,0 +1,107 @@
+/** \file ElementKernels.h
+* Contains the declaration of functions that compute element quantities for
+* many elements at once.
+*/
+
+#ifndef ELEMENTKERNELS_H
+#define ELEMENTKERNELS_H
+
+#include "TFixedMatrix.h"
+
+//! The number of unique entries of the symmetric 6x6 element stiffness matrix.
+const int kElementKEntries = 21;
+
+//! Computes the global stiffness matrices of many frame elements at once.
+/*!
+The input data is given as one contiguous array per quantity (structure of
+arrays). The elements are processed 8 (AVX-512) or 4 (AVX2) at a time when
+the library is built for those instruction sets, and one at a time
+otherwise and for the remaining elements.
+\param NElements the number of elements.
+\param L the length of each element.
+\param Cos the cosine of the angle of each element.
+\param Sin the sine of the angle of each element.
+\param E the elasticity modulus of the material of each element.
+\param A the cross section area of each element.
+\param I the moment of inertia of each element.
+\param K the array that receives the kElementKEntries entries of the upper
+triangle of each matrix, by rows. Entry k of element e is stored at
+K[k * NElements + e].
+*/
+void computeElementsK(int NElements, const double* L, const double* Cos,
+                      const double* Sin, const double* E, const double* A,
+                      const double* I, double* K);
+
+//! Builds a symmetric element matrix from the entries of its upper triangle.
+/*!
+\param Upper the kElementKEntries entries of the upper triangle, by rows.
+\param Stride the distance between two consecutive entries in Upper.
+\return the symmetric element matrix.
+*/
+inline TElementMatrix unpackElementK(const double* Upper, int Stride)
+{
+    TElementMatrix K;
+    int k = 0;
+    for (int a = 0; a < 6; a++) {
+        for (int b = a; b < 6; b++) {
+            K(a, b) = Upper[k * Stride];
+            K(b, a) = Upper[k * Stride];
+            k++;
+        }
+    }
+    return K;
+}
+
+//! Stores the upper triangle of a symmetric element matrix.
+/*!
+\param K the symmetric element matrix.
+\param Upper receives the kElementKEntries entries of the upper triangle, by rows.
+\param Stride the distance between two consecutive entries in Upper.
+*/
+inline void packElementK(const TElementMatrix& K, double* Upper, int Stride)
+{
+    int k = 0;
+    for (int a = 0; a < 6; a++) {
+        for (int b = a; b < 6; b++) {
+            Upper[k * Stride] = K(a, b);
+            k++;
+        }
+    }
+}
+
+//! Statically condenses one DOF out of an element matrix and load vector.
+/*!
+The DOF is eliminated assuming no load acts on it other than Q, as for the
+rotation of a hinged end. Its row and column of K become zero.
+\param K the symmetric element matrix.
+\param DOF the local DOF to be condensed (0 to 5).
+\param Q the element load vector condensed with K (six entries), or nullptr.
+Its entry DOF becomes zero.
+*/
+inline void condenseElementDOF(TElementMatrix& K, int DOF, double* Q = nullptr)
+{
+    double pivot = K(DOF, DOF);
+    if (Q != nullptr) {
+        for (int a = 0; a < 6; a++) {
+            if (a != DOF) Q[a] -= K(a, DOF) / pivot * Q[DOF];
+        }
+        Q[DOF] = 0.;
+    }
+    for (int a = 0; a < 6; a++) {
+        for (int b = 0; b < 6; b++) {
+            if (a != DOF && b != DOF) K(a, b) -= K(a, DOF) * K(DOF, b) / pivot;
+        }
+    }
+    for (int a = 0; a < 6; a++) {
+        K(a, DOF) = 0.;
+        K(DOF, a) = 0.;
+    }
+}
+
+//! Gets the instruction set used by computeElementsK.
+/*!
+\return "AVX-512", "AVX2" or "scalar".
+*/
+const char* getElementKernelISA();
+
+#endif // ELEMENTKERNELS_H
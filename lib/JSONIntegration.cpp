@@ -12,52 +12,57 @@ void printJSON(const nlohmann::json& J)
     std::cout << std::flush;
 }
 
-//! Converts JSON into structure and loads objects.
-void importData(const nlohmann::json &J, TStructure *Parent,
-                std::vector<TNodalLoad> &NodalLoads,
-                std::vector<TDistributedLoad> &DistributedLoads,
-                std::vector<TElementEndMoment> &EndMoments)
+namespace {
+
+//! The objects read from a JSON model, before they are checked and stored.
+struct TModelData {
+    // Marks the sections that were present.
+    bool fHasNodes = false;
+    bool fHasMaterials = false;
+    bool fHasSupports = false;
+    bool fHasElements = false;
+    bool fHasNodalLoads = false;
+    bool fHasDistributedLoads = false;
+    bool fHasEndMoments = false;
+    bool fHasSubstructures = false;
+    // The objects of each section, in file order.
+    std::vector<TNode> fNodes;
+    std::vector<TMaterial> fMaterials;
+    std::vector<TSupport> fSupports;
+    std::vector<TElement> fElements;
+    std::vector<TNodalLoad> fNodalLoads;
+    std::vector<TDistributedLoad> fDistributedLoads;
+    std::vector<TElementEndMoment> fEndMoments;
+    std::vector<std::vector<int>> fSubstructures;
+};
+
+//! Checks the objects read from a JSON model and stores them.
+void storeModel(TModelData& Data, TStructure* Parent,
+                std::vector<TNodalLoad>& NodalLoads,
+                std::vector<TDistributedLoad>& DistributedLoads,
+                std::vector<TElementEndMoment>& EndMoments)
 {
-    // Reads the vector of TNode.
-    if (J.find("Nodes") != J.end()) {
-        std::vector<TNode> nodes;
-
-        for (int i = 0; i < (int)J["Nodes"].size(); i++) {
-            TNode node = J["Nodes"][i];
-            nodes.push_back(node);
-        }
-        Parent->setNodes(nodes);
-    }
-    else {
+    if (!Data.fHasNodes) {
         // Stops debug if no node has been assigned to the structure.
         DebugStop();
     }
+    Parent->setNodes(Data.fNodes);
+    std::vector<TNode>().swap(Data.fNodes);
 
-    // Reads the vector of TMaterial.
-    if (J.find("Materials") != J.end()) {
-        std::vector<TMaterial> materials;
-
-        for (int i = 0; i < (int)J["Materials"].size(); i++) {
-            TMaterial material = J["Materials"][i];
-            materials.push_back(material);
-        }
-        Parent->setMaterials(materials);
-    }
-    else {
+    if (!Data.fHasMaterials) {
         // Stops debug if no material has been assigned to the structure.
         DebugStop();
     }
+    Parent->setMaterials(Data.fMaterials);
 
-    // Reads the vector of TSupport.
-    if (J.find("Supports") != J.end()) {
+    if (Data.fHasSupports) {
         std::vector<TSupport> supports;
         std::vector<bool> checker(Parent->getNodes().size(), false);
 
-        for (int i = 0; i < (int)J["Supports"].size(); i++) {
+        for (TSupport& support : Data.fSupports) {
             // Ensures that a node has up to one TSupport object.
-            if (checker[J["Supports"][i]["Node"].get<int>()] == false) {
-                checker[J["Supports"][i]["Node"].get<int>()] = true;
-                TSupport support = J["Supports"][i];
+            if (checker[support.getNodeID()] == false) {
+                checker[support.getNodeID()] = true;
                 support.setStructure(Parent);
                 supports.push_back(support);
             }
@@ -69,33 +74,45 @@ void importData(const nlohmann::json &J, TStructure *Parent,
         DebugStop();
     }
 
-    // Reads the vector of TElements.
-    if (J.find("Elements") != J.end()) {
-        std::vector<TElement> elements;
-
-        for (int i = 0; i < (int)J["Elements"].size(); i++) {
-            TElement element = J["Elements"][i];
+    if (Data.fHasElements) {
+        for (TElement& element : Data.fElements) {
             element.setStructure(Parent);
-            elements.push_back(element);
         }
-        Parent->setElements(elements);
+        Parent->setElements(Data.fElements);
+        std::vector<TElement>().swap(Data.fElements);
     }
     else {
         // Stops debug if no element has been assigned to the structure.
         DebugStop();
     }
 
+    if (Data.fHasSubstructures) {
+        int nElements = Parent->getElements().size();
+        std::vector<bool> checker(nElements, false);
+        for (const std::vector<int>& substructure : Data.fSubstructures) {
+            for (int id : substructure) {
+                // Stops debug if an element does not exist or is in two
+                // substructures.
+                if (id < 0 || id >= nElements || checker[id]) DebugStop();
+                checker[id] = true;
+            }
+            if (substructure.empty()) {
+                // Stops debug if a substructure has no element.
+                DebugStop();
+            }
+        }
+    }
+    // Also clears the substructures of a previously loaded model.
+    Parent->setSubstructures(Data.fSubstructures);
+
     bool structureHasLoad = false;
-    // Reads the vector of TNodalLoad.
-    if (J.find("Nodal Loads") != J.end()) {
+    if (Data.fHasNodalLoads) {
         std::vector<bool> checker(Parent->getNodes().size(), false);
 
-        for (int i = 0; i < (int)J["Nodal Loads"].size(); i++) {
+        for (TNodalLoad& newLoad : Data.fNodalLoads) {
             // Ensures that only one nodal load object is applied to a node.
-            if (checker[J["Nodal Loads"][i]["Node"].get<int>()] == false) {
-                checker[J["Nodal Loads"][i]["Node"].get<int>()] = true;
-
-                TNodalLoad newLoad = J["Nodal Loads"][i];
+            if (checker[newLoad.getNodeID()] == false) {
+                checker[newLoad.getNodeID()] = true;
                 newLoad.setStructure(Parent);
                 NodalLoads.push_back(newLoad);
             }
@@ -103,16 +120,13 @@ void importData(const nlohmann::json &J, TStructure *Parent,
         structureHasLoad = true;
     }
 
-    // Reads the vector of TDistributedLoad.
-    if (J.find("Distributed Loads") != J.end()) {
+    if (Data.fHasDistributedLoads) {
         std::vector<bool> checker(Parent->getElements().size(), false);
 
-        for (int i = 0; i < (int)J["Distributed Loads"].size(); i++) {
+        for (TDistributedLoad& newLoad : Data.fDistributedLoads) {
             // Ensures that only one distributed load is applied to an element.
-            if (checker[J["Distributed Loads"][i]["Element"].get<int>()]
-                == false) {
-                checker[J["Distributed Loads"][i]["Element"].get<int>()] = true;
-                TDistributedLoad newLoad = J["Distributed Loads"][i];
+            if (checker[newLoad.getElementID()] == false) {
+                checker[newLoad.getElementID()] = true;
                 newLoad.setStructure(Parent);
                 DistributedLoads.push_back(newLoad);
             }
@@ -120,31 +134,20 @@ void importData(const nlohmann::json &J, TStructure *Parent,
         structureHasLoad = true;
     }
 
-    // Reads the vector of TElementEndMoment.
-    if (J.find("Element End Moments") != J.end()) {
+    if (Data.fHasEndMoments) {
         std::vector<bool> node0Checker(Parent->getElements().size(), false);
         std::vector<bool> node1Checker(Parent->getElements().size(), false);
 
-        for (int i = 0; i < (int)J["Element End Moments"].size(); i++) {
-            // Ensures that only one end moment is applied to an element node 0.
-            if (J["Element End Moments"][i]["Node"].get<int>() == 0) {
-                if (node0Checker[J["Element End Moments"][i]["Element"]]
-                    == false) {
-                    node0Checker[J["Element End Moments"][i]["Element"]] = true;
-                    TElementEndMoment newLoad = J["Element End Moments"][i];
-                    newLoad.setStructure(Parent);
-                    EndMoments.push_back(newLoad);
-                }
-            }
-            // Ensures that only one end moment is applied to an element node 1.
-            if (J["Element End Moments"][i]["Node"].get<int>() == 1) {
-                if (node1Checker[J["Element End Moments"][i]["Element"]]
-                    == false) {
-                    node1Checker[J["Element End Moments"][i]["Element"]] = true;
-                    TElementEndMoment newLoad = J["Element End Moments"][i];
-                    newLoad.setStructure(Parent);
-                    EndMoments.push_back(newLoad);
-                }
+        for (TElementEndMoment& newLoad : Data.fEndMoments) {
+            // Ensures that only one end moment is applied to each element node.
+            std::vector<bool>* checker = nullptr;
+            if (newLoad.getNode() == 0) checker = &node0Checker;
+            if (newLoad.getNode() == 1) checker = &node1Checker;
+            if (checker == nullptr) continue;
+            if ((*checker)[newLoad.getElementID()] == false) {
+                (*checker)[newLoad.getElementID()] = true;
+                newLoad.setStructure(Parent);
+                EndMoments.push_back(newLoad);
             }
         }
         structureHasLoad = true;
@@ -156,6 +159,421 @@ void importData(const nlohmann::json &J, TStructure *Parent,
     }
 }
 
+//! A SAX handler that reads a JSON model into a TModelData object.
+/*!
+The values of each object of a section (a node, an element, a load...) are
+collected in a small reusable record, which is converted into the
+corresponding class object as soon as the object ends. Unknown sections and
+keys are skipped.
+*/
+class TModelReader : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+    //! Default constructor.
+    TModelReader(TModelData& Data)
+        : fData(Data), fDepth(0), fSection(ENone), fNFields(0) {}
+
+    // SAX events, called by the parser in file order.
+    bool null() override
+    {
+        return true;
+    }
+
+    bool boolean(bool Value) override
+    {
+        this->addValue(Value ? 1. : 0.);
+        return true;
+    }
+
+    bool number_integer(number_integer_t Value) override
+    {
+        this->addValue((double)Value);
+        return true;
+    }
+
+    bool number_unsigned(number_unsigned_t Value) override
+    {
+        this->addValue((double)Value);
+        return true;
+    }
+
+    bool number_float(number_float_t Value, const string_t&) override
+    {
+        this->addValue(Value);
+        return true;
+    }
+
+    bool string(string_t&) override
+    {
+        return true;
+    }
+
+    bool binary(binary_t&) override
+    {
+        return true;
+    }
+
+    bool start_object(std::size_t) override
+    {
+        return this->start();
+    }
+
+    bool key(string_t& Key) override
+    {
+        if (fDepth == 1) {
+            fSection = getSection(Key);
+        }
+        else if (fDepth == 3 && fSection != ENone) {
+            // Starts a new field of the record, reusing its storage.
+            if (fNFields == (int)fFields.size()) fFields.emplace_back();
+            fFields[fNFields].fKey = Key;
+            fFields[fNFields].fValues.clear();
+            fNFields++;
+        }
+        return true;
+    }
+
+    bool end_object() override
+    {
+        return this->end();
+    }
+
+    bool start_array(std::size_t) override
+    {
+        if (!this->start()) return false;
+        if (fDepth == 3 && fSection != ENone) {
+            // An object given as an array (a node) has a single unnamed field.
+            fFields[0].fKey.clear();
+            fFields[0].fValues.clear();
+            fNFields = 1;
+        }
+        return true;
+    }
+
+    bool end_array() override
+    {
+        return this->end();
+    }
+
+    bool parse_error(std::size_t, const std::string&,
+                     const nlohmann::detail::exception&) override
+    {
+        return false;
+    }
+
+private:
+    //! The sections of a model.
+    enum ESection {
+        ENone,
+        ENodes,
+        EMaterials,
+        ESupports,
+        EElements,
+        ENodalLoads,
+        EDistributedLoads,
+        EEndMoments,
+        ESubstructures
+    };
+
+    //! A field of the current record.
+    struct TField {
+        std::string fKey;
+        std::vector<double> fValues;
+    };
+
+    TModelData& fData;
+    //! The nesting depth: 1 inside the model, 2 inside a section, 3 inside
+    //! an object of a section, 4 inside an array of one of its fields.
+    int fDepth;
+    //! The current section.
+    ESection fSection;
+    //! The fields of the current record; only the first fNFields are used.
+    std::vector<TField> fFields;
+    int fNFields;
+
+    //! Gets the section of a key of the model.
+    static ESection getSection(const std::string& Key)
+    {
+        if (Key == "Nodes") return ENodes;
+        if (Key == "Materials") return EMaterials;
+        if (Key == "Supports") return ESupports;
+        if (Key == "Elements") return EElements;
+        if (Key == "Nodal Loads") return ENodalLoads;
+        if (Key == "Distributed Loads") return EDistributedLoads;
+        if (Key == "Element End Moments") return EEndMoments;
+        if (Key == "Substructures") return ESubstructures;
+        return ENone;
+    }
+
+    //! Enters an object or array.
+    bool start()
+    {
+        fDepth++;
+        if (fDepth == 2) {
+            // Marks the section as present.
+            switch (fSection) {
+            case ENodes: fData.fHasNodes = true; break;
+            case EMaterials: fData.fHasMaterials = true; break;
+            case ESupports: fData.fHasSupports = true; break;
+            case EElements: fData.fHasElements = true; break;
+            case ENodalLoads: fData.fHasNodalLoads = true; break;
+            case EDistributedLoads: fData.fHasDistributedLoads = true; break;
+            case EEndMoments: fData.fHasEndMoments = true; break;
+            case ESubstructures: fData.fHasSubstructures = true; break;
+            case ENone: break;
+            }
+        }
+        if (fDepth == 3) {
+            fNFields = 0;
+            if (fFields.empty()) fFields.emplace_back();
+        }
+        return true;
+    }
+
+    //! Leaves an object or array, storing the record of a finished object.
+    bool end()
+    {
+        if (fDepth == 3 && fSection != ENone) this->storeRecord();
+        if (fDepth == 2) fSection = ENone;
+        fDepth--;
+        return true;
+    }
+
+    //! Adds a value to the current field of the record.
+    void addValue(double Value)
+    {
+        if (fSection == ENone || fNFields == 0) return;
+        if (fDepth == 3 || fDepth == 4) {
+            fFields[fNFields - 1].fValues.push_back(Value);
+        }
+    }
+
+    //! Finds a field of the record.
+    const std::vector<double>* find(const char* Key) const
+    {
+        for (int f = 0; f < fNFields; f++) {
+            if (fFields[f].fKey == Key) return &fFields[f].fValues;
+        }
+        return nullptr;
+    }
+
+    //! Gets a value of a field of the record.
+    double get(const char* Key, int Index = 0) const
+    {
+        const std::vector<double>* values = this->find(Key);
+        if (values == nullptr || Index >= (int)values->size()) {
+            // Stops debug if a required value is missing.
+            DebugStop();
+        }
+        return (*values)[Index];
+    }
+
+    //! Gets a value of an optional field of the record.
+    double get(const char* Key, int Index, double Default) const
+    {
+        const std::vector<double>* values = this->find(Key);
+        if (values == nullptr || Index >= (int)values->size()) return Default;
+        return (*values)[Index];
+    }
+
+    //! Converts the record into an object of the current section.
+    void storeRecord()
+    {
+        switch (fSection) {
+        case ENodes: {
+            TNode node;
+            node.setX(this->get("", 0));
+            node.setY(this->get("", 1));
+            fData.fNodes.push_back(node);
+            break;
+        }
+        case EMaterials: {
+            TMaterial material;
+            material.setE(this->get("E"));
+            material.setA(this->get("A"));
+            material.setI(this->get("I"));
+            fData.fMaterials.push_back(material);
+            break;
+        }
+        case ESupports: {
+            TSupport support;
+            support.setFx(this->get("Conditions", 0) != 0);
+            support.setFy(this->get("Conditions", 1) != 0);
+            support.setM(this->get("Conditions", 2) != 0);
+            support.setNodeID((int)this->get("Node"));
+            fData.fSupports.push_back(support);
+            break;
+        }
+        case EElements: {
+            TElement element;
+            element.setNode0ID((int)this->get("Nodes", 0));
+            element.setNode1ID((int)this->get("Nodes", 1));
+            element.setHinge0(this->get("Hinges", 0, 0.) != 0);
+            element.setHinge1(this->get("Hinges", 1, 0.) != 0);
+            element.setMaterialID((int)this->get("Material"));
+            fData.fElements.push_back(element);
+            break;
+        }
+        case ENodalLoads: {
+            TNodalLoad load;
+            load.setNodeID((int)this->get("Node"));
+            load.setFx(this->get("Fx", 0, 0.));
+            load.setFy(this->get("Fy", 0, 0.));
+            load.setM(this->get("M", 0, 0.));
+            fData.fNodalLoads.push_back(load);
+            break;
+        }
+        case EDistributedLoads: {
+            TDistributedLoad load;
+            load.setElementID((int)this->get("Element"));
+            load.setNode0Load(this->get("Node 0 Load"));
+            load.setNode1Load(this->get("Node 1 Load"));
+            load.setLoadPlane(this->get("Load Plane") != 0);
+            fData.fDistributedLoads.push_back(load);
+            break;
+        }
+        case EEndMoments: {
+            TElementEndMoment load;
+            load.setElementID((int)this->get("Element"));
+            load.setNode((int)this->get("Node"));
+            load.setM(this->get("M"));
+            fData.fEndMoments.push_back(load);
+            break;
+        }
+        case ESubstructures: {
+            const std::vector<double>* elements = this->find("Elements");
+            std::vector<int> substructure;
+            if (elements != nullptr) {
+                substructure.assign(elements->begin(), elements->end());
+            }
+            fData.fSubstructures.push_back(substructure);
+            break;
+        }
+        case ENone:
+            break;
+        }
+    }
+};
+
+} // namespace
+
+//! Converts JSON into structure and loads objects.
+void importData(const nlohmann::json &J, TStructure *Parent,
+                std::vector<TNodalLoad> &NodalLoads,
+                std::vector<TDistributedLoad> &DistributedLoads,
+                std::vector<TElementEndMoment> &EndMoments)
+{
+    TModelData data;
+
+    // Reads the vector of TNode.
+    if (J.find("Nodes") != J.end()) {
+        data.fHasNodes = true;
+        for (int i = 0; i < (int)J["Nodes"].size(); i++) {
+            data.fNodes.push_back(J["Nodes"][i].get<TNode>());
+        }
+    }
+
+    // Reads the vector of TMaterial.
+    if (J.find("Materials") != J.end()) {
+        data.fHasMaterials = true;
+        for (int i = 0; i < (int)J["Materials"].size(); i++) {
+            data.fMaterials.push_back(J["Materials"][i].get<TMaterial>());
+        }
+    }
+
+    // Reads the vector of TSupport.
+    if (J.find("Supports") != J.end()) {
+        data.fHasSupports = true;
+        for (int i = 0; i < (int)J["Supports"].size(); i++) {
+            data.fSupports.push_back(J["Supports"][i].get<TSupport>());
+        }
+    }
+
+    // Reads the vector of TElements.
+    if (J.find("Elements") != J.end()) {
+        data.fHasElements = true;
+        for (int i = 0; i < (int)J["Elements"].size(); i++) {
+            data.fElements.push_back(J["Elements"][i].get<TElement>());
+        }
+    }
+
+    // Reads the vector of TNodalLoad.
+    if (J.find("Nodal Loads") != J.end()) {
+        data.fHasNodalLoads = true;
+        for (int i = 0; i < (int)J["Nodal Loads"].size(); i++) {
+            data.fNodalLoads.push_back(J["Nodal Loads"][i].get<TNodalLoad>());
+        }
+    }
+
+    // Reads the vector of TDistributedLoad.
+    if (J.find("Distributed Loads") != J.end()) {
+        data.fHasDistributedLoads = true;
+        for (int i = 0; i < (int)J["Distributed Loads"].size(); i++) {
+            data.fDistributedLoads.push_back(
+                J["Distributed Loads"][i].get<TDistributedLoad>());
+        }
+    }
+
+    // Reads the vector of TElementEndMoment.
+    if (J.find("Element End Moments") != J.end()) {
+        data.fHasEndMoments = true;
+        for (int i = 0; i < (int)J["Element End Moments"].size(); i++) {
+            data.fEndMoments.push_back(
+                J["Element End Moments"][i].get<TElementEndMoment>());
+        }
+    }
+
+    // Reads the elements of each substructure.
+    if (J.find("Substructures") != J.end()) {
+        data.fHasSubstructures = true;
+        for (int i = 0; i < (int)J["Substructures"].size(); i++) {
+            data.fSubstructures.push_back(
+                J["Substructures"][i].at("Elements").get<std::vector<int>>());
+        }
+    }
+
+    storeModel(data, Parent, NodalLoads, DistributedLoads, EndMoments);
+}
+
+//! Reads a JSON model from a stream into structure and loads objects.
+void importData(std::istream& Input, TStructure* Parent,
+                std::vector<TNodalLoad>& NodalLoads,
+                std::vector<TDistributedLoad>& DistributedLoads,
+                std::vector<TElementEndMoment>& EndMoments)
+{
+    TModelData data;
+    TModelReader reader(data);
+    if (!nlohmann::json::sax_parse(Input, &reader)) {
+        // Stops debug if the input is not valid JSON.
+        DebugStop();
+    }
+    storeModel(data, Parent, NodalLoads, DistributedLoads, EndMoments);
+}
+
+//! Converts structure and loads objects into JSON.
+void exportData(nlohmann::json& J, TStructure* Structure,
+                const std::vector<TNodalLoad>& NodalLoads,
+                const std::vector<TDistributedLoad>& DistributedLoads,
+                const std::vector<TElementEndMoment>& EndMoments)
+{
+    J = nlohmann::json::object();
+    J["Nodes"] = Structure->getNodes();
+    J["Materials"] = Structure->getMaterials();
+    J["Supports"] = Structure->getSupports();
+    J["Elements"] = Structure->getElements();
+    if (!NodalLoads.empty()) J["Nodal Loads"] = NodalLoads;
+    if (!DistributedLoads.empty()) J["Distributed Loads"] = DistributedLoads;
+    if (!EndMoments.empty()) J["Element End Moments"] = EndMoments;
+
+    const std::vector<std::vector<int>>& substructures = Structure->getSubstructures();
+    if (!substructures.empty()) {
+        J["Substructures"] = nlohmann::json::array();
+        for (const std::vector<int>& elements : substructures) {
+            J["Substructures"].push_back(nlohmann::json{ { "Elements", elements } });
+        }
+    }
+}
+
 //! Converts a TMaterial object to JSON.
 void to_json(nlohmann::json& J, const TMaterial& M)
 {
@@ -35,6 +35,35 @@ void importData(const nlohmann::json &J, TStructure *Parent,
                 std::vector<TDistributedLoad> &DistributedLoads,
                 std::vector<TElementEndMoment> &EndMoments);
 
+//! Reads a JSON model from a stream into structure and loads objects.
+/*!
+The model is read by a SAX parser, without building the JSON document, so
+the memory used is close to the size of the objects read. The result is the
+same as reading the document and calling the other importData overload.
+\param Input the stream with the JSON model.
+\param Parent the pointer to the TStructure object to be filled.
+\param NodalLoads the address of the TNodalLoad vector to be filled.
+\param DistributedLoads the address of the TDistributedLoad vector to be filled.
+\param EndMoments the address of the TElementEndMoment vector to be filled.
+*/
+void importData(std::istream& Input, TStructure* Parent,
+                std::vector<TNodalLoad>& NodalLoads,
+                std::vector<TDistributedLoad>& DistributedLoads,
+                std::vector<TElementEndMoment>& EndMoments);
+
+//! Converts structure and loads objects into JSON.
+/*!
+\param J the address of the JSON object to be filled.
+\param Structure the pointer to the TStructure object to be converted.
+\param NodalLoads the nodal loads to be converted.
+\param DistributedLoads the distributed loads to be converted.
+\param EndMoments the element end moments to be converted.
+*/
+void exportData(nlohmann::json& J, TStructure* Structure,
+                const std::vector<TNodalLoad>& NodalLoads,
+                const std::vector<TDistributedLoad>& DistributedLoads,
+                const std::vector<TElementEndMoment>& EndMoments);
+
 //! Converts a TMaterial object to JSON.
 /*!
 \param J the adress of the JSON object.
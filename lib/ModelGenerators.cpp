@@ -0,0 +1,353 @@
+/** \file ModelGenerators.cpp
+* Contains the definition of functions that build parametric structures and
+* their loads, used to benchmark the solver.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "ModelGenerators.h"
+
+namespace {
+
+//! Collects the objects of a generated model before they are stored.
+struct TModelBuilder {
+    TStructure* fParent;
+    std::vector<TNode> fNodes;
+    std::vector<TMaterial> fMaterials;
+    std::vector<TSupport> fSupports;
+    std::vector<TElement> fElements;
+
+    TModelBuilder(TStructure* Parent) : fParent(Parent) {}
+
+    int addNode(double X, double Y)
+    {
+        fNodes.push_back(TNode(X, Y));
+        return (int)fNodes.size() - 1;
+    }
+
+    int addMaterial(double E, double A, double I)
+    {
+        fMaterials.push_back(TMaterial(E, A, I));
+        return (int)fMaterials.size() - 1;
+    }
+
+    void addSupport(int NodeID, bool Fx, bool Fy, bool M)
+    {
+        fSupports.push_back(TSupport(fParent, Fx, Fy, M, NodeID));
+    }
+
+    int addElement(int Node0ID, int Node1ID, int MaterialID, bool Hinged = false)
+    {
+        fElements.push_back(
+            TElement(fParent, Node0ID, Node1ID, Hinged, Hinged, MaterialID));
+        return (int)fElements.size() - 1;
+    }
+
+    //! Stores the objects into the structure, in the order used by importData.
+    void store()
+    {
+        fParent->setNodes(fNodes);
+        fParent->setMaterials(fMaterials);
+        fParent->setSupports(fSupports);
+        fParent->setElements(fElements);
+    }
+};
+
+//! Builds a frame of rigid columns and beams on a rectangular grid.
+/*!
+\param HingedBeams marks if every other beam, in a checkerboard, is hinged.
+\param Beams receives the IDs of the beams.
+*/
+void buildGridFrame(int Rows, int Columns, double Width, double Height,
+                    bool HingedBeams, TModelBuilder& Builder,
+                    std::vector<int>& Beams)
+{
+    int column = Builder.addMaterial(2.1e8, 1.0e-2, 1.0e-4);
+    int beam = Builder.addMaterial(2.1e8, 8.0e-3, 8.0e-5);
+
+    for (int i = 0; i <= Rows; i++) {
+        for (int j = 0; j <= Columns; j++) {
+            Builder.addNode(j * Width, i * Height);
+        }
+    }
+    for (int j = 0; j <= Columns; j++) {
+        Builder.addSupport(j, true, true, true);
+    }
+
+    // Columns, then the beams of each level above the base.
+    for (int i = 0; i < Rows; i++) {
+        for (int j = 0; j <= Columns; j++) {
+            int node = i * (Columns + 1) + j;
+            Builder.addElement(node, node + Columns + 1, column);
+        }
+    }
+    Beams.clear();
+    for (int i = 1; i <= Rows; i++) {
+        for (int j = 0; j < Columns; j++) {
+            int node = i * (Columns + 1) + j;
+            bool hinged = HingedBeams && (i + j) % 2 == 1;
+            Beams.push_back(Builder.addElement(node, node + 1, beam, hinged));
+        }
+    }
+}
+
+//! Builds a truss with continuous chords and a bottom chord supported every 16 panels.
+/*!
+\param Warren marks a Warren truss; otherwise, a Pratt truss is built.
+*/
+void buildTruss(int Panels, bool Warren, TModelBuilder& Builder,
+                std::vector<TNodalLoad>& NodalLoads)
+{
+    const double length = 4.0;
+    const double height = 3.0;
+    const int span = 16;
+
+    int chord = Builder.addMaterial(2.1e8, 5.0e-3, 2.0e-5);
+    int web = Builder.addMaterial(2.1e8, 2.0e-3, 1.0e-6);
+
+    // Bottom chord nodes are 0..Panels; the top chord nodes follow them.
+    int nTop = Warren ? Panels : Panels + 1;
+    for (int k = 0; k <= Panels; k++) {
+        Builder.addNode(k * length, 0.);
+    }
+    for (int k = 0; k < nTop; k++) {
+        double x = Warren ? (k + 0.5) * length : k * length;
+        Builder.addNode(x, height);
+    }
+    int top = Panels + 1;
+
+    for (int k = 0; k <= Panels; k++) {
+        if (k == 0) {
+            Builder.addSupport(k, true, true, false);
+        } else if (k % span == 0 || k == Panels) {
+            Builder.addSupport(k, false, true, false);
+        }
+    }
+
+    for (int k = 0; k < Panels; k++) {
+        Builder.addElement(k, k + 1, chord);
+    }
+    for (int k = 0; k + 1 < nTop; k++) {
+        Builder.addElement(top + k, top + k + 1, chord);
+    }
+
+    if (Warren) {
+        for (int k = 0; k < Panels; k++) {
+            Builder.addElement(k, top + k, web, true);
+            Builder.addElement(top + k, k + 1, web, true);
+        }
+    } else {
+        for (int k = 0; k <= Panels; k++) {
+            Builder.addElement(k, top + k, web, true);
+        }
+        // The diagonals slope down towards the middle of each span.
+        for (int k = 0; k < Panels; k++) {
+            if (k % span < span / 2) {
+                Builder.addElement(top + k, k + 1, web, true);
+            } else {
+                Builder.addElement(k, top + k + 1, web, true);
+            }
+        }
+    }
+
+    for (int k = 1; k < Panels; k++) {
+        NodalLoads.push_back(TNodalLoad(Builder.fParent, 0., -10., 0., k));
+    }
+}
+
+} // namespace
+
+//! Gets the name of a model type.
+const char* getModelTypeName(EModelType Type)
+{
+    switch (Type) {
+    case EPortalFrame:
+        return "portal";
+    case EPrattTruss:
+        return "pratt";
+    case EWarrenTruss:
+        return "warren";
+    case EHingedGrid:
+        return "grid";
+    case ERandomMesh:
+        return "random";
+    default:
+        return "";
+    }
+}
+
+//! Builds a portal frame.
+void generatePortalFrame(int Storeys, int Bays, TStructure* Parent,
+                         std::vector<TNodalLoad>& NodalLoads,
+                         std::vector<TDistributedLoad>& DistributedLoads,
+                         std::vector<TElementEndMoment>& /*EndMoments*/)
+{
+    TModelBuilder builder(Parent);
+    std::vector<int> beams;
+    buildGridFrame(Storeys, Bays, 6.0, 3.5, false, builder, beams);
+    builder.store();
+
+    for (int i = 1; i <= Storeys; i++) {
+        NodalLoads.push_back(TNodalLoad(Parent, 5., 0., 0., i * (Bays + 1)));
+    }
+    for (int beam : beams) {
+        DistributedLoads.push_back(TDistributedLoad(Parent, beam, -10., -10., false));
+    }
+}
+
+//! Builds a Pratt truss.
+void generatePrattTruss(int Panels, TStructure* Parent,
+                        std::vector<TNodalLoad>& NodalLoads,
+                        std::vector<TDistributedLoad>& /*DistributedLoads*/,
+                        std::vector<TElementEndMoment>& /*EndMoments*/)
+{
+    TModelBuilder builder(Parent);
+    buildTruss(std::max(Panels, 1), false, builder, NodalLoads);
+    builder.store();
+}
+
+//! Builds a Warren truss.
+void generateWarrenTruss(int Panels, TStructure* Parent,
+                         std::vector<TNodalLoad>& NodalLoads,
+                         std::vector<TDistributedLoad>& /*DistributedLoads*/,
+                         std::vector<TElementEndMoment>& /*EndMoments*/)
+{
+    // With a single panel, the top node would only have hinged members.
+    TModelBuilder builder(Parent);
+    buildTruss(std::max(Panels, 2), true, builder, NodalLoads);
+    builder.store();
+}
+
+//! Builds a grid of beams and columns with hinges.
+void generateHingedGrid(int Rows, int Columns, TStructure* Parent,
+                        std::vector<TNodalLoad>& NodalLoads,
+                        std::vector<TDistributedLoad>& DistributedLoads,
+                        std::vector<TElementEndMoment>& EndMoments)
+{
+    TModelBuilder builder(Parent);
+    std::vector<int> beams;
+    buildGridFrame(Rows, Columns, 1.0, 1.0, true, builder, beams);
+    builder.store();
+
+    for (int i = 1; i <= Rows; i++) {
+        NodalLoads.push_back(TNodalLoad(Parent, 1., 0., 0., i * (Columns + 1)));
+    }
+    for (size_t b = 0; b < beams.size(); b++) {
+        DistributedLoads.push_back(TDistributedLoad(Parent, beams[b], -2., -1., false));
+        if (!builder.fElements[beams[b]].getHinge0()) {
+            EndMoments.push_back(TElementEndMoment(Parent, 0.5, beams[b], 0));
+        }
+    }
+}
+
+//! Builds a random perturbed mesh.
+void generateRandomMesh(int Rows, int Columns, unsigned Seed, TStructure* Parent,
+                        std::vector<TNodalLoad>& NodalLoads,
+                        std::vector<TDistributedLoad>& DistributedLoads,
+                        std::vector<TElementEndMoment>& /*EndMoments*/)
+{
+    std::mt19937 random(Seed);
+    std::uniform_real_distribution<double> offset(-0.3, 0.3);
+    std::uniform_real_distribution<double> load(-10., 10.);
+    std::uniform_int_distribution<int> coin(0, 1);
+
+    TModelBuilder builder(Parent);
+    std::vector<int> materials;
+    materials.push_back(builder.addMaterial(2.1e8, 4.0e-3, 2.0e-5));
+    materials.push_back(builder.addMaterial(2.1e8, 6.0e-3, 4.0e-5));
+    materials.push_back(builder.addMaterial(3.0e7, 4.0e-2, 1.0e-4));
+    std::uniform_int_distribution<int> material(0, (int)materials.size() - 1);
+
+    // The base stays straight; every other node is moved.
+    for (int i = 0; i <= Rows; i++) {
+        for (int j = 0; j <= Columns; j++) {
+            double x = j + offset(random);
+            double y = (i == 0) ? 0. : i + offset(random);
+            builder.addNode(x, y);
+        }
+    }
+    for (int j = 0; j <= Columns; j++) {
+        builder.addSupport(j, true, true, false);
+    }
+
+    auto nodeID = [Columns](int i, int j) { return i * (Columns + 1) + j; };
+    std::vector<int> topElements;
+    for (int i = 0; i <= Rows; i++) {
+        for (int j = 0; j <= Columns; j++) {
+            if (j < Columns) {
+                int e = builder.addElement(nodeID(i, j), nodeID(i, j + 1),
+                                           materials[material(random)]);
+                if (i == Rows) topElements.push_back(e);
+            }
+            if (i < Rows) {
+                builder.addElement(nodeID(i, j), nodeID(i + 1, j),
+                                   materials[material(random)]);
+            }
+            if (i < Rows && j < Columns) {
+                if (coin(random) == 0) {
+                    builder.addElement(nodeID(i, j), nodeID(i + 1, j + 1),
+                                       materials[material(random)]);
+                } else {
+                    builder.addElement(nodeID(i, j + 1), nodeID(i + 1, j),
+                                       materials[material(random)]);
+                }
+            }
+        }
+    }
+    builder.store();
+
+    for (int j = 0; j <= Columns; j++) {
+        NodalLoads.push_back(
+            TNodalLoad(Parent, load(random), load(random), 0., nodeID(Rows, j)));
+    }
+    for (int e : topElements) {
+        DistributedLoads.push_back(
+            TDistributedLoad(Parent, e, load(random), load(random), true));
+    }
+}
+
+//! Builds a model of a given type with about a given number of elements.
+void generateModel(EModelType Type, int NElements, unsigned Seed,
+                   TStructure* Parent, std::vector<TNodalLoad>& NodalLoads,
+                   std::vector<TDistributedLoad>& DistributedLoads,
+                   std::vector<TElementEndMoment>& EndMoments)
+{
+    double n = std::max(NElements, 1);
+    switch (Type) {
+    case EPortalFrame:
+    case EHingedGrid: {
+        // Rows * (2 * Columns + 1) elements.
+        int columns = std::max(1, (int)std::lround(std::sqrt(n / 2.)));
+        int rows = std::max(1, (int)std::lround(n / (2 * columns + 1)));
+        if (Type == EPortalFrame) {
+            generatePortalFrame(rows, columns, Parent, NodalLoads,
+                                DistributedLoads, EndMoments);
+        } else {
+            generateHingedGrid(rows, columns, Parent, NodalLoads,
+                               DistributedLoads, EndMoments);
+        }
+        break;
+    }
+    case EPrattTruss:
+        // 4 * Panels + 1 elements.
+        generatePrattTruss((int)std::lround((n - 1.) / 4.), Parent, NodalLoads,
+                           DistributedLoads, EndMoments);
+        break;
+    case EWarrenTruss:
+        // 4 * Panels - 1 elements.
+        generateWarrenTruss((int)std::lround((n + 1.) / 4.), Parent, NodalLoads,
+                            DistributedLoads, EndMoments);
+        break;
+    case ERandomMesh: {
+        // About 3 * Rows * Columns elements.
+        int size = std::max(1, (int)std::lround(std::sqrt(n / 3.)));
+        generateRandomMesh(size, size, Seed, Parent, NodalLoads,
+                           DistributedLoads, EndMoments);
+        break;
+    }
+    default:
+        // Stops debug if the model type is not valid.
+        DebugStop();
+    }
+}
@@ -0,0 +1,135 @@
+/** \file ModelGenerators.h
+* Contains the declaration of functions that build parametric structures and
+* their loads, used to benchmark the solver.
+*/
+
+#ifndef MODELGENERATORS_H
+#define MODELGENERATORS_H
+
+#include <vector>
+#include "TStructure.h"
+#include "TNodalLoad.h"
+#include "TDistributedLoad.h"
+#include "TElementEndMoment.h"
+
+//! The families of generated models.
+enum EModelType {
+    //! Multi-storey, multi-bay portal frame with fixed column bases.
+    EPortalFrame,
+    //! Continuous Pratt truss with verticals and hinged web members.
+    EPrattTruss,
+    //! Continuous Warren truss with hinged diagonals.
+    EWarrenTruss,
+    //! Square grid of beams and columns with hinged beams in a checkerboard.
+    EHingedGrid,
+    //! Triangulated mesh with randomly perturbed nodes, materials and loads.
+    ERandomMesh,
+    //! The number of model types.
+    ENModelTypes
+};
+
+//! Gets the name of a model type ("portal", "pratt", "warren", "grid" or "random").
+const char* getModelTypeName(EModelType Type);
+
+//! Builds a portal frame.
+/*!
+The columns are 3.5 m high and the bays 6 m wide. The beams carry a uniform
+distributed load and each storey a lateral nodal load at its left node.
+\param Storeys the number of storeys.
+\param Bays the number of bays.
+\param Parent the pointer to the TStructure object to be filled.
+\param NodalLoads the address of the TNodalLoad vector to be filled.
+\param DistributedLoads the address of the TDistributedLoad vector to be filled.
+\param EndMoments the address of the TElementEndMoment vector to be filled.
+*/
+void generatePortalFrame(int Storeys, int Bays, TStructure* Parent,
+                         std::vector<TNodalLoad>& NodalLoads,
+                         std::vector<TDistributedLoad>& DistributedLoads,
+                         std::vector<TElementEndMoment>& EndMoments);
+
+//! Builds a Pratt truss.
+/*!
+The panels are 4 m long and 3 m high. The chords are continuous and the
+verticals and diagonals are hinged at both ends. The bottom chord is
+supported every 16 panels and loaded at every node.
+\param Panels the number of panels.
+\param Parent the pointer to the TStructure object to be filled.
+\param NodalLoads the address of the TNodalLoad vector to be filled.
+\param DistributedLoads the address of the TDistributedLoad vector to be filled.
+\param EndMoments the address of the TElementEndMoment vector to be filled.
+*/
+void generatePrattTruss(int Panels, TStructure* Parent,
+                        std::vector<TNodalLoad>& NodalLoads,
+                        std::vector<TDistributedLoad>& DistributedLoads,
+                        std::vector<TElementEndMoment>& EndMoments);
+
+//! Builds a Warren truss.
+/*!
+The panels are 4 m long and 3 m high, with the top chord nodes above the
+middle of the panels. The chords are continuous and the diagonals are hinged
+at both ends. The bottom chord is supported every 16 panels and loaded at
+every node.
+\param Panels the number of panels.
+\param Parent the pointer to the TStructure object to be filled.
+\param NodalLoads the address of the TNodalLoad vector to be filled.
+\param DistributedLoads the address of the TDistributedLoad vector to be filled.
+\param EndMoments the address of the TElementEndMoment vector to be filled.
+*/
+void generateWarrenTruss(int Panels, TStructure* Parent,
+                         std::vector<TNodalLoad>& NodalLoads,
+                         std::vector<TDistributedLoad>& DistributedLoads,
+                         std::vector<TElementEndMoment>& EndMoments);
+
+//! Builds a grid of beams and columns with hinges.
+/*!
+The grid has 1 m cells and fixed supports along its base. The columns are
+continuous and every other beam, in a checkerboard, is hinged at both ends.
+The beams carry distributed loads, the left nodes lateral loads and the
+rigid beams an end moment at their node 0.
+\param Rows the number of rows of cells.
+\param Columns the number of columns of cells.
+\param Parent the pointer to the TStructure object to be filled.
+\param NodalLoads the address of the TNodalLoad vector to be filled.
+\param DistributedLoads the address of the TDistributedLoad vector to be filled.
+\param EndMoments the address of the TElementEndMoment vector to be filled.
+*/
+void generateHingedGrid(int Rows, int Columns, TStructure* Parent,
+                        std::vector<TNodalLoad>& NodalLoads,
+                        std::vector<TDistributedLoad>& DistributedLoads,
+                        std::vector<TElementEndMoment>& EndMoments);
+
+//! Builds a random perturbed mesh.
+/*!
+The nodes of a grid of 1 m cells are moved by up to 0.3 m in each direction
+and each cell is split by one of its diagonals. The materials, the
+diagonals and the loads on the top nodes are random. The base is pinned.
+\param Rows the number of rows of cells.
+\param Columns the number of columns of cells.
+\param Seed the seed of the random numbers; the same seed builds the same mesh.
+\param Parent the pointer to the TStructure object to be filled.
+\param NodalLoads the address of the TNodalLoad vector to be filled.
+\param DistributedLoads the address of the TDistributedLoad vector to be filled.
+\param EndMoments the address of the TElementEndMoment vector to be filled.
+*/
+void generateRandomMesh(int Rows, int Columns, unsigned Seed, TStructure* Parent,
+                        std::vector<TNodalLoad>& NodalLoads,
+                        std::vector<TDistributedLoad>& DistributedLoads,
+                        std::vector<TElementEndMoment>& EndMoments);
+
+//! Builds a model of a given type with about a given number of elements.
+/*!
+The dimensions are chosen so that 2D models are roughly square.
+\param Type the type of the model.
+\param NElements the approximate number of elements.
+\param Seed the seed of the random numbers (used by ERandomMesh only).
+\param Parent the pointer to the TStructure object to be filled.
+\param NodalLoads the address of the TNodalLoad vector to be filled.
+\param DistributedLoads the address of the TDistributedLoad vector to be filled.
+\param EndMoments the address of the TElementEndMoment vector to be filled.
+*/
+void generateModel(EModelType Type, int NElements, unsigned Seed,
+                   TStructure* Parent, std::vector<TNodalLoad>& NodalLoads,
+                   std::vector<TDistributedLoad>& DistributedLoads,
+                   std::vector<TElementEndMoment>& EndMoments);
+
+#endif // MODELGENERATORS_H
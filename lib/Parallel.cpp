@@ -0,0 +1,222 @@
+/** \file Parallel.cpp
+* Contains the definition of functions that split loops among threads.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Parallel.h"
+#include "TSolveProfile.h"
+
+namespace {
+
+//! A pool of worker threads that run the tasks of the parallel loops.
+class TThreadPool
+{
+public:
+    //! Gets the pool shared by all loops.
+    static TThreadPool& instance()
+    {
+        static TThreadPool pool;
+        return pool;
+    }
+
+    //! Destructor. Stops and joins the workers.
+    ~TThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fStop = true;
+        }
+        fWake.notify_all();
+        for (int t = 0; t < (int)fWorkers.size(); t++) {
+            fWorkers[t].join();
+        }
+    }
+
+    TThreadPool(const TThreadPool&) = delete;
+    TThreadPool& operator=(const TThreadPool&) = delete;
+
+    //! Runs Task(0), ..., Task(NTasks - 1) and returns when all have finished.
+    /*!
+    Task(0) runs on the calling thread and the others are queued for the
+    workers. While it waits, the calling thread runs queued tasks too, so a
+    task may itself call run() without exhausting the workers. The bytes
+    allocated by the queued tasks are added to the calling thread (see
+    getAllocatedBytes()), wherever they ran. If a task
+    throws, the tasks not yet started are skipped and, once all have
+    finished, the first exception is rethrown on the calling thread.
+    \param NTasks the number of tasks.
+    \param Task the function that runs one task.
+    */
+    void run(int NTasks, const std::function<void(int Index)>& Task)
+    {
+        TCall call = {&Task, NTasks, 0, nullptr};
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            while ((int)fWorkers.size() < NTasks - 1) {
+                fWorkers.emplace_back(&TThreadPool::work, this);
+            }
+            for (int t = 1; t < NTasks; t++) {
+                fQueue.push_back({&call, t});
+            }
+        }
+        fWake.notify_all();
+
+        std::unique_lock<std::mutex> lock(fMutex);
+        runJob({&call, 0}, lock);
+        while (call.fRemaining > 0) {
+            if (!fQueue.empty()) {
+                TJob job = fQueue.front();
+                fQueue.pop_front();
+                runJob(job, lock);
+            }
+            else {
+                fDone.wait(lock);
+            }
+        }
+        lock.unlock();
+
+        addAllocatedBytes(call.fBytes);
+        if (call.fError) std::rethrow_exception(call.fError);
+    }
+
+private:
+    //! The state of a call to run(), kept on the stack of the caller.
+    struct TCall {
+        const std::function<void(int)>* fTask;
+        // fRemaining - the number of tasks that have not finished.
+        int fRemaining;
+        // fBytes - the bytes allocated by the queued tasks.
+        int64_t fBytes;
+        // fError - the first exception thrown by a task.
+        std::exception_ptr fError;
+    };
+
+    //! A task of a call to run().
+    struct TJob {
+        TCall* fCall;
+        int fIndex;
+    };
+
+    TThreadPool() : fStop(false) {}
+
+    //! Runs a job, with fMutex locked on entry and on exit.
+    /*!
+    An exception thrown by the task is kept in its call instead of escaping,
+    and the call is only marked as finished after the task has returned. The
+    bytes allocated by a queued task are moved from the running thread to its
+    call.
+    */
+    void runJob(const TJob& Job, std::unique_lock<std::mutex>& Lock)
+    {
+        TCall* call = Job.fCall;
+        if (!call->fError) {
+            Lock.unlock();
+            int64_t startBytes = getAllocatedBytes();
+            std::exception_ptr error;
+            try {
+                (*call->fTask)(Job.fIndex);
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+            int64_t bytes = 0;
+            if (Job.fIndex > 0) {
+                bytes = getAllocatedBytes() - startBytes;
+                addAllocatedBytes(-bytes);
+            }
+            Lock.lock();
+            call->fBytes += bytes;
+            if (error && !call->fError) call->fError = error;
+        }
+        if (--call->fRemaining == 0) fDone.notify_all();
+    }
+
+    //! The loop of each worker thread.
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(fMutex);
+        while (true) {
+            fWake.wait(lock, [this] { return fStop || !fQueue.empty(); });
+            if (fQueue.empty()) return;
+            TJob job = fQueue.front();
+            fQueue.pop_front();
+            runJob(job, lock);
+        }
+    }
+
+    // fWorkers - the worker threads, added as larger loops are requested.
+    std::vector<std::thread> fWorkers;
+    // fQueue - the jobs waiting for a thread.
+    std::deque<TJob> fQueue;
+    // fMutex - guards fQueue, fStop and the counters of the pending calls.
+    std::mutex fMutex;
+    // fWake - signals the workers that there are jobs or that they must stop.
+    std::condition_variable fWake;
+    // fDone - signals the callers of run() that a job has finished.
+    std::condition_variable fDone;
+    // fStop - whether the workers must stop.
+    bool fStop;
+};
+
+} // namespace
+
+//! Gets the number of threads to be used.
+int getNumberOfThreads(int Requested)
+{
+    if (Requested > 0) return Requested;
+
+    int hardware = (int)std::thread::hardware_concurrency();
+    return (hardware > 0) ? hardware : 1;
+}
+
+//! Runs a loop over [Begin, End) split into contiguous chunks, one per thread.
+void parallelFor(int Begin, int End, int NThreads,
+                 const std::function<void(int First, int Last)>& Body)
+{
+    int size = End - Begin;
+    if (size <= 0) return;
+
+    int nChunks = getNumberOfThreads(NThreads);
+    if (nChunks > size) nChunks = size;
+    if (nChunks == 1) {
+        Body(Begin, End);
+        return;
+    }
+
+    TThreadPool::instance().run(nChunks, [&](int t) {
+        int first = Begin + (int)((int64_t)size * t / nChunks);
+        int last = Begin + (int)((int64_t)size * (t + 1) / nChunks);
+        Body(first, last);
+    });
+}
+
+//! Runs a loop over [Begin, End) whose iterations are handed out one at a time.
+void parallelForEach(int Begin, int End, int NThreads,
+                     const std::function<void(int Index)>& Body)
+{
+    int size = End - Begin;
+    if (size <= 0) return;
+
+    int nWorkers = getNumberOfThreads(NThreads);
+    if (nWorkers > size) nWorkers = size;
+
+    std::atomic<int> next(Begin);
+    auto worker = [&](int) {
+        for (int i = next++; i < End; i = next++) {
+            Body(i);
+        }
+    };
+    if (nWorkers == 1) {
+        worker(0);
+        return;
+    }
+
+    TThreadPool::instance().run(nWorkers, worker);
+}
@@ -0,0 +1,51 @@
+/** \file Parallel.h
+* Contains the declaration of functions that split loops among threads.
+* The threads are taken from a pool that is created on first use and kept
+* alive between calls, so short loops do not pay for starting threads.
+*/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+
+//! Gets the number of threads to be used.
+/*!
+\param Requested the requested number of threads. Zero or a negative value
+selects the number of hardware threads.
+\return the number of threads to be used, at least one.
+*/
+int getNumberOfThreads(int Requested = 0);
+
+//! Runs a loop over [Begin, End) split into contiguous chunks, one per thread.
+/*!
+The chunks are fixed by the range and the number of threads, so a loop whose
+iterations are independent always gives the same results. The calling thread
+runs the first chunk and waits for the others to finish, running chunks still
+queued in the pool meanwhile, so the loop may be nested in another one. If
+Body throws, the chunks not yet started are skipped and the first exception
+is rethrown on the calling thread after the others have finished.
+\param Begin the first index of the loop.
+\param End the index after the last one of the loop.
+\param NThreads the number of threads (see getNumberOfThreads()).
+\param Body the function that runs the indexes [First, Last) of a chunk.
+*/
+void parallelFor(int Begin, int End, int NThreads,
+                 const std::function<void(int First, int Last)>& Body);
+
+//! Runs a loop over [Begin, End) whose iterations are handed out one at a time.
+/*!
+Each thread takes the next index as soon as it finishes the previous one, so
+the load is balanced when the iterations have very different costs. The
+order in which the iterations run is not fixed. If Body throws, the first
+exception is rethrown on the calling thread after the other threads have
+finished.
+\param Begin the first index of the loop.
+\param End the index after the last one of the loop.
+\param NThreads the number of threads (see getNumberOfThreads()).
+\param Body the function that runs one index of the loop.
+*/
+void parallelForEach(int Begin, int End, int NThreads,
+                     const std::function<void(int Index)>& Body);
+
+#endif // PARALLEL_H
@@ -0,0 +1,478 @@
+/** \file Renumbering.cpp
+* Contains the definition of functions that reorder the vertices of a graph
+* to reduce the bandwidth, profile or fill-in of the associated matrices.
+*/
+
+#include <algorithm>
+#include "Renumbering.h"
+
+//! Builds the level structure of the component of a vertex.
+/*!
+\param AdjPtr the position of the first neighbour of each vertex in Adj.
+\param Adj the concatenated neighbours of all the vertices.
+\param Root the vertex the breadth-first search starts from.
+\param Excluded the vertices that have already been numbered.
+\param Mark the visit mark of each vertex, compared against Stamp.
+\param Stamp the mark of the current search.
+\param Levels the visited vertices, level by level.
+\param LastLevel the position in Levels of the first vertex of the last level.
+\param LevelPtr if given, receives the position in Levels of the first vertex
+of each level, plus the number of visited vertices.
+\return the number of levels.
+*/
+static int buildLevels(const std::vector<int>& AdjPtr,
+                       const std::vector<int>& Adj, int Root,
+                       const std::vector<bool>& Excluded,
+                       std::vector<int>& Mark, int Stamp,
+                       std::vector<int>& Levels, int& LastLevel,
+                       std::vector<int>* LevelPtr = nullptr)
+{
+    Levels.clear();
+    Levels.push_back(Root);
+    Mark[Root] = Stamp;
+    if (LevelPtr != nullptr) {
+        LevelPtr->assign(1, 0);
+    }
+
+    int levelBegin = 0;
+    int nLevels = 1;
+    while (true) {
+        int levelEnd = (int)Levels.size();
+        if (LevelPtr != nullptr) {
+            LevelPtr->push_back(levelEnd);
+        }
+        for (int k = levelBegin; k < levelEnd; k++) {
+            int v = Levels[k];
+            for (int a = AdjPtr[v]; a < AdjPtr[v + 1]; a++) {
+                int w = Adj[a];
+                if (!Excluded[w] && Mark[w] != Stamp) {
+                    Mark[w] = Stamp;
+                    Levels.push_back(w);
+                }
+            }
+        }
+        if ((int)Levels.size() == levelEnd) break;
+        levelBegin = levelEnd;
+        nLevels++;
+    }
+    LastLevel = levelBegin;
+    return nLevels;
+}
+
+//! Finds a pseudo-peripheral vertex of the component of a vertex (George-Liu).
+/*!
+Restarts the level structure from a minimum degree vertex of its last level
+while the number of levels keeps growing.
+\param AdjPtr the position of the first neighbour of each vertex in Adj.
+\param Adj the concatenated neighbours of all the vertices.
+\param Seed a vertex of the component.
+\param Excluded the vertices that do not belong to the graph.
+\param Mark the visit mark of each vertex.
+\param Stamp the next unused mark, updated by the searches.
+\param Levels receives the level structure rooted at the returned vertex.
+\param LevelPtr if given, receives the position in Levels of the first
+vertex of each level, plus the number of visited vertices.
+\return the pseudo-peripheral vertex.
+*/
+static int findPseudoPeripheral(const std::vector<int>& AdjPtr,
+                                const std::vector<int>& Adj, int Seed,
+                                const std::vector<bool>& Excluded,
+                                std::vector<int>& Mark, int& Stamp,
+                                std::vector<int>& Levels,
+                                std::vector<int>* LevelPtr = nullptr)
+{
+    auto degree = [&AdjPtr](int v) { return AdjPtr[v + 1] - AdjPtr[v]; };
+
+    int root = Seed;
+    int lastLevel;
+    int depth = buildLevels(AdjPtr, Adj, root, Excluded, Mark, Stamp++,
+                            Levels, lastLevel, LevelPtr);
+    std::vector<int> candidateLevels;
+    std::vector<int> candidatePtr;
+    while (true) {
+        int candidate = Levels[lastLevel];
+        for (int k = lastLevel + 1; k < (int)Levels.size(); k++) {
+            if (degree(Levels[k]) < degree(candidate)) {
+                candidate = Levels[k];
+            }
+        }
+        int candidateLast;
+        int candidateDepth =
+            buildLevels(AdjPtr, Adj, candidate, Excluded, Mark, Stamp++,
+                        candidateLevels, candidateLast,
+                        LevelPtr != nullptr ? &candidatePtr : nullptr);
+        if (candidateDepth <= depth) break;
+        root = candidate;
+        depth = candidateDepth;
+        Levels.swap(candidateLevels);
+        lastLevel = candidateLast;
+        if (LevelPtr != nullptr) {
+            LevelPtr->swap(candidatePtr);
+        }
+    }
+    return root;
+}
+
+//! Orders the vertices of a graph by the Reverse Cuthill-McKee algorithm.
+std::vector<int> reverseCuthillMcKee(const std::vector<int>& AdjPtr,
+                                     const std::vector<int>& Adj)
+{
+    int n = (int)AdjPtr.size() - 1;
+    std::vector<int> order;
+    order.reserve(n);
+
+    std::vector<bool> numbered(n, false);
+    std::vector<int> mark(n, -1);
+    std::vector<int> levels;
+    int stamp = 0;
+
+    auto degree = [&AdjPtr](int v) { return AdjPtr[v + 1] - AdjPtr[v]; };
+
+    for (int seed = 0; seed < n; seed++) {
+        if (numbered[seed]) continue;
+
+        // Starts from a pseudo-peripheral vertex of the component.
+        int root = findPseudoPeripheral(AdjPtr, Adj, seed, numbered, mark,
+                                        stamp, levels);
+
+        // Cuthill-McKee search: neighbours are visited by increasing degree.
+        int first = (int)order.size();
+        order.push_back(root);
+        numbered[root] = true;
+        std::vector<int> neighbours;
+        for (int k = first; k < (int)order.size(); k++) {
+            int v = order[k];
+            neighbours.clear();
+            for (int a = AdjPtr[v]; a < AdjPtr[v + 1]; a++) {
+                int w = Adj[a];
+                if (!numbered[w]) {
+                    numbered[w] = true;
+                    neighbours.push_back(w);
+                }
+            }
+            std::stable_sort(neighbours.begin(), neighbours.end(),
+                             [&degree](int a, int b) {
+                                 return degree(a) < degree(b);
+                             });
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+//! Orders the vertices of a graph by the Approximate Minimum Degree algorithm.
+std::vector<int> approximateMinimumDegree(const std::vector<int>& AdjPtr,
+                                          const std::vector<int>& Adj)
+{
+    int n = (int)AdjPtr.size() - 1;
+    std::vector<int> order;
+    order.reserve(n);
+
+    // Quotient graph: the variables and elements adjacent to each variable,
+    // and the variables of each element. An eliminated variable becomes an
+    // element; an element adjacent to the pivot is absorbed by it.
+    enum EStatus { EVariable, EElement, EAbsorbed };
+    std::vector<char> status(n, EVariable);
+    std::vector<std::vector<int>> variables(n), elements(n), elementVariables(n);
+    std::vector<int> degree(n);
+    for (int v = 0; v < n; v++) {
+        variables[v].assign(Adj.begin() + AdjPtr[v], Adj.begin() + AdjPtr[v + 1]);
+        degree[v] = (int)variables[v].size();
+    }
+
+    // Doubly linked lists of the variables of each degree.
+    std::vector<int> head(n + 1, -1), next(n, -1), prev(n, -1);
+    auto insert = [&](int v) {
+        int d = degree[v];
+        prev[v] = -1;
+        next[v] = head[d];
+        if (head[d] != -1) prev[head[d]] = v;
+        head[d] = v;
+    };
+    auto remove = [&](int v) {
+        if (prev[v] != -1) next[prev[v]] = next[v];
+        else head[degree[v]] = next[v];
+        if (next[v] != -1) prev[next[v]] = prev[v];
+    };
+    for (int v = n - 1; v >= 0; v--) {
+        insert(v);
+    }
+
+    std::vector<int> mark(n, -1);
+    std::vector<int> weight(n, 0), weightMark(n, -1);
+    std::vector<int> pivotVariables;
+    int minDegree = 0;
+
+    for (int k = 0; k < n; k++) {
+        while (head[minDegree] == -1) {
+            minDegree++;
+        }
+        int p = head[minDegree];
+        remove(p);
+        order.push_back(p);
+
+        // Lp: the variables adjacent to p, directly or through its elements,
+        // which are absorbed.
+        pivotVariables.clear();
+        mark[p] = k;
+        for (int v : variables[p]) {
+            if (status[v] == EVariable && mark[v] != k) {
+                mark[v] = k;
+                pivotVariables.push_back(v);
+            }
+        }
+        for (int e : elements[p]) {
+            if (status[e] != EElement) continue;
+            for (int v : elementVariables[e]) {
+                if (status[v] == EVariable && mark[v] != k) {
+                    mark[v] = k;
+                    pivotVariables.push_back(v);
+                }
+            }
+            status[e] = EAbsorbed;
+            std::vector<int>().swap(elementVariables[e]);
+        }
+        status[p] = EElement;
+        elementVariables[p] = pivotVariables;
+        std::vector<int>().swap(variables[p]);
+        std::vector<int>().swap(elements[p]);
+
+        // |Le \ Lp| for the other elements adjacent to Lp.
+        for (int i : pivotVariables) {
+            for (int e : elements[i]) {
+                if (status[e] != EElement) continue;
+                if (weightMark[e] != k) {
+                    weightMark[e] = k;
+                    weight[e] = (int)elementVariables[e].size();
+                }
+                weight[e]--;
+            }
+        }
+
+        // Updates the lists and the approximate degree of each variable of Lp.
+        int nPivot = (int)pivotVariables.size();
+        for (int i : pivotVariables) {
+            remove(i);
+
+            std::vector<int>& iElements = elements[i];
+            int count = 0;
+            int external = 0;
+            for (int e : iElements) {
+                if (status[e] != EElement) continue;
+                iElements[count++] = e;
+                external += weight[e];
+            }
+            iElements.resize(count);
+            iElements.push_back(p);
+
+            // Variables of Lp are now reached through the element p.
+            std::vector<int>& iVariables = variables[i];
+            count = 0;
+            for (int v : iVariables) {
+                if (status[v] == EVariable && mark[v] != k) {
+                    iVariables[count++] = v;
+                }
+            }
+            iVariables.resize(count);
+
+            int d = count + (nPivot - 1) + external;
+            d = std::min(d, degree[i] + nPivot - 1);
+            d = std::min(d, n - k - 2);
+            degree[i] = std::max(d, 0);
+            insert(i);
+            minDegree = std::min(minDegree, degree[i]);
+        }
+    }
+    return order;
+}
+
+//! Orders a part of a graph by nested dissection, appending it to an order.
+/*!
+\param AdjPtr the position of the first neighbour of each vertex in Adj.
+\param Adj the concatenated neighbours of all the vertices.
+\param Part the vertices of the part.
+\param Excluded marks the vertices that do not belong to the part. It is
+restored on return.
+\param Mark the visit mark of each vertex.
+\param Stamp the next unused mark.
+\param Local a work array for the local index of each vertex of a leaf.
+\param Order the order the part is appended to.
+*/
+static void dissect(const std::vector<int>& AdjPtr, const std::vector<int>& Adj,
+                    const std::vector<int>& Part, std::vector<bool>& Excluded,
+                    std::vector<int>& Mark, int& Stamp, std::vector<int>& Local,
+                    std::vector<int>& Order)
+{
+    // Parts up to this size are ordered by minimum degree.
+    const int leafSize = 64;
+    int size = (int)Part.size();
+    if (size == 0) return;
+
+    std::vector<int> levels, levelPtr;
+    int nLevels = 0;
+    if (size > leafSize) {
+        for (int v : Part) Excluded[v] = false;
+        findPseudoPeripheral(AdjPtr, Adj, Part[0], Excluded, Mark, Stamp,
+                             levels, &levelPtr);
+        nLevels = (int)levelPtr.size() - 2;
+        for (int v : Part) Excluded[v] = true;
+
+        if ((int)levels.size() < size) {
+            // Disconnected part: the component of the root and the rest are
+            // ordered separately.
+            int stamp = Stamp++;
+            for (int v : levels) Mark[v] = stamp;
+            std::vector<int> rest;
+            for (int v : Part) {
+                if (Mark[v] != stamp) rest.push_back(v);
+            }
+            dissect(AdjPtr, Adj, levels, Excluded, Mark, Stamp, Local, Order);
+            dissect(AdjPtr, Adj, rest, Excluded, Mark, Stamp, Local, Order);
+            return;
+        }
+    }
+
+    if (size <= leafSize || nLevels < 3) {
+        // Orders the induced subgraph by minimum degree.
+        int stamp = Stamp++;
+        for (int k = 0; k < size; k++) {
+            Mark[Part[k]] = stamp;
+            Local[Part[k]] = k;
+        }
+        std::vector<int> subPtr(1, 0), subAdj;
+        for (int k = 0; k < size; k++) {
+            int v = Part[k];
+            for (int a = AdjPtr[v]; a < AdjPtr[v + 1]; a++) {
+                if (Mark[Adj[a]] == stamp) subAdj.push_back(Local[Adj[a]]);
+            }
+            subPtr.push_back((int)subAdj.size());
+        }
+        std::vector<int> subOrder = approximateMinimumDegree(subPtr, subAdj);
+        for (int k : subOrder) {
+            Order.push_back(Part[k]);
+        }
+        return;
+    }
+
+    // The separator is the level that splits the part in halves.
+    int m = 1;
+    while (m < nLevels - 2 && levelPtr[m + 1] < size / 2) {
+        m++;
+    }
+    int stamp = Stamp++;
+    for (int k = levelPtr[m + 1]; k < levelPtr[m + 2]; k++) {
+        Mark[levels[k]] = stamp;
+    }
+
+    // Separator vertices with no neighbour beyond the separator are moved to
+    // the first half.
+    std::vector<int> first(levels.begin(), levels.begin() + levelPtr[m]);
+    std::vector<int> separator;
+    for (int k = levelPtr[m]; k < levelPtr[m + 1]; k++) {
+        int v = levels[k];
+        bool touchesSecond = false;
+        for (int a = AdjPtr[v]; a < AdjPtr[v + 1]; a++) {
+            if (Mark[Adj[a]] == stamp) {
+                touchesSecond = true;
+                break;
+            }
+        }
+        if (touchesSecond) separator.push_back(v);
+        else first.push_back(v);
+    }
+    std::vector<int> second(levels.begin() + levelPtr[m + 1], levels.end());
+
+    dissect(AdjPtr, Adj, first, Excluded, Mark, Stamp, Local, Order);
+    dissect(AdjPtr, Adj, second, Excluded, Mark, Stamp, Local, Order);
+    Order.insert(Order.end(), separator.begin(), separator.end());
+}
+
+//! Orders the vertices of a graph by nested dissection.
+std::vector<int> nestedDissection(const std::vector<int>& AdjPtr,
+                                  const std::vector<int>& Adj)
+{
+    int n = (int)AdjPtr.size() - 1;
+    std::vector<int> order;
+    order.reserve(n);
+
+    std::vector<int> all(n);
+    for (int v = 0; v < n; v++) {
+        all[v] = v;
+    }
+    std::vector<bool> excluded(n, true);
+    std::vector<int> mark(n, -1);
+    std::vector<int> local(n);
+    int stamp = 0;
+    dissect(AdjPtr, Adj, all, excluded, mark, stamp, local, order);
+    return order;
+}
+
+//! Splits a part of a graph into a number of parts by recursive bisection.
+/*!
+\param AdjPtr the position of the first neighbour of each vertex in Adj.
+\param Adj the concatenated neighbours of all the vertices.
+\param Part the vertices of the part.
+\param NParts the number of parts it is split into.
+\param FirstPart the number of the first of these parts.
+\param Excluded marks the vertices that do not belong to the part. It is
+restored on return.
+\param Mark the visit mark of each vertex.
+\param Stamp the next unused mark.
+\param Parts receives the part of each vertex of the part.
+*/
+static void bisect(const std::vector<int>& AdjPtr, const std::vector<int>& Adj,
+                   const std::vector<int>& Part, int NParts, int FirstPart,
+                   std::vector<bool>& Excluded, std::vector<int>& Mark,
+                   int& Stamp, std::vector<int>& Parts)
+{
+    int size = (int)Part.size();
+    if (NParts == 1 || size <= 1) {
+        for (int v : Part) Parts[v] = FirstPart;
+        return;
+    }
+
+    // Orders the part by levels, component after component, so that the
+    // vertices close to each other end up on the same side of the cut. The
+    // searches mark the vertices they visit with stamps from Stamp on.
+    std::vector<int> order;
+    order.reserve(size);
+    for (int v : Part) Excluded[v] = false;
+    int stamp = Stamp;
+    for (int v : Part) {
+        if (Mark[v] >= stamp) continue;
+        std::vector<int> levels;
+        findPseudoPeripheral(AdjPtr, Adj, v, Excluded, Mark, Stamp, levels);
+        order.insert(order.end(), levels.begin(), levels.end());
+    }
+    for (int v : Part) Excluded[v] = true;
+
+    int firstParts = NParts / 2;
+    int cut = (int)((int64_t)size * firstParts / NParts);
+    std::vector<int> first(order.begin(), order.begin() + cut);
+    std::vector<int> second(order.begin() + cut, order.end());
+    bisect(AdjPtr, Adj, first, firstParts, FirstPart, Excluded, Mark, Stamp,
+           Parts);
+    bisect(AdjPtr, Adj, second, NParts - firstParts, FirstPart + firstParts,
+           Excluded, Mark, Stamp, Parts);
+}
+
+//! Splits the vertices of a graph into parts of about the same size.
+std::vector<int> partitionGraph(const std::vector<int>& AdjPtr,
+                                const std::vector<int>& Adj, int NParts)
+{
+    int n = (int)AdjPtr.size() - 1;
+    std::vector<int> parts(n, 0);
+    if (NParts <= 1) return parts;
+
+    std::vector<int> all(n);
+    for (int v = 0; v < n; v++) {
+        all[v] = v;
+    }
+    std::vector<bool> excluded(n, true);
+    std::vector<int> mark(n, -1);
+    int stamp = 0;
+    bisect(AdjPtr, Adj, all, NParts, 0, excluded, mark, stamp, parts);
+    return parts;
+}
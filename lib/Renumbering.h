@@ -0,0 +1,78 @@
+/** \file Renumbering.h
+* Contains the declaration of functions that reorder the vertices of a graph
+* to reduce the bandwidth, profile or fill-in of the associated matrices.
+*/
+
+#ifndef RENUMBERING_H
+#define RENUMBERING_H
+
+#include <vector>
+
+//! Orders the vertices of a graph by the Reverse Cuthill-McKee algorithm.
+/*!
+Each connected component is ordered by a breadth-first search that starts
+at a pseudo-peripheral vertex and visits the neighbours of each vertex by
+increasing degree. The whole ordering is then reversed, which keeps the
+bandwidth and reduces the profile of the matrix.
+\param AdjPtr the position of the first neighbour of each vertex in Adj,
+plus the total number of neighbours.
+\param Adj the concatenated neighbours of all the vertices.
+\return the vertices in their new order: the vertex at position k is the
+k-th to be numbered.
+*/
+std::vector<int> reverseCuthillMcKee(const std::vector<int>& AdjPtr,
+                                     const std::vector<int>& Adj);
+
+//! Orders the vertices of a graph by the Approximate Minimum Degree algorithm.
+/*!
+The elimination is simulated on a quotient graph, where each eliminated
+vertex becomes an element that stands for the clique of its neighbours, so
+the fill is never stored. At each step the vertex of smallest approximate
+external degree is eliminated; the degrees are bounded from above as in
+Amestoy, Davis and Duff (1996). The ordering reduces the fill-in of a sparse
+Cholesky factorization.
+\param AdjPtr the position of the first neighbour of each vertex in Adj,
+plus the total number of neighbours.
+\param Adj the concatenated neighbours of all the vertices, without the
+vertices themselves.
+\return the vertices in their new order: the vertex at position k is the
+k-th to be numbered.
+*/
+std::vector<int> approximateMinimumDegree(const std::vector<int>& AdjPtr,
+                                          const std::vector<int>& Adj);
+
+//! Orders the vertices of a graph by nested dissection.
+/*!
+The graph is split recursively by vertex separators taken from the middle
+level of a level structure rooted at a pseudo-peripheral vertex; the
+separator of each part is numbered after both halves. Small parts are
+ordered by approximateMinimumDegree(). On plane frames the ordering gives
+less fill-in than minimum degree as the models grow.
+\param AdjPtr the position of the first neighbour of each vertex in Adj,
+plus the total number of neighbours.
+\param Adj the concatenated neighbours of all the vertices, without the
+vertices themselves.
+\return the vertices in their new order: the vertex at position k is the
+k-th to be numbered.
+*/
+std::vector<int> nestedDissection(const std::vector<int>& AdjPtr,
+                                  const std::vector<int>& Adj);
+
+//! Splits the vertices of a graph into parts of about the same size.
+/*!
+The graph is bisected recursively: each part is ordered by a level structure
+rooted at a pseudo-peripheral vertex and cut where the sizes of the two sides
+are proportional to the number of parts each one will be split into. The
+parts are connected when the graph is, and their common boundaries are
+small on meshes.
+\param AdjPtr the position of the first neighbour of each vertex in Adj,
+plus the total number of neighbours.
+\param Adj the concatenated neighbours of all the vertices, without the
+vertices themselves.
+\param NParts the number of parts.
+\return the part of each vertex, from 0 to NParts - 1.
+*/
+std::vector<int> partitionGraph(const std::vector<int>& AdjPtr,
+                                const std::vector<int>& Adj, int NParts);
+
+#endif // RENUMBERING_H
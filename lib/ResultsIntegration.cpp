@@ -0,0 +1,234 @@
+/** \file ResultsIntegration.cpp
+* Contains the definition of functions that write the results of a solved
+* structure into a binary results file or a compact text summary.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include "ResultsIntegration.h"
+
+namespace {
+
+//! The header of a binary results file.
+struct TResultsHeader {
+    char fMagic[8];
+    uint32_t fVersion;
+    uint32_t fByteOrder;
+    uint64_t fNNodes;
+    uint64_t fNElements;
+    uint32_t fNCases;
+    uint32_t fNColumns;
+    uint64_t fCaseNamesOffset;
+    uint64_t fColumnTableOffset;
+    uint64_t fReserved;
+};
+
+//! An entry of the column table of a binary results file.
+struct TResultsColumn {
+    char fName[32];
+    uint32_t fCase;
+    uint32_t fPadding;
+    uint64_t fRows;
+    uint64_t fOffset;
+};
+
+static_assert(sizeof(TResultsHeader) == 64, "The results header must have 64 bytes.");
+static_assert(sizeof(TResultsColumn) == 56, "A column entry must have 56 bytes.");
+
+const char kMagic[8] = {'J', 'S', 'T', 'A', 'T', 'R', 'E', 'S'};
+const uint32_t kByteOrderMark = 0x01020304;
+const uint64_t kAlignment = 64;
+const int kNameSize = 32;
+
+const char* const kNodeColumns[6] = {"Dx", "Dy", "Rz", "Rx", "Ry", "Mz"};
+const char* const kElementColumns[6] = {"N0", "V0", "M0", "N1", "V1", "M1"};
+
+//! Gets the name of a load case.
+std::string getCaseName(const std::vector<std::string>& CaseNames, int Case)
+{
+    if (Case < (int)CaseNames.size()) return CaseNames[Case];
+    return "Case " + std::to_string(Case);
+}
+
+//! Computes the displacements and reactions of the nodes for a load case.
+/*!
+\param Values receives six columns of NNodes values: Dx, Dy, Rz, Rx, Ry, Mz.
+*/
+void getNodeResults(TStructure* Structure, const TPZFMatrix<double>& D,
+                    const TPZFMatrix<double>& Q, int Case,
+                    std::vector<double>& Values)
+{
+    const TPZFMatrix<int>& equations = Structure->getNodeEquations();
+    int nNodes = (int)equations.Rows();
+    int UDOF = Structure->getUDOF();
+    int CDOF = Structure->getCDOF();
+    Values.assign(6 * (size_t)nNodes, 0.);
+    for (int n = 0; n < nNodes; n++) {
+        for (int k = 0; k < 3; k++) {
+            int equation = equations.GetVal(n, k);
+            if (equation < 0) continue;
+            Values[k * (size_t)nNodes + n] = D.GetVal(equation, Case);
+            // Only the constrained DOF have reactions; the interior DOF of
+            // the substructures are numbered after them.
+            if (equation >= UDOF && equation < UDOF + CDOF) {
+                Values[(3 + k) * (size_t)nNodes + n] = Q.GetVal(equation, Case);
+            }
+        }
+    }
+}
+
+//! Computes the end forces of the elements for a load case.
+/*!
+\param Values receives six columns of NElements values: N0, V0, M0, N1, V1, M1.
+*/
+void getElementResults(TStructure* Structure, int NElements, int Case,
+                       std::vector<double>& Values)
+{
+    Values.assign(6 * (size_t)NElements, 0.);
+    TPZFMatrix<double> q;
+    for (int e = 0; e < NElements; e++) {
+        Structure->getInternalLoads(e, q, Case);
+        for (int k = 0; k < 6; k++) {
+            Values[k * (size_t)NElements + e] = q(k, 0);
+        }
+    }
+}
+
+} // namespace
+
+//! Writes the results of a solved structure into a binary results file.
+void exportResults(const std::string& FileName, TStructure* Structure,
+                   const std::vector<std::string>& CaseNames)
+{
+    int nNodes = (int)Structure->getNodeEquations().Rows();
+    int nElements = (int)Structure->getElements().size();
+    int nCases = Structure->getNCases();
+    TPZFMatrix<double> D = Structure->getD();
+    TPZFMatrix<double> Q = Structure->getQ();
+
+    // Lays out the header, the case names, the column table and the values.
+    TResultsHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.fMagic, kMagic, sizeof(kMagic));
+    header.fVersion = kBinaryResultsVersion;
+    header.fByteOrder = kByteOrderMark;
+    header.fNNodes = nNodes;
+    header.fNElements = nElements;
+    header.fNCases = nCases;
+    header.fNColumns = 12 * nCases;
+    header.fCaseNamesOffset = sizeof(TResultsHeader);
+    header.fColumnTableOffset = header.fCaseNamesOffset + (uint64_t)kNameSize * nCases;
+    uint64_t offset = header.fColumnTableOffset + sizeof(TResultsColumn) * header.fNColumns;
+
+    std::vector<TResultsColumn> columns(header.fNColumns);
+    for (int c = 0; c < nCases; c++) {
+        for (int k = 0; k < 12; k++) {
+            TResultsColumn& column = columns[12 * c + k];
+            std::memset(&column, 0, sizeof(column));
+            std::strncpy(column.fName, k < 6 ? kNodeColumns[k] : kElementColumns[k - 6],
+                         kNameSize - 1);
+            column.fCase = c;
+            column.fRows = (k < 6) ? nNodes : nElements;
+            offset = (offset + kAlignment - 1) / kAlignment * kAlignment;
+            column.fOffset = offset;
+            offset += column.fRows * sizeof(double);
+        }
+    }
+
+    std::ofstream output(FileName, std::ios::binary);
+    if (!output) {
+        // Stops debug if the file cannot be created.
+        DebugStop();
+    }
+    output.write((const char*)&header, sizeof(header));
+    for (int c = 0; c < nCases; c++) {
+        char name[kNameSize] = {};
+        std::strncpy(name, getCaseName(CaseNames, c).c_str(), kNameSize - 1);
+        output.write(name, kNameSize);
+    }
+    output.write((const char*)columns.data(), sizeof(TResultsColumn) * columns.size());
+
+    // Writes the columns of each case, padding each one to its offset.
+    uint64_t written = header.fColumnTableOffset + sizeof(TResultsColumn) * header.fNColumns;
+    std::vector<double> nodeValues, elementValues;
+    for (int c = 0; c < nCases; c++) {
+        getNodeResults(Structure, D, Q, c, nodeValues);
+        getElementResults(Structure, nElements, c, elementValues);
+        for (int k = 0; k < 12; k++) {
+            static const char padding[kAlignment] = {};
+            uint64_t columnOffset = columns[12 * c + k].fOffset;
+            output.write(padding, columnOffset - written);
+            const double* values = (k < 6)
+                                       ? &nodeValues[k * (size_t)nNodes]
+                                       : &elementValues[(k - 6) * (size_t)nElements];
+            uint64_t size = columns[12 * c + k].fRows * sizeof(double);
+            output.write((const char*)values, size);
+            written = columnOffset + size;
+        }
+    }
+
+    if (!output) {
+        // Stops debug if the file could not be written.
+        DebugStop();
+    }
+}
+
+//! Prints a compact summary of the results of a solved structure.
+void printResultsSummary(std::ostream& out, TStructure* Structure,
+                         const std::vector<std::string>& CaseNames)
+{
+    int nNodes = (int)Structure->getNodeEquations().Rows();
+    int nElements = (int)Structure->getElements().size();
+    TPZFMatrix<double> D = Structure->getD();
+    TPZFMatrix<double> Q = Structure->getQ();
+
+    out << nNodes << " nodes, " << nElements << " elements, "
+        << Structure->getNDOF() << " DOF (" << Structure->getUDOF()
+        << " unconstrained)" << std::endl;
+
+    std::vector<double> nodeValues, elementValues;
+    for (int c = 0; c < Structure->getNCases(); c++) {
+        getNodeResults(Structure, D, Q, c, nodeValues);
+        getElementResults(Structure, nElements, c, elementValues);
+
+        int maxNode = 0, maxRotationNode = 0, maxElement = 0;
+        double maxDisplacement = 0., maxRotation = 0., maxMoment = 0.;
+        double sumRx = 0., sumRy = 0.;
+        for (int n = 0; n < nNodes; n++) {
+            double dx = nodeValues[n];
+            double dy = nodeValues[nNodes + n];
+            double displacement = std::sqrt(dx * dx + dy * dy);
+            if (displacement > maxDisplacement) {
+                maxDisplacement = displacement;
+                maxNode = n;
+            }
+            double rotation = std::fabs(nodeValues[2 * (size_t)nNodes + n]);
+            if (rotation > maxRotation) {
+                maxRotation = rotation;
+                maxRotationNode = n;
+            }
+            sumRx += nodeValues[3 * (size_t)nNodes + n];
+            sumRy += nodeValues[4 * (size_t)nNodes + n];
+        }
+        for (int e = 0; e < nElements; e++) {
+            double moment = std::max(std::fabs(elementValues[2 * (size_t)nElements + e]),
+                                     std::fabs(elementValues[5 * (size_t)nElements + e]));
+            if (moment > maxMoment) {
+                maxMoment = moment;
+                maxElement = e;
+            }
+        }
+
+        out << getCaseName(CaseNames, c) << ":" << std::endl;
+        out << "  max displacement " << maxDisplacement << " at node " << maxNode
+            << std::endl;
+        out << "  max rotation " << maxRotation << " at node " << maxRotationNode
+            << std::endl;
+        out << "  sum of reactions Rx " << sumRx << ", Ry " << sumRy << std::endl;
+        out << "  max end moment " << maxMoment << " at element " << maxElement
+            << std::endl;
+    }
+}
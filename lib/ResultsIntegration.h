@@ -0,0 +1,50 @@
+/** \file ResultsIntegration.h
+* Contains the declaration of functions that write the results of a solved
+* structure into a binary results file or a compact text summary.
+*/
+
+#ifndef RESULTSINTEGRATION_H
+#define RESULTSINTEGRATION_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TStructure.h"
+
+//! The version of the binary results format written by exportResults.
+const unsigned kBinaryResultsVersion = 1;
+
+//! Writes the results of a solved structure into a binary results file.
+/*!
+The file starts with a 64-byte header: the magic "JSTATRES", the format
+version, a byte order mark, the number of nodes, elements, load cases and
+columns, and the offsets of the case names and of the column table. Each
+load case has a 32-byte name. Each column has a 56-byte entry (a 32-byte
+name, its load case, its number of rows and its offset) and its values are
+stored as a contiguous float64 array aligned to 64 bytes. For each load
+case, the columns are:
+- "Dx", "Dy", "Rz": the displacements of each node;
+- "Rx", "Ry", "Mz": the support reactions of each node, zero where the
+  direction is free;
+- "N0", "V0", "M0", "N1", "V1", "M1": the end forces of each element, in
+  its local axes.
+\param FileName the path of the file to be written.
+\param Structure the pointer to the solved TStructure object.
+\param CaseNames the name of each load case; missing names are written as
+"Case <n>".
+*/
+void exportResults(const std::string& FileName, TStructure* Structure,
+                   const std::vector<std::string>& CaseNames = {});
+
+//! Prints a compact summary of the results of a solved structure.
+/*!
+For each load case, prints the largest displacement and rotation, the sum
+of the support reactions and the largest end moment of the elements.
+\param out the stream the summary is printed to.
+\param Structure the pointer to the solved TStructure object.
+\param CaseNames the name of each load case.
+*/
+void printResultsSummary(std::ostream& out, TStructure* Structure,
+                         const std::vector<std::string>& CaseNames = {});
+
+#endif // RESULTSINTEGRATION_H
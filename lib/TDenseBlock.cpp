@@ -0,0 +1,60 @@
+/** \file TDenseBlock.cpp
+* Contains the definitions of the TDenseBlock methods.
+*/
+
+#include "TDenseBlock.h"
+
+//! Default constructor.
+TDenseBlock::TDenseBlock(const TPZFMatrix<double>* Matrix, int Row0, int Rows)
+    : fMatrix(Matrix),
+      fRow0(Row0),
+      fRows(Rows) {}
+
+//! Constructor that views a whole matrix.
+TDenseBlock::TDenseBlock(const TPZFMatrix<double>& Matrix)
+    : fMatrix(&Matrix),
+      fRow0(0),
+      fRows((int)Matrix.Rows()) {}
+
+//! Gets the number of rows of the block.
+int TDenseBlock::Rows() const
+{
+    return fRows;
+}
+
+//! Gets the number of columns of the block.
+int TDenseBlock::Cols() const
+{
+    return (fMatrix == nullptr) ? 0 : (int)fMatrix->Cols();
+}
+
+//! Gets an entry of the block.
+double TDenseBlock::Get(int Row, int Col) const
+{
+    return fMatrix->Get(fRow0 + Row, Col);
+}
+
+//! Gets an entry of the first column of the block.
+double TDenseBlock::operator[](int Row) const
+{
+    return fMatrix->Get(fRow0 + Row, 0);
+}
+
+//! Copies the block into a new matrix.
+TPZFMatrix<double> TDenseBlock::toDense() const
+{
+    TPZFMatrix<double> dense(fRows, this->Cols(), 0);
+
+    for (int j = 0; j < this->Cols(); j++) {
+        for (int i = 0; i < fRows; i++) {
+            dense(i, j) = this->Get(i, j);
+        }
+    }
+    return dense;
+}
+
+//! Prints the block to a stream.
+void TDenseBlock::Print(std::ostream& out) const
+{
+    this->toDense().Print(out);
+}
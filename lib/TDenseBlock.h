@@ -0,0 +1,87 @@
+/** \file TDenseBlock.h
+* Contains the declaration of the TDenseBlock class.
+*/
+
+#ifndef TDENSEBLOCK_H
+#define TDENSEBLOCK_H
+
+#include <iostream>
+#include "pzfmatrix.h"
+
+//!  A class that implements a read-only view of a range of rows of a matrix.
+/*!
+     A class that implements a non-owning, read-only view of the rows
+	 [Row0, Row0 + Rows) of a TPZFMatrix<double> object, spanning all of its
+	 columns. It is used to access the known and unknown parts of the load
+	 and displacement vectors without copying them. The view is only valid
+	 while the viewed matrix is alive and keeps its dimensions.
+*/
+class TDenseBlock
+{
+public:
+    //! Default constructor.
+    /*!
+    \param Matrix a pointer to the viewed matrix.
+    \param Row0 the first row of the block.
+    \param Rows the number of rows of the block.
+    \return the new TDenseBlock object.
+    */
+    TDenseBlock(const TPZFMatrix<double>* Matrix = nullptr, int Row0 = 0,
+                int Rows = 0);
+
+    //! Constructor that views a whole matrix.
+    /*!
+    \param Matrix the viewed matrix.
+    \return the new TDenseBlock object.
+    */
+    TDenseBlock(const TPZFMatrix<double>& Matrix);
+
+    //! Gets the number of rows of the block.
+    /*!
+    \return the number of rows of the block.
+    */
+    int Rows() const;
+
+    //! Gets the number of columns of the block.
+    /*!
+    \return the number of columns of the block.
+    */
+    int Cols() const;
+
+    //! Gets an entry of the block.
+    /*!
+    \param Row the row of the entry, relative to the block.
+    \param Col the column of the entry.
+    \return the entry value.
+    */
+    double Get(int Row, int Col) const;
+
+    //! Gets an entry of the first column of the block.
+    /*!
+    \param Row the row of the entry, relative to the block.
+    \return the entry value.
+    */
+    double operator[](int Row) const;
+
+    //! Copies the block into a new matrix.
+    /*!
+    \return a matrix with the entries of the block.
+    */
+    TPZFMatrix<double> toDense() const;
+
+    //! Prints the block to a stream.
+    /*!
+    \param out the stream the block is printed to.
+    */
+    void Print(std::ostream& out) const;
+
+private:
+    //! A pointer to the viewed matrix.
+    const TPZFMatrix<double>* fMatrix;
+    //! The first row of the block.
+    int fRow0;
+    //! The number of rows of the block.
+    int fRows;
+};
+
+#endif // TDENSEBLOCK_H
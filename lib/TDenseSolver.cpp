@@ -0,0 +1,42 @@
+/** \file TDenseSolver.cpp
+* Contains the definitions of the TDenseSolver methods.
+*/
+
+#include "TDenseSolver.h"
+
+//! Default constructor.
+TDenseSolver::TDenseSolver() {}
+
+//! Creates a copy of the solver, including its factorization.
+TLinearSolver* TDenseSolver::clone() const
+{
+    return new TDenseSolver(*this);
+}
+
+//! Gets the type of the solver.
+ESolverType TDenseSolver::getType() const
+{
+    return EDenseCholesky;
+}
+
+//! Factorizes a symmetric matrix and stores its factors.
+void TDenseSolver::factorize(const TSparseBlock& K)
+{
+    // K11 is symmetric positive definite for a stable structure.
+    fFactor = K.toDense();
+    fFactor.Decompose_Cholesky();
+}
+
+//! Solves the factorized system for one or more right-hand sides.
+void TDenseSolver::solve(TPZFMatrix<double>& F) const
+{
+    fFactor.Subst_Forward(&F);
+    fFactor.Subst_Backward(&F);
+}
+
+//! Gets the number of entries of the triangular factor.
+int64_t TDenseSolver::getFactorSize() const
+{
+    int64_t n = fFactor.Rows();
+    return n * (n + 1) / 2;
+}
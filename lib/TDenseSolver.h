@@ -0,0 +1,42 @@
+/** \file TDenseSolver.h
+* Contains the declaration of the TDenseSolver class.
+*/
+
+#ifndef TDENSESOLVER_H
+#define TDENSESOLVER_H
+
+#include "TLinearSolver.h"
+
+//!  A class that solves K11 * Du = F by a dense Cholesky factorization.
+/*!
+     A class that solves K11 * Du = F by a dense Cholesky factorization.
+	 The matrix is copied into a dense TPZFMatrix<double>, which is then
+	 factorized in place.
+*/
+class TDenseSolver : public TLinearSolver
+{
+public:
+    //! Default constructor.
+    TDenseSolver();
+
+    //! Creates a copy of the solver, including its factorization.
+    TLinearSolver* clone() const override;
+
+    //! Gets the type of the solver.
+    ESolverType getType() const override;
+
+    //! Factorizes a symmetric matrix and stores its factors.
+    void factorize(const TSparseBlock& K) override;
+
+    //! Solves the factorized system for one or more right-hand sides.
+    void solve(TPZFMatrix<double>& F) const override;
+
+    //! Gets the number of entries of the triangular factor.
+    int64_t getFactorSize() const override;
+
+private:
+    //! The Cholesky factor of the matrix.
+    TPZFMatrix<double> fFactor;
+};
+
+#endif // TDENSESOLVER_H
@@ -92,20 +92,21 @@ void TDistributedLoad::setStructure(TStructure* Structure)
     fStructure = Structure;
 }
 
-//! Adds the effects of the distributed load to the initial load vector Q0.
-void TDistributedLoad::store()
+//! Computes the initial (fixed-end) loads of the element, in local coordinates.
+TElementVector TDistributedLoad::getLocalQ0()
 {
     // Gets required element data.
-    double lx = fStructure->getElement(this->fElementID).getCos();
-    double L = fStructure->getElement(this->fElementID).getL();
+    const TElement& element = fStructure->getElementAddress(this->fElementID);
+    double lx = element.getCos();
+    double L = element.getL();
     double node0Load = fNode0Load;
     double node1Load = fNode1Load;
 
-    TPZFMatrix<double> Q0(6, 1, 0);
+    TElementVector Q0;
     if (fLoadPlane == true)
     {
         // If the load plane is the global plane.
-        double ly = fStructure->getElement(this->fElementID).getSin();
+        double ly = element.getSin();
         Q0(0, 0) -= ly * (7 * node0Load + 3 * node1Load) * L / 20;
         Q0(1, 0) -= lx * (7 * node0Load + 3 * node1Load) * L / 20;
         Q0(2, 0) -= lx * ((node0Load / 20) + (node1Load / 30)) * L * L;
@@ -122,7 +123,13 @@ void TDistributedLoad::store()
         Q0(5, 0) += ((node0Load / 30) + (node1Load / 20)) * L * L;
     }
 
-    fStructure->getElementAddress(this->fElementID).setQ0(Q0);
+    return Q0;
+}
+
+//! Adds the effects of the distributed load to the initial load vector Q0.
+void TDistributedLoad::store()
+{
+    fStructure->getElementAddress(this->fElementID).setQ0(this->getLocalQ0());
 }
 
 //! Prints the load information to std::cout.
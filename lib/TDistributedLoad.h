@@ -6,6 +6,7 @@
 #define TDISTRIBUTEDLOAD_H
 
 #include <iostream>
+#include "TFixedMatrix.h"
 
 // Forward declaration to TStructure class.
 class TStructure;
@@ -103,6 +104,12 @@ public:
     */
     void setStructure(TStructure* Structure);
 
+    //! Computes the initial (fixed-end) loads of the element, in local coordinates.
+    /*!
+    \return the 6x1 vector of initial loads caused by the distributed load.
+    */
+    TElementVector getLocalQ0();
+
     //! Adds the effects of the distributed load to the initial load vector Q0.
     void store();
 
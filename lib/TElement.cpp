@@ -4,6 +4,7 @@
 
 #include "TStructure.h"
 #include "TElement.h"
+#include "ElementKernels.h"
 
 //! Default constructor.
 TElement::TElement(TStructure *Structure, const int Node0ID, const int Node1ID,
@@ -21,7 +22,14 @@ TElement::TElement(TStructure *Structure, const int Node0ID, const int Node1ID,
     fEquations[3] = -1;
     fEquations[4] = -1;
     fEquations[5] = -1;
-    fQ0 = TPZFMatrix<double>(6, 1, 0);
+    fQ0.zero();
+    fHasGeometry = false;
+    fL = 0;
+    fCos = 0;
+    fSin = 0;
+    fInvL = 0;
+    fInvL2 = 0;
+    fInvL3 = 0;
 }
 
 //! Copy constructor.
@@ -40,6 +48,13 @@ TElement::TElement(const TElement& Other)
     fEquations[4] = Other.fEquations[4];
     fEquations[5] = Other.fEquations[5];
     fQ0 = Other.fQ0;
+    fHasGeometry = Other.fHasGeometry;
+    fL = Other.fL;
+    fCos = Other.fCos;
+    fSin = Other.fSin;
+    fInvL = Other.fInvL;
+    fInvL2 = Other.fInvL2;
+    fInvL3 = Other.fInvL3;
 }
 
 //! Destructor.
@@ -62,6 +77,13 @@ TElement& TElement::operator=(const TElement& Other)
         fEquations[4] = Other.fEquations[4];
         fEquations[5] = Other.fEquations[5];
         fQ0 = Other.fQ0;
+        fHasGeometry = Other.fHasGeometry;
+        fL = Other.fL;
+        fCos = Other.fCos;
+        fSin = Other.fSin;
+        fInvL = Other.fInvL;
+        fInvL2 = Other.fInvL2;
+        fInvL3 = Other.fInvL3;
     }
     return *this;
 }
@@ -166,68 +188,111 @@ void TElement::setEquations(int Eq0, int Eq1, int Eq2,
 //! Gets the x coordinate of the element Node 0.
 double TElement::getX0() const
 {
-    TNode node = fStructure->getNodes()[fLocalNodesIDs[0]];
-    return node.getX();
+    return fStructure->getNode(fLocalNodesIDs[0]).getX();
 }
 
 //! Gets the y coordinate of the element Node 0.
 double TElement::getY0() const
 {
-    TNode node = fStructure->getNodes()[fLocalNodesIDs[0]];
-    return node.getY();
+    return fStructure->getNode(fLocalNodesIDs[0]).getY();
 }
 
 //! Gets the x coordinate of the element Node 1.
 double TElement::getX1() const
 {
-    TNode node = fStructure->getNodes()[fLocalNodesIDs[1]];
-    return node.getX();
+    return fStructure->getNode(fLocalNodesIDs[1]).getX();
 }
 
 //! Gets the y coordinate of the element Node 1.
 double TElement::getY1() const
 {
-    TNode node = fStructure->getNodes()[fLocalNodesIDs[1]];
-    return node.getY();
+    return fStructure->getNode(fLocalNodesIDs[1]).getY();
 }
 
 //! Gets the length of the element.
 double TElement::getL() const
 {
-    double x0 = this->getX0();
-    double y0 = this->getY0();
-    double x1 = this->getX1();
-    double y1 = this->getY1();
-    double length = sqrt((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+    if (fHasGeometry) return fL;
+
+    double dx = this->getX1() - this->getX0();
+    double dy = this->getY1() - this->getY0();
+    double length = sqrt(dx * dx + dy * dy);
     return (length);
 }
 
 //! Gets the cosine of the element angle.
 double TElement::getCos() const
 {
-    double x0 = this->getX0();
-    double y0 = this->getY0();
-    double x1 = this->getX1();
-    double y1 = this->getY1();
-    double cos = (x1 - x0) / sqrt((x1- x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+    if (fHasGeometry) return fCos;
+
+    double dx = this->getX1() - this->getX0();
+    double dy = this->getY1() - this->getY0();
+    double cos = dx / sqrt(dx * dx + dy * dy);
     return (cos);
 }
 
 //! Gets the sine of the element angle.
 double TElement::getSin() const
 {
-    double x0 = this->getX0();
-    double y0 = this->getY0();
-    double x1 = this->getX1();
-    double y1 = this->getY1();
-    double sin = (y1 - y0) / sqrt((x1- x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+    if (fHasGeometry) return fSin;
+
+    double dx = this->getX1() - this->getX0();
+    double dy = this->getY1() - this->getY0();
+    double sin = dy / sqrt(dx * dx + dy * dy);
     return (sin);
 }
 
+//! Gets the inverse of the element length.
+double TElement::getInvL() const
+{
+    if (fHasGeometry) return fInvL;
+    return 1. / this->getL();
+}
+
+//! Gets the inverse of the squared element length.
+double TElement::getInvL2() const
+{
+    if (fHasGeometry) return fInvL2;
+    double invL = 1. / this->getL();
+    return invL * invL;
+}
+
+//! Gets the inverse of the cubed element length.
+double TElement::getInvL3() const
+{
+    if (fHasGeometry) return fInvL3;
+    double invL = 1. / this->getL();
+    return invL * invL * invL;
+}
+
+//! Computes and stores the length, cosine and sine of the element.
+void TElement::updateGeometry()
+{
+    // Reads the node coordinates only once.
+    const TNode& node0 = fStructure->getNode(fLocalNodesIDs[0]);
+    const TNode& node1 = fStructure->getNode(fLocalNodesIDs[1]);
+    double dx = node1.getX() - node0.getX();
+    double dy = node1.getY() - node0.getY();
+
+    fL = sqrt(dx * dx + dy * dy);
+    fInvL = 1. / fL;
+    fInvL2 = fInvL * fInvL;
+    fInvL3 = fInvL2 * fInvL;
+    fCos = dx * fInvL;
+    fSin = dy * fInvL;
+    fHasGeometry = true;
+}
+
+//! Marks the stored geometry of the element as outdated.
+void TElement::invalidateGeometry()
+{
+    fHasGeometry = false;
+}
+
 //! Gets the transformation matrix of the element.
-TPZFMatrix<double> TElement::getT() const
+TElementMatrix TElement::getT() const
 {
-    TPZFMatrix<double> T(6, 6, 0);
+    TElementMatrix T;
     double lx = this->getCos();
     double ly = this->getSin();
 
@@ -246,9 +311,9 @@ TPZFMatrix<double> TElement::getT() const
 }
 
 //! Gets the transposed transformation matrix of the element.
-TPZFMatrix<double> TElement::getTT() const
+TElementMatrix TElement::getTT() const
 {
-    TPZFMatrix<double> TT(6, 6, 0);
+    TElementMatrix TT;
     double lx = this->getCos();
     double ly = this->getSin();
 
@@ -267,113 +332,77 @@ TPZFMatrix<double> TElement::getTT() const
 }
 
 //! Gets the global stiffness matrix of the element.
-TPZFMatrix<double> TElement::getK() const
+TElementMatrix TElement::getK() const
 {
-    TMaterial material = fStructure->getMaterials()[fMaterialID];
-    double E = material.getE();
-    double A = material.getA();
-    double I = material.getI();
+    const TMaterial& material = fStructure->getMaterial(fMaterialID);
     double L = this->getL();
     double lx = this->getCos();
     double ly = this->getSin();
+    double E = material.getE();
+    double A = material.getA();
+    double I = material.getI();
 
-    TPZFMatrix<double> K(6, 6, 0);
-
-    // Fills K.
-    K(0, 0) = (A * E / L * (lx * lx) + 12 * E * I * (ly * ly) / (L * L * L));
-    K(0, 1) = (A * E / L - 12 * E * I / (L * L * L)) * (lx * ly);
-    K(0, 2) = -(6 * E * I / (L * L)) * ly;
-    K(0, 3) = -(A * E / L * (lx * lx) + 12 * E * I * (ly * ly) / (L * L * L));
-    K(0, 4) = -(A * E / L - 12 * E * I / (L * L * L)) * (lx * ly);
-    K(0, 5) = -(6 * E * I / (L * L)) * ly;
-
-    K(1, 0) = (A * E / L - 12 * E * I / (L * L * L)) * (lx * ly);
-    K(1, 1) = (A * E / L * (ly * ly) + 12 * E * I * (lx * lx) / (L * L * L));
-    K(1, 2) = (6 * E * I / (L * L)) * lx;
-    K(1, 3) = -(A * E / L - 12 * E * I / (L * L * L)) * (lx * ly);
-    K(1, 4) = -(A * E / L * (ly * ly) + 12 * E * I * (lx * lx) / (L * L * L));
-    K(1, 5) = (6 * E * I / (L * L)) * lx;
-
-    K(2, 0) = -(6 * E * I / (L * L)) * ly;
-    K(2, 1) = (6 * E * I / (L * L)) * lx;
-    K(2, 2) = (4 * E * I / (L));
-    K(2, 3) = (6 * E * I / (L * L)) * ly;
-    K(2, 4) = -(6 * E * I / (L * L)) * lx;
-    K(2, 5) = (2 * E * I / (L));
-
-    K(3, 0) = -(A * E / L * (lx * lx) + 12 * E * I * (ly * ly) / (L * L * L));
-    K(3, 1) = -(A * E / L - 12 * E * I / (L * L * L)) * (lx * ly);
-    K(3, 2) = (6 * E * I / (L * L)) * ly;
-    K(3, 3) = (A * E / L * (lx * lx) + 12 * E * I * (ly * ly) / (L * L * L));
-    K(3, 4) = (A * E / L - 12 * E * I / (L * L * L)) * (lx * ly);
-    K(3, 5) = (6 * E * I / (L * L)) * ly;
-
-    K(4, 0) = -(A * E / L - 12 * E * I / (L * L * L)) * (lx * ly);
-    K(4, 1) = -(A * E / L * (ly * ly) + 12 * E * I * (lx * lx) / (L * L * L));
-    K(4, 2) = -(6 * E * I / (L * L)) * lx;
-    K(4, 3) = (A * E / L - 12 * E * I / (L * L * L)) * (lx * ly);
-    K(4, 4) = (A * E / L * (ly * ly) + 12 * E * I * (lx * lx) / (L * L * L));
-    K(4, 5) = -(6 * E * I / (L * L)) * lx;
-
-    K(5, 0) = -(6 * E * I / (L * L)) * ly;
-    K(5, 1) = (6 * E * I / (L * L)) * lx;
-    K(5, 2) = (2 * E * I / (L));
-    K(5, 3) = (6 * E * I / (L * L)) * ly;
-    K(5, 4) = -(6 * E * I / (L * L)) * lx;
-    K(5, 5) = (4 * E * I / (L));
-
-    return K;
+    // Uses the same kernel as the batched assembly of TStructure.
+    double upper[kElementKEntries];
+    computeElementsK(1, &L, &lx, &ly, &E, &A, &I, upper);
+
+    return unpackElementK(upper, 1);
 }
 
 //! Gets the local stiffness matrix of the element.
-TPZFMatrix<double> TElement::getLocalK() const
+TElementMatrix TElement::getLocalK() const
 {
-    TMaterial material = fStructure->getMaterials()[fMaterialID];
+    const TMaterial& material = fStructure->getMaterial(fMaterialID);
     double E = material.getE();
     double A = material.getA();
     double I = material.getI();
-    double L = this->getL();
 
-    TPZFMatrix<double> localK(6, 6, 0);
+    // Stiffness terms shared by several entries of localK.
+    double EA_L = E * A * this->getInvL();
+    double EI_L = E * I * this->getInvL();
+    double EI_L2 = E * I * this->getInvL2();
+    double EI_L3 = E * I * this->getInvL3();
+
+    TElementMatrix localK;
 
     // Fills localK.
-    localK(0, 0) = A * E / L;
-    localK(0, 3) = -A * E / L;
+    localK(0, 0) = EA_L;
+    localK(0, 3) = -EA_L;
 
-    localK(1, 1) = 12 * E * I / (L * L * L);
-    localK(1, 2) = 6 * E * I / (L * L);
-    localK(1, 4) = -12 * E * I / (L * L * L);
-    localK(1, 5) = 6 * E * I / (L * L);
+    localK(1, 1) = 12 * EI_L3;
+    localK(1, 2) = 6 * EI_L2;
+    localK(1, 4) = -12 * EI_L3;
+    localK(1, 5) = 6 * EI_L2;
 
-    localK(2, 1) = 6 * E * I / (L * L);
-    localK(2, 2) = 4 * E * I / L;
-    localK(2, 4) = -6 * E * I / (L * L);
-    localK(2, 5) = 2 * E * I / L;
+    localK(2, 1) = 6 * EI_L2;
+    localK(2, 2) = 4 * EI_L;
+    localK(2, 4) = -6 * EI_L2;
+    localK(2, 5) = 2 * EI_L;
 
-    localK(3, 0) = -A * E / L;
-    localK(3, 3) = A * E / L;
+    localK(3, 0) = -EA_L;
+    localK(3, 3) = EA_L;
 
-    localK(4, 1) = -12 * E * I / (L * L * L);
-    localK(4, 2) = -6 * E * I / (L * L);
-    localK(4, 4) = 12 * E * I / (L * L * L);
-    localK(4, 5) = -6 * E * I / (L * L);
+    localK(4, 1) = -12 * EI_L3;
+    localK(4, 2) = -6 * EI_L2;
+    localK(4, 4) = 12 * EI_L3;
+    localK(4, 5) = -6 * EI_L2;
 
-    localK(5, 1) = 6 * E * I / (L * L);
-    localK(5, 2) = 2 * E * I / L;
-    localK(5, 4) = -6 * E * I / (L * L);
-    localK(5, 5) = 4 * E * I / L;
+    localK(5, 1) = 6 * EI_L2;
+    localK(5, 2) = 2 * EI_L;
+    localK(5, 4) = -6 * EI_L2;
+    localK(5, 5) = 4 * EI_L;
 
     return localK;
 }
 
 //! Gets the vector of initial (intermediate) loads Q0 of the element.
-TPZFMatrix<double> TElement::getQ0() const
+const TElementVector& TElement::getQ0() const
 {
     return fQ0;
 }
 
 //! Modifies the vector of initial (intermediate) loads Q0 of the element.
-void TElement::setQ0(TPZFMatrix<double> Q0)
+void TElement::setQ0(const TElementVector& Q0)
 {
     fQ0 = Q0;
 }
@@ -8,6 +8,7 @@
 #include <iostream>
 #include <math.h>
 #include "pzfmatrix.h"
+#include "TFixedMatrix.h"
 #include "TNode.h"
 #include "TMaterial.h"
 
@@ -192,41 +193,69 @@ public:
     */
     double getSin() const;
 
+    //! Gets the inverse of the element length.
+    /*!
+    \return 1/L, where L is the length of the element.
+    */
+    double getInvL() const;
+
+    //! Gets the inverse of the squared element length.
+    /*!
+    \return 1/L^2, where L is the length of the element.
+    */
+    double getInvL2() const;
+
+    //! Gets the inverse of the cubed element length.
+    /*!
+    \return 1/L^3, where L is the length of the element.
+    */
+    double getInvL3() const;
+
+    //! Computes and stores the length, cosine and sine of the element.
+    /*!
+    While the stored values are valid, the geometric getters return them
+    instead of reading the node coordinates again.
+    */
+    void updateGeometry();
+
+    //! Marks the stored geometry of the element as outdated.
+    void invalidateGeometry();
+
     //! Gets the transformation matrix of the element.
     /*!
     \return the transformation matrix of the element.
     */
-    TPZFMatrix<double> getT() const;
+    TElementMatrix getT() const;
 
     //! Gets the transposed transformation matrix of the element.
     /*!
     \return the transposed form of the transformation matrix of the element.
     */
-    TPZFMatrix<double> getTT() const;
+    TElementMatrix getTT() const;
 
     //! Gets the global stiffness matrix of the element.
     /*!
     \return the stiffness matrix of the element in global coordinates.
     */
-    TPZFMatrix<double> getK() const;
+    TElementMatrix getK() const;
 
     //! Gets the local stiffness matrix of the element.
     /*!
     \return the stiffness matrix of the element in local coordinates.
     */
-    TPZFMatrix<double> getLocalK() const;
+    TElementMatrix getLocalK() const;
 
     //! Gets the vector of initial (intermediate) loads Q0 of the element.
     /*!
     \return the vector of initial (intermediate) loads Q0 of the element.
     */
-    TPZFMatrix<double> getQ0() const;
+    const TElementVector& getQ0() const;
 
     //! Modifies the vector of initial (intermediate) loads Q0 of the element.
     /*!
     \param Q0 the new vector of initial (intermediate) loads of the element.
     */
-    void setQ0(TPZFMatrix<double> Q0);
+    void setQ0(const TElementVector& Q0);
 
     //! Prints the element information to std::cout.
     void print();
@@ -242,8 +271,22 @@ private:
     int fMaterialID;
     //! An int array containing the element equations (degrees of freedom).
     int fEquations[6];
-    //! A TPZFMatrix<double> with the initial load vector of the element.
-    TPZFMatrix<double> fQ0;
+    //! A TElementVector with the initial load vector of the element.
+    TElementVector fQ0;
+    //! A bool that marks if the stored geometry below is up to date.
+    bool fHasGeometry;
+    //! The stored length of the element.
+    double fL;
+    //! The stored cosine of the element angle.
+    double fCos;
+    //! The stored sine of the element angle.
+    double fSin;
+    //! The stored inverse of the element length.
+    double fInvL;
+    //! The stored inverse of the squared element length.
+    double fInvL2;
+    //! The stored inverse of the cubed element length.
+    double fInvL3;
 };
 
 #endif // TELEMENT_H
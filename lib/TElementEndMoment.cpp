@@ -78,7 +78,7 @@ void TElementEndMoment::setStructure(TStructure* Structure)
 }
 
 //! Adds the effects of the nodal load to the vector of loads.
-void TElementEndMoment::store(TPZFMatrix<double>& Q)
+void TElementEndMoment::store(TPZFMatrix<double>& Q, int Case)
 {
     int nodeID;
 
@@ -95,10 +95,10 @@ void TElementEndMoment::store(TPZFMatrix<double>& Q)
         DebugStop();
     }
 
-    int mDOF = fStructure->getNodeEquations()(nodeID, 2);
+    int mDOF = fStructure->getNodeEquation(nodeID, 2);
     if (mDOF != -1) {
         // Adds the moment load if the node is not hinged.
-        Q(mDOF, 0) += this->fM;
+        Q(mDOF, Case) += this->fM;
     }
 }
 
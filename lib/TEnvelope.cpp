@@ -0,0 +1,153 @@
+/** \file TEnvelope.cpp
+* Contains the definitions of the TEnvelope methods.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include "TEnvelope.h"
+#include "Parallel.h"
+
+//! Computes the envelope of the entries [First, Last) of a result.
+/*!
+\param First the first entry.
+\param Last the entry after the last one.
+\param Factors the factor of each load case (row) in each combination (column),
+stored by rows.
+\param NCases the number of load cases.
+\param NCombinations the number of combinations.
+\param Value the function that gets an entry of the result of a load case.
+\param Min the array that receives the minimum of each entry.
+\param Max the array that receives the maximum of each entry.
+*/
+static void envelopeRange(int First, int Last, const std::vector<double>& Factors,
+                          int NCases, int NCombinations,
+                          const std::function<double(int, int)>& Value,
+                          double* Min, double* Max)
+{
+    std::vector<double> combined(NCombinations);
+
+    for (int i = First; i < Last; i++) {
+        // Computes the entry for all the combinations at once.
+        std::fill(combined.begin(), combined.end(), 0.);
+        for (int c = 0; c < NCases; c++) {
+            double value = Value(c, i);
+            if (value == 0.) continue;
+            const double* factors = &Factors[(int64_t)c * NCombinations];
+            for (int k = 0; k < NCombinations; k++) {
+                combined[k] += factors[k] * value;
+            }
+        }
+
+        Min[i] = *std::min_element(combined.begin(), combined.end());
+        Max[i] = *std::max_element(combined.begin(), combined.end());
+    }
+}
+
+//! Default constructor.
+TEnvelope::TEnvelope() {}
+
+//! Copy constructor.
+TEnvelope::TEnvelope(const TEnvelope& Other)
+    : fMin(Other.fMin),
+      fMax(Other.fMax) {}
+
+//! Destructor.
+TEnvelope::~TEnvelope() {}
+
+//! Assignment operator.
+TEnvelope& TEnvelope::operator=(const TEnvelope& Other)
+{
+    if (this != &Other) {
+        fMin = Other.fMin;
+        fMax = Other.fMax;
+    }
+    return *this;
+}
+
+//! Computes the envelopes of a set of load combinations.
+void TEnvelope::compute(const std::vector<TLoadCaseResult>& Results,
+                        const std::vector<TLoadCombination>& Combinations,
+                        int NThreads)
+{
+    int nCases = Results.size();
+    int nCombinations = Combinations.size();
+    if (nCases == 0 || nCombinations == 0) {
+        // Stops debug if there is nothing to be enveloped.
+        DebugStop();
+    }
+
+    // Factor of each load case in each combination, zero if it is absent.
+    std::vector<double> factors((int64_t)nCases * nCombinations, 0.);
+    for (int k = 0; k < nCombinations; k++) {
+        const std::vector<int>& cases = Combinations[k].getCases();
+        const std::vector<double>& caseFactors = Combinations[k].getFactors();
+        for (int j = 0; j < (int)cases.size(); j++) {
+            if (cases[j] < 0 || cases[j] >= nCases) {
+                // Stops debug if a combination refers to a missing load case.
+                DebugStop();
+            }
+            factors[(int64_t)cases[j] * nCombinations + k] += caseFactors[j];
+        }
+    }
+
+    int NDOF = Results[0].getD().Rows();
+    int nElements = Results[0].getInternalLoads().size();
+
+    // Displacements and loads, split among threads by equations.
+    std::vector<double> minD(NDOF), maxD(NDOF), minQ(NDOF), maxQ(NDOF);
+    std::function<double(int, int)> valueD = [&Results](int c, int i) {
+        return Results[c].getD().GetVal(i, 0);
+    };
+    std::function<double(int, int)> valueQ = [&Results](int c, int i) {
+        return Results[c].getQ().GetVal(i, 0);
+    };
+    parallelFor(0, NDOF, NThreads, [&](int First, int Last) {
+        envelopeRange(First, Last, factors, nCases, nCombinations, valueD,
+                      minD.data(), maxD.data());
+        envelopeRange(First, Last, factors, nCases, nCombinations, valueQ,
+                      minQ.data(), maxQ.data());
+    });
+
+    // Internal loads, split among threads by elements.
+    std::vector<double> minLoads(6 * nElements), maxLoads(6 * nElements);
+    std::function<double(int, int)> valueLoads = [&Results](int c, int i) {
+        return Results[c].getInternalLoads()[i / 6].GetVal(i % 6, 0);
+    };
+    parallelFor(0, nElements, NThreads, [&](int First, int Last) {
+        envelopeRange(6 * First, 6 * Last, factors, nCases, nCombinations,
+                      valueLoads, minLoads.data(), maxLoads.data());
+    });
+
+    // Stores the envelopes as results.
+    TPZFMatrix<double> D0(NDOF, 1, 0), D1(NDOF, 1, 0);
+    TPZFMatrix<double> Q0(NDOF, 1, 0), Q1(NDOF, 1, 0);
+    for (int i = 0; i < NDOF; i++) {
+        D0(i, 0) = minD[i];
+        D1(i, 0) = maxD[i];
+        Q0(i, 0) = minQ[i];
+        Q1(i, 0) = maxQ[i];
+    }
+    std::vector<TPZFMatrix<double>> loads0(nElements, TPZFMatrix<double>(6, 1, 0));
+    std::vector<TPZFMatrix<double>> loads1(nElements, TPZFMatrix<double>(6, 1, 0));
+    for (int e = 0; e < nElements; e++) {
+        for (int j = 0; j < 6; j++) {
+            loads0[e](j, 0) = minLoads[6 * e + j];
+            loads1[e](j, 0) = maxLoads[6 * e + j];
+        }
+    }
+    fMin = TLoadCaseResult("min", D0, Q0, loads0);
+    fMax = TLoadCaseResult("max", D1, Q1, loads1);
+}
+
+//! Gets the minimum envelope.
+const TLoadCaseResult& TEnvelope::getMin() const
+{
+    return fMin;
+}
+
+//! Gets the maximum envelope.
+const TLoadCaseResult& TEnvelope::getMax() const
+{
+    return fMax;
+}
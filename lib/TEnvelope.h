@@ -0,0 +1,73 @@
+/** \file TEnvelope.h
+* Contains the declaration of the TEnvelope class.
+*/
+
+#ifndef TENVELOPE_H
+#define TENVELOPE_H
+
+#include <iostream>
+#include <vector>
+#include "TLoadCaseResult.h"
+#include "TLoadCombination.h"
+
+//!  A class that implements the envelope of a set of load combinations.
+/*!
+     A class that implements the minimum and maximum envelopes of the
+	 results of a set of load combinations: for each displacement, load and
+	 element internal load, the smallest and largest value among all the
+	 combinations. The combined values are computed from the results of the
+	 load cases as needed, without storing the results of each combination.
+*/
+class TEnvelope {
+public:
+    //! Default constructor.
+    /*!
+    \return the new TEnvelope object, with empty envelopes.
+    */
+    TEnvelope();
+    //! Copy constructor.
+    /*!
+    \param Other the TEnvelope object to be copied.
+    \return the new TEnvelope object.
+    */
+    TEnvelope(const TEnvelope& Other);
+    //! Destructor.
+    ~TEnvelope();
+
+    //! Assignment operator.
+    /*!
+    \param Other the TEnvelope object to be copied.
+    \return the modified TEnvelope object.
+    */
+    TEnvelope& operator=(const TEnvelope& Other);
+
+    //! Computes the envelopes of a set of load combinations.
+    /*!
+    \param Results the results of the load cases, as given by TStructure::solve.
+    \param Combinations the load combinations to be enveloped.
+    \param NThreads the number of threads (zero selects all hardware threads).
+    */
+    void compute(const std::vector<TLoadCaseResult>& Results,
+                 const std::vector<TLoadCombination>& Combinations,
+                 int NThreads = 0);
+
+    //! Gets the minimum envelope.
+    /*!
+    \return the smallest value of each result among all the combinations.
+    */
+    const TLoadCaseResult& getMin() const;
+
+    //! Gets the maximum envelope.
+    /*!
+    \return the largest value of each result among all the combinations.
+    */
+    const TLoadCaseResult& getMax() const;
+
+private:
+    //! The minimum envelope.
+    TLoadCaseResult fMin;
+    //! The maximum envelope.
+    TLoadCaseResult fMax;
+};
+
+#endif // TENVELOPE_H
@@ -0,0 +1,200 @@
+/** \file TFixedMatrix.h
+* Contains the declaration and definition of the TFixedMatrix class template.
+*/
+
+#ifndef TFIXEDMATRIX_H
+#define TFIXEDMATRIX_H
+
+#include <iostream>
+#include "pzfmatrix.h"
+
+//!  A class template that implements a small matrix of fixed dimensions.
+/*!
+     A class template that implements a dense matrix whose dimensions are
+	 known at compile time. Its entries are stored by rows inside the object,
+	 so it needs no heap allocation, and the loops of its operations have
+	 constant bounds the compiler can fully unroll. It is used for the 6x6
+	 and 6x1 element-level matrices and vectors.
+*/
+template <int NRows, int NCols>
+class TFixedMatrix
+{
+public:
+    //! The number of rows of the matrix.
+    static constexpr int kRows = NRows;
+    //! The number of columns of the matrix.
+    static constexpr int kCols = NCols;
+
+    //! Default constructor.
+    /*!
+    \return the new TFixedMatrix object, with all entries equal to zero.
+    */
+    TFixedMatrix()
+    {
+        this->zero();
+    }
+
+    //! Sets all entries to zero.
+    void zero()
+    {
+        for (int k = 0; k < NRows * NCols; k++) {
+            fValues[k] = 0.;
+        }
+    }
+
+    //! Gets the number of rows of the matrix.
+    /*!
+    \return the number of rows of the matrix.
+    */
+    constexpr int Rows() const
+    {
+        return NRows;
+    }
+
+    //! Gets the number of columns of the matrix.
+    /*!
+    \return the number of columns of the matrix.
+    */
+    constexpr int Cols() const
+    {
+        return NCols;
+    }
+
+    //! Gets the address of an entry of the matrix.
+    /*!
+    \param Row the row of the entry.
+    \param Col the column of the entry.
+    \return the address of the entry.
+    */
+    double& operator()(int Row, int Col)
+    {
+        return fValues[Row * NCols + Col];
+    }
+
+    //! Gets an entry of the matrix.
+    /*!
+    \param Row the row of the entry.
+    \param Col the column of the entry.
+    \return the entry value.
+    */
+    double operator()(int Row, int Col) const
+    {
+        return fValues[Row * NCols + Col];
+    }
+
+    //! Gets an entry of the matrix.
+    /*!
+    \param Row the row of the entry.
+    \param Col the column of the entry.
+    \return the entry value.
+    */
+    double Get(int Row, int Col) const
+    {
+        return fValues[Row * NCols + Col];
+    }
+
+    //! Gets the entries of the matrix, stored by rows.
+    /*!
+    \return a pointer to the first entry of the matrix.
+    */
+    const double* data() const
+    {
+        return fValues;
+    }
+
+    //! Adds another matrix to this one.
+    /*!
+    \param Other the matrix to be added.
+    \return the modified matrix.
+    */
+    TFixedMatrix& operator+=(const TFixedMatrix& Other)
+    {
+        for (int k = 0; k < NRows * NCols; k++) {
+            fValues[k] += Other.fValues[k];
+        }
+        return *this;
+    }
+
+    //! Gets the sum of this matrix and another one.
+    /*!
+    \param Other the matrix to be added.
+    \return the sum of the matrices.
+    */
+    TFixedMatrix operator+(const TFixedMatrix& Other) const
+    {
+        TFixedMatrix sum(*this);
+        sum += Other;
+        return sum;
+    }
+
+    //! Gets the product of this matrix and another one.
+    /*!
+    \param Other the right factor of the product.
+    \return the product of the matrices.
+    */
+    template <int NOtherCols>
+    TFixedMatrix<NRows, NOtherCols> operator*(
+        const TFixedMatrix<NCols, NOtherCols>& Other) const
+    {
+        TFixedMatrix<NRows, NOtherCols> product;
+        for (int i = 0; i < NRows; i++) {
+            for (int k = 0; k < NCols; k++) {
+                double a = (*this)(i, k);
+                for (int j = 0; j < NOtherCols; j++) {
+                    product(i, j) += a * Other(k, j);
+                }
+            }
+        }
+        return product;
+    }
+
+    //! Gets the transpose of the matrix.
+    /*!
+    \return the transposed matrix.
+    */
+    TFixedMatrix<NCols, NRows> transpose() const
+    {
+        TFixedMatrix<NCols, NRows> transposed;
+        for (int i = 0; i < NRows; i++) {
+            for (int j = 0; j < NCols; j++) {
+                transposed(j, i) = (*this)(i, j);
+            }
+        }
+        return transposed;
+    }
+
+    //! Copies the matrix into a TPZFMatrix object.
+    /*!
+    \return a TPZFMatrix with the entries of the matrix.
+    */
+    TPZFMatrix<double> toDense() const
+    {
+        TPZFMatrix<double> dense(NRows, NCols, 0);
+        for (int j = 0; j < NCols; j++) {
+            for (int i = 0; i < NRows; i++) {
+                dense(i, j) = (*this)(i, j);
+            }
+        }
+        return dense;
+    }
+
+    //! Prints the matrix to a stream.
+    /*!
+    \param out the stream the matrix is printed to.
+    */
+    void Print(std::ostream& out) const
+    {
+        this->toDense().Print(out);
+    }
+
+private:
+    //! The entries of the matrix, stored by rows.
+    double fValues[NRows * NCols];
+};
+
+//! The 6x6 matrices of a frame element (stiffness and transformation).
+typedef TFixedMatrix<6, 6> TElementMatrix;
+//! The 6x1 vectors of a frame element (displacements and loads).
+typedef TFixedMatrix<6, 1> TElementVector;
+
+#endif // TFIXEDMATRIX_H
@@ -0,0 +1,32 @@
+/** \file TLinearSolver.cpp
+* Contains the definitions of the TLinearSolver methods.
+*/
+
+#include "TLinearSolver.h"
+#include "TDenseSolver.h"
+#include "TSkylineSolver.h"
+#include "TSparseCholeskySolver.h"
+#include "TPCGSolver.h"
+
+//! Destructor.
+TLinearSolver::~TLinearSolver() {}
+
+//! Creates a solver of a given type.
+TLinearSolver* TLinearSolver::create(ESolverType Type)
+{
+    switch (Type) {
+    case EDenseCholesky:
+        return new TDenseSolver();
+    case ESkylineLDLt:
+        return new TSkylineSolver();
+    case ESparseCholeskyAMD:
+    case ESparseCholeskyND:
+        return new TSparseCholeskySolver(Type);
+    case EPreconditionedCG:
+        return new TPCGSolver();
+    }
+
+    // Stops debug if the solver type is unknown.
+    DebugStop();
+    return nullptr;
+}
@@ -0,0 +1,78 @@
+/** \file TLinearSolver.h
+* Contains the declaration of the TLinearSolver class.
+*/
+
+#ifndef TLINEARSOLVER_H
+#define TLINEARSOLVER_H
+
+#include "pzfmatrix.h"
+#include "TSparseMatrix.h"
+
+//! Available methods to solve the unconstrained system K11 * Du = F.
+enum ESolverType {
+    //! Dense Cholesky factorization of K11.
+    EDenseCholesky,
+    //! LDLt factorization of K11 stored in skyline (variable band) form.
+    ESkylineLDLt,
+    //! Supernodal sparse Cholesky factorization in approximate minimum degree order.
+    ESparseCholeskyAMD,
+    //! Supernodal sparse Cholesky factorization in nested dissection order.
+    ESparseCholeskyND,
+    //! Preconditioned conjugate gradient iterations on the sparse K11.
+    EPreconditionedCG
+};
+
+//!  A base class for the solvers of the symmetric system K11 * Du = F.
+/*!
+     A base class for the solvers of the symmetric system K11 * Du = F.
+	 A solver is first factorized (or prepared) for a given matrix and can
+	 then solve for as many right-hand sides as needed.
+*/
+class TLinearSolver
+{
+public:
+    //! Destructor.
+    virtual ~TLinearSolver();
+
+    //! Creates a solver of a given type.
+    /*!
+    \param Type the type of the solver.
+    \return a pointer to the new solver, owned by the caller.
+    */
+    static TLinearSolver* create(ESolverType Type);
+
+    //! Creates a copy of the solver, including its factorization.
+    /*!
+    \return a pointer to the new solver, owned by the caller.
+    */
+    virtual TLinearSolver* clone() const = 0;
+
+    //! Gets the type of the solver.
+    /*!
+    \return the type of the solver.
+    */
+    virtual ESolverType getType() const = 0;
+
+    //! Factorizes a symmetric matrix and stores its factors.
+    /*!
+    \param K the view of the matrix to be factorized.
+    */
+    virtual void factorize(const TSparseBlock& K) = 0;
+
+    //! Solves the factorized system for one or more right-hand sides.
+    /*!
+    \param F the right-hand sides, one per column. It is overwritten with
+    the solution.
+    */
+    virtual void solve(TPZFMatrix<double>& F) const = 0;
+
+    //! Gets the number of entries stored in the factors.
+    /*!
+    The size of the factors of the same matrix measures the fill-in of each
+    method.
+    \return the number of stored entries of the factors, including the diagonal.
+    */
+    virtual int64_t getFactorSize() const = 0;
+};
+
+#endif // TLINEARSOLVER_H
@@ -0,0 +1,85 @@
+/** \file TLoadCase.cpp
+* Contains the definitions of the TLoadCase methods.
+*/
+
+#include "TLoadCase.h"
+
+//! Default constructor.
+TLoadCase::TLoadCase(const std::string& Name,
+                     const std::vector<TNodalLoad>& NodalLoads,
+                     const std::vector<TDistributedLoad>& DistrLoads,
+                     const std::vector<TElementEndMoment>& EndMoments)
+    : fName(Name),
+      fNodalLoads(NodalLoads),
+      fDistrLoads(DistrLoads),
+      fEndMoments(EndMoments) {}
+
+//! Copy constructor.
+TLoadCase::TLoadCase(const TLoadCase& Other)
+    : fName(Other.fName),
+      fNodalLoads(Other.fNodalLoads),
+      fDistrLoads(Other.fDistrLoads),
+      fEndMoments(Other.fEndMoments) {}
+
+//! Destructor.
+TLoadCase::~TLoadCase() {}
+
+//! Assignment operator.
+TLoadCase& TLoadCase::operator=(const TLoadCase& Other)
+{
+    if (this != &Other) {
+        fName = Other.fName;
+        fNodalLoads = Other.fNodalLoads;
+        fDistrLoads = Other.fDistrLoads;
+        fEndMoments = Other.fEndMoments;
+    }
+    return *this;
+}
+
+//! Gets the name of the load case.
+const std::string& TLoadCase::getName() const
+{
+    return fName;
+}
+
+//! Modifies the name of the load case.
+void TLoadCase::setName(const std::string& Name)
+{
+    fName = Name;
+}
+
+//! Gets the nodal loads of the load case.
+std::vector<TNodalLoad>& TLoadCase::getNodalLoads()
+{
+    return fNodalLoads;
+}
+
+//! Gets the distributed loads of the load case.
+std::vector<TDistributedLoad>& TLoadCase::getDistrLoads()
+{
+    return fDistrLoads;
+}
+
+//! Gets the element end moments of the load case.
+std::vector<TElementEndMoment>& TLoadCase::getEndMoments()
+{
+    return fEndMoments;
+}
+
+//! Adds a nodal load to the load case.
+void TLoadCase::addNodalLoad(const TNodalLoad& Load)
+{
+    fNodalLoads.push_back(Load);
+}
+
+//! Adds a distributed load to the load case.
+void TLoadCase::addDistrLoad(const TDistributedLoad& Load)
+{
+    fDistrLoads.push_back(Load);
+}
+
+//! Adds an element end moment to the load case.
+void TLoadCase::addEndMoment(const TElementEndMoment& Load)
+{
+    fEndMoments.push_back(Load);
+}
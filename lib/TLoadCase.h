@@ -0,0 +1,112 @@
+/** \file TLoadCase.h
+* Contains the declaration of the TLoadCase class.
+*/
+
+#ifndef TLOADCASE_H
+#define TLOADCASE_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "pzfmatrix.h"
+#include "TNodalLoad.h"
+#include "TDistributedLoad.h"
+#include "TElementEndMoment.h"
+
+//!  A class that implements a named group of loads.
+/*!
+     A class that implements a load case: a named group of nodal loads,
+	 distributed loads and element end moments that act together on the
+	 structure. Many load cases can be solved at once with a single
+	 factorization of the stiffness matrix.
+*/
+class TLoadCase {
+public:
+    //! Default constructor.
+    /*!
+    \param Name the name of the load case.
+    \param NodalLoads the nodal loads of the load case.
+    \param DistrLoads the distributed loads of the load case.
+    \param EndMoments the element end moments of the load case.
+    \return the new TLoadCase object.
+    */
+    TLoadCase(const std::string& Name = "",
+              const std::vector<TNodalLoad>& NodalLoads = {},
+              const std::vector<TDistributedLoad>& DistrLoads = {},
+              const std::vector<TElementEndMoment>& EndMoments = {});
+    //! Copy constructor.
+    /*!
+    \param Other the TLoadCase object to be copied.
+    \return the new TLoadCase object.
+    */
+    TLoadCase(const TLoadCase& Other);
+    //! Destructor.
+    ~TLoadCase();
+
+    //! Assignment operator.
+    /*!
+    \param Other the TLoadCase object to be copied.
+    \return the modified TLoadCase object.
+    */
+    TLoadCase& operator=(const TLoadCase& Other);
+
+    //! Gets the name of the load case.
+    /*!
+    \return the name of the load case.
+    */
+    const std::string& getName() const;
+
+    //! Modifies the name of the load case.
+    /*!
+    \param Name the new name of the load case.
+    */
+    void setName(const std::string& Name);
+
+    //! Gets the nodal loads of the load case.
+    /*!
+    \return the address of the vector of nodal loads.
+    */
+    std::vector<TNodalLoad>& getNodalLoads();
+
+    //! Gets the distributed loads of the load case.
+    /*!
+    \return the address of the vector of distributed loads.
+    */
+    std::vector<TDistributedLoad>& getDistrLoads();
+
+    //! Gets the element end moments of the load case.
+    /*!
+    \return the address of the vector of element end moments.
+    */
+    std::vector<TElementEndMoment>& getEndMoments();
+
+    //! Adds a nodal load to the load case.
+    /*!
+    \param Load the nodal load to be added.
+    */
+    void addNodalLoad(const TNodalLoad& Load);
+
+    //! Adds a distributed load to the load case.
+    /*!
+    \param Load the distributed load to be added.
+    */
+    void addDistrLoad(const TDistributedLoad& Load);
+
+    //! Adds an element end moment to the load case.
+    /*!
+    \param Load the element end moment to be added.
+    */
+    void addEndMoment(const TElementEndMoment& Load);
+
+private:
+    //! The name of the load case.
+    std::string fName;
+    //! The nodal loads of the load case.
+    std::vector<TNodalLoad> fNodalLoads;
+    //! The distributed loads of the load case.
+    std::vector<TDistributedLoad> fDistrLoads;
+    //! The element end moments of the load case.
+    std::vector<TElementEndMoment> fEndMoments;
+};
+
+#endif // TLOADCASE_H
@@ -0,0 +1,61 @@
+/** \file TLoadCaseResult.cpp
+* Contains the definitions of the TLoadCaseResult methods.
+*/
+
+#include "TLoadCaseResult.h"
+
+//! Default constructor.
+TLoadCaseResult::TLoadCaseResult(
+    const std::string& Name, const TPZFMatrix<double>& D,
+    const TPZFMatrix<double>& Q,
+    const std::vector<TPZFMatrix<double>>& InternalLoads)
+    : fName(Name),
+      fD(D),
+      fQ(Q),
+      fInternalLoads(InternalLoads) {}
+
+//! Copy constructor.
+TLoadCaseResult::TLoadCaseResult(const TLoadCaseResult& Other)
+    : fName(Other.fName),
+      fD(Other.fD),
+      fQ(Other.fQ),
+      fInternalLoads(Other.fInternalLoads) {}
+
+//! Destructor.
+TLoadCaseResult::~TLoadCaseResult() {}
+
+//! Assignment operator.
+TLoadCaseResult& TLoadCaseResult::operator=(const TLoadCaseResult& Other)
+{
+    if (this != &Other) {
+        fName = Other.fName;
+        fD = Other.fD;
+        fQ = Other.fQ;
+        fInternalLoads = Other.fInternalLoads;
+    }
+    return *this;
+}
+
+//! Gets the name of the load case.
+const std::string& TLoadCaseResult::getName() const
+{
+    return fName;
+}
+
+//! Gets the vector of nodal displacements.
+const TPZFMatrix<double>& TLoadCaseResult::getD() const
+{
+    return fD;
+}
+
+//! Gets the vector of external loads, including the support reactions.
+const TPZFMatrix<double>& TLoadCaseResult::getQ() const
+{
+    return fQ;
+}
+
+//! Gets the internal loads of the elements.
+const std::vector<TPZFMatrix<double>>& TLoadCaseResult::getInternalLoads() const
+{
+    return fInternalLoads;
+}
@@ -0,0 +1,85 @@
+/** \file TLoadCaseResult.h
+* Contains the declaration of the TLoadCaseResult class.
+*/
+
+#ifndef TLOADCASERESULT_H
+#define TLOADCASERESULT_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "pzfmatrix.h"
+
+//!  A class that implements the results of a load case.
+/*!
+     A class that implements the results of the analysis of a structure for
+	 a single load case: the nodal displacements, the external loads vector
+	 (with the support reactions at the constrained degrees of freedom) and
+	 the internal loads of every element, in local coordinates.
+*/
+class TLoadCaseResult {
+public:
+    //! Default constructor.
+    /*!
+    \param Name the name of the load case.
+    \param D the vector of nodal displacements.
+    \param Q the vector of external loads, including the support reactions.
+    \param InternalLoads the internal loads of each element.
+    \return the new TLoadCaseResult object.
+    */
+    TLoadCaseResult(const std::string& Name = "",
+                    const TPZFMatrix<double>& D = TPZFMatrix<double>(),
+                    const TPZFMatrix<double>& Q = TPZFMatrix<double>(),
+                    const std::vector<TPZFMatrix<double>>& InternalLoads = {});
+    //! Copy constructor.
+    /*!
+    \param Other the TLoadCaseResult object to be copied.
+    \return the new TLoadCaseResult object.
+    */
+    TLoadCaseResult(const TLoadCaseResult& Other);
+    //! Destructor.
+    ~TLoadCaseResult();
+
+    //! Assignment operator.
+    /*!
+    \param Other the TLoadCaseResult object to be copied.
+    \return the modified TLoadCaseResult object.
+    */
+    TLoadCaseResult& operator=(const TLoadCaseResult& Other);
+
+    //! Gets the name of the load case.
+    /*!
+    \return the name of the load case.
+    */
+    const std::string& getName() const;
+
+    //! Gets the vector of nodal displacements.
+    /*!
+    \return the vector of nodal displacements, one row per equation.
+    */
+    const TPZFMatrix<double>& getD() const;
+
+    //! Gets the vector of external loads, including the support reactions.
+    /*!
+    \return the vector of external loads, one row per equation.
+    */
+    const TPZFMatrix<double>& getQ() const;
+
+    //! Gets the internal loads of the elements.
+    /*!
+    \return the 6x1 internal loads of each element, in local coordinates.
+    */
+    const std::vector<TPZFMatrix<double>>& getInternalLoads() const;
+
+private:
+    //! The name of the load case.
+    std::string fName;
+    //! The vector of nodal displacements.
+    TPZFMatrix<double> fD;
+    //! The vector of external loads, including the support reactions.
+    TPZFMatrix<double> fQ;
+    //! The internal loads of each element.
+    std::vector<TPZFMatrix<double>> fInternalLoads;
+};
+
+#endif // TLOADCASERESULT_H
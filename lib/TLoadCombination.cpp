@@ -0,0 +1,108 @@
+/** \file TLoadCombination.cpp
+* Contains the definitions of the TLoadCombination methods.
+*/
+
+#include "TLoadCombination.h"
+
+//! Default constructor.
+TLoadCombination::TLoadCombination(const std::string& Name) : fName(Name) {}
+
+//! Copy constructor.
+TLoadCombination::TLoadCombination(const TLoadCombination& Other)
+    : fName(Other.fName),
+      fCases(Other.fCases),
+      fFactors(Other.fFactors) {}
+
+//! Destructor.
+TLoadCombination::~TLoadCombination() {}
+
+//! Assignment operator.
+TLoadCombination& TLoadCombination::operator=(const TLoadCombination& Other)
+{
+    if (this != &Other) {
+        fName = Other.fName;
+        fCases = Other.fCases;
+        fFactors = Other.fFactors;
+    }
+    return *this;
+}
+
+//! Gets the name of the load combination.
+const std::string& TLoadCombination::getName() const
+{
+    return fName;
+}
+
+//! Modifies the name of the load combination.
+void TLoadCombination::setName(const std::string& Name)
+{
+    fName = Name;
+}
+
+//! Adds a factored load case to the combination.
+void TLoadCombination::addCase(int Case, double Factor)
+{
+    fCases.push_back(Case);
+    fFactors.push_back(Factor);
+}
+
+//! Gets the indexes of the load cases of the combination.
+const std::vector<int>& TLoadCombination::getCases() const
+{
+    return fCases;
+}
+
+//! Gets the factors of the load cases of the combination.
+const std::vector<double>& TLoadCombination::getFactors() const
+{
+    return fFactors;
+}
+
+//! Computes the results of the combination from the results of the load cases.
+TLoadCaseResult TLoadCombination::combine(
+    const std::vector<TLoadCaseResult>& Results) const
+{
+    if (Results.empty()) {
+        // Stops debug if there are no results to be combined.
+        DebugStop();
+    }
+    for (int k = 0; k < (int)fCases.size(); k++) {
+        if (fCases[k] < 0 || fCases[k] >= (int)Results.size()) {
+            // Stops debug if the combination refers to a missing load case.
+            DebugStop();
+        }
+    }
+
+    int NDOF = Results[0].getD().Rows();
+    int nElements = Results[0].getInternalLoads().size();
+    TPZFMatrix<double> D(NDOF, 1, 0);
+    TPZFMatrix<double> Q(NDOF, 1, 0);
+    std::vector<TPZFMatrix<double>> internalLoads(nElements,
+                                                  TPZFMatrix<double>(6, 1, 0));
+
+    // Each entry is the factored sum over all load cases of the combination.
+    for (int i = 0; i < NDOF; i++) {
+        double d = 0.;
+        double q = 0.;
+        for (int k = 0; k < (int)fCases.size(); k++) {
+            const TLoadCaseResult& result = Results[fCases[k]];
+            d += fFactors[k] * result.getD().GetVal(i, 0);
+            q += fFactors[k] * result.getQ().GetVal(i, 0);
+        }
+        D(i, 0) = d;
+        Q(i, 0) = q;
+    }
+
+    for (int e = 0; e < nElements; e++) {
+        for (int j = 0; j < 6; j++) {
+            double value = 0.;
+            for (int k = 0; k < (int)fCases.size(); k++) {
+                const TLoadCaseResult& result = Results[fCases[k]];
+                value += fFactors[k] * result.getInternalLoads()[e].GetVal(j, 0);
+            }
+            internalLoads[e](j, 0) = value;
+        }
+    }
+
+    return TLoadCaseResult(fName, D, Q, internalLoads);
+}
@@ -0,0 +1,91 @@
+/** \file TLoadCombination.h
+* Contains the declaration of the TLoadCombination class.
+*/
+
+#ifndef TLOADCOMBINATION_H
+#define TLOADCOMBINATION_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "TLoadCaseResult.h"
+
+//!  A class that implements a factored combination of load cases.
+/*!
+     A class that implements a load combination, such as 1.35G + 1.5Q: a
+	 named list of load cases, each one with a factor. As the analysis is
+	 linear, the results of a combination are the factored sum of the
+	 results of its load cases, so no new solution is needed.
+*/
+class TLoadCombination {
+public:
+    //! Default constructor.
+    /*!
+    \param Name the name of the load combination.
+    \return the new TLoadCombination object, with no load cases.
+    */
+    TLoadCombination(const std::string& Name = "");
+    //! Copy constructor.
+    /*!
+    \param Other the TLoadCombination object to be copied.
+    \return the new TLoadCombination object.
+    */
+    TLoadCombination(const TLoadCombination& Other);
+    //! Destructor.
+    ~TLoadCombination();
+
+    //! Assignment operator.
+    /*!
+    \param Other the TLoadCombination object to be copied.
+    \return the modified TLoadCombination object.
+    */
+    TLoadCombination& operator=(const TLoadCombination& Other);
+
+    //! Gets the name of the load combination.
+    /*!
+    \return the name of the load combination.
+    */
+    const std::string& getName() const;
+
+    //! Modifies the name of the load combination.
+    /*!
+    \param Name the new name of the load combination.
+    */
+    void setName(const std::string& Name);
+
+    //! Adds a factored load case to the combination.
+    /*!
+    \param Case the index of the load case in the vector of results.
+    \param Factor the factor applied to the load case.
+    */
+    void addCase(int Case, double Factor);
+
+    //! Gets the indexes of the load cases of the combination.
+    /*!
+    \return the indexes of the load cases in the vector of results.
+    */
+    const std::vector<int>& getCases() const;
+
+    //! Gets the factors of the load cases of the combination.
+    /*!
+    \return the factor of each load case, in the order of getCases().
+    */
+    const std::vector<double>& getFactors() const;
+
+    //! Computes the results of the combination from the results of the load cases.
+    /*!
+    \param Results the results of the load cases, as given by TStructure::solve.
+    \return the combined displacements, loads and internal loads.
+    */
+    TLoadCaseResult combine(const std::vector<TLoadCaseResult>& Results) const;
+
+private:
+    //! The name of the load combination.
+    std::string fName;
+    //! The indexes of the load cases of the combination.
+    std::vector<int> fCases;
+    //! The factor of each load case.
+    std::vector<double> fFactors;
+};
+
+#endif // TLOADCOMBINATION_H
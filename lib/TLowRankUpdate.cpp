@@ -0,0 +1,268 @@
+/** \file TLowRankUpdate.cpp
+* Contains the definitions of the TLowRankUpdate methods.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include "TLowRankUpdate.h"
+
+namespace {
+
+//! Factorizes a dense square matrix (by columns) in place, with partial pivoting.
+void factorizeLU(int N, std::vector<double>& A, std::vector<int>& Pivots)
+{
+    double scale = 0.;
+    for (int k = 0; k < N * N; k++) {
+        scale = std::max(scale, std::abs(A[k]));
+    }
+
+    Pivots.resize(N);
+    for (int j = 0; j < N; j++) {
+        int pivot = j;
+        for (int i = j + 1; i < N; i++) {
+            if (std::abs(A[i + j * N]) > std::abs(A[pivot + j * N])) pivot = i;
+        }
+        if (std::abs(A[pivot + j * N]) <= 1e-14 * scale) {
+            // Stops debug if the modified structure is unstable.
+            DebugStop();
+        }
+        Pivots[j] = pivot;
+        if (pivot != j) {
+            for (int k = 0; k < N; k++) {
+                std::swap(A[j + k * N], A[pivot + k * N]);
+            }
+        }
+        for (int i = j + 1; i < N; i++) {
+            A[i + j * N] /= A[j + j * N];
+        }
+        for (int k = j + 1; k < N; k++) {
+            double factor = A[j + k * N];
+            if (factor == 0.) continue;
+            for (int i = j + 1; i < N; i++) {
+                A[i + k * N] -= A[i + j * N] * factor;
+            }
+        }
+    }
+}
+
+//! Solves a system factorized by factorizeLU for NRhs columns of X (by columns).
+void solveLU(int N, const std::vector<double>& LU, const std::vector<int>& Pivots,
+             double* X, int NRhs)
+{
+    for (int c = 0; c < NRhs; c++) {
+        double* x = X + (int64_t)c * N;
+        for (int j = 0; j < N; j++) {
+            std::swap(x[j], x[Pivots[j]]);
+        }
+        for (int j = 0; j < N; j++) {
+            for (int i = j + 1; i < N; i++) {
+                x[i] -= LU[i + j * N] * x[j];
+            }
+        }
+        for (int j = N - 1; j >= 0; j--) {
+            x[j] /= LU[j + j * N];
+            for (int i = 0; i < j; i++) {
+                x[i] -= LU[i + j * N] * x[j];
+            }
+        }
+    }
+}
+
+} // namespace
+
+//! Default constructor.
+TLowRankUpdate::TLowRankUpdate() : fNBase(0), fNNew(0) {}
+
+//! Prepares the update for a modified matrix.
+bool TLowRankUpdate::setup(const TLinearSolver& Base, int NBase,
+                           const std::vector<int>& Equations,
+                           const std::vector<int>& Rows,
+                           const std::vector<int>& Cols,
+                           const std::vector<double>& Values, int MaxRank)
+{
+    int nEquations = Equations.size();
+    int nEntries = Values.size();
+
+    // Finds the changed rows of K0 and the number of new equations.
+    std::vector<int> changed;
+    int nNew = 0;
+    for (int k = 0; k < nEntries; k++) {
+        if (Rows[k] < NBase) changed.push_back(Rows[k]);
+    }
+    for (int i = 0; i < nEquations; i++) {
+        nNew = std::max(nNew, Equations[i] - NBase + 1);
+    }
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    int p = changed.size();
+    int m = nNew;
+    if (p + m > MaxRank) return false;
+
+    fNBase = NBase;
+    fNNew = m;
+    fEquations = Equations;
+    fChanged = changed;
+
+    // Splits the change into its blocks: A on the changed rows of K0, B
+    // coupling them to the new equations and C on the new equations.
+    auto position = [this](int Equation) {
+        return (int)(std::lower_bound(fChanged.begin(), fChanged.end(), Equation) -
+                     fChanged.begin());
+    };
+    std::vector<double> A(p * p, 0.);
+    fB.assign(p * m, 0.);
+    fC.assign(m * m, 0.);
+    for (int k = 0; k < nEntries; k++) {
+        int row = Rows[k];
+        int col = Cols[k];
+        if (row < NBase && col < NBase) {
+            A[position(row) + position(col) * p] += Values[k];
+        }
+        else if (row < NBase) {
+            fB[position(row) + (col - NBase) * p] += Values[k];
+        }
+        else if (col >= NBase) {
+            fC[(row - NBase) + (col - NBase) * m] += Values[k];
+        }
+    }
+
+    // D = A - B * C^-1 * B^T condenses the new equations.
+    fD = A;
+    if (m > 0) {
+        factorizeLU(m, fC, fCPivots);
+        std::vector<double> CinvBT(m * p);
+        for (int j = 0; j < p; j++) {
+            for (int i = 0; i < m; i++) {
+                CinvBT[i + j * m] = fB[j + i * p];
+            }
+        }
+        solveLU(m, fC, fCPivots, CinvBT.data(), p);
+        for (int j = 0; j < p; j++) {
+            for (int k = 0; k < m; k++) {
+                double factor = CinvBT[k + j * m];
+                for (int i = 0; i < p; i++) {
+                    fD[i + j * p] -= fB[i + k * p] * factor;
+                }
+            }
+        }
+    }
+
+    // G = P^T * K0^-1 * P, solving for a few columns of P at a time to
+    // bound the memory.
+    std::vector<double> G(p * p);
+    const int blockSize = 16;
+    for (int first = 0; first < p; first += blockSize) {
+        int n = std::min(blockSize, p - first);
+        TPZFMatrix<double> E(NBase, n, 0.);
+        for (int j = 0; j < n; j++) {
+            E(fChanged[first + j], j) = 1.;
+        }
+        Base.solve(E);
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < p; i++) {
+                G[i + (first + j) * p] = E(fChanged[i], j);
+            }
+        }
+    }
+
+    // M = I + D * G.
+    fM.assign(p * p, 0.);
+    for (int j = 0; j < p; j++) {
+        fM[j + j * p] = 1.;
+        for (int k = 0; k < p; k++) {
+            double factor = G[k + j * p];
+            for (int i = 0; i < p; i++) {
+                fM[i + j * p] += fD[i + k * p] * factor;
+            }
+        }
+    }
+    if (p > 0) factorizeLU(p, fM, fMPivots);
+    return true;
+}
+
+//! Gets the number of changed and new equations of the update.
+int TLowRankUpdate::getRank() const
+{
+    return (int)fChanged.size() + fNNew;
+}
+
+//! Solves the modified system for one or more right-hand sides.
+void TLowRankUpdate::solve(const TLinearSolver& Base, TPZFMatrix<double>& F) const
+{
+    int nEquations = fEquations.size();
+    int nCases = F.Cols();
+    int p = fChanged.size();
+    int m = fNNew;
+
+    // Moves the right-hand sides to the extended space: Y for the equations
+    // of K0 and V for the new ones.
+    TPZFMatrix<double> Y(fNBase, nCases, 0.);
+    std::vector<double> V(m * nCases, 0.);
+    for (int c = 0; c < nCases; c++) {
+        for (int i = 0; i < nEquations; i++) {
+            int equation = fEquations[i];
+            if (equation < fNBase) Y(equation, c) = F(i, c);
+            else V[(equation - fNBase) + c * m] = F(i, c);
+        }
+    }
+
+    // Condenses the new equations: Y -= B * C^-1 * V.
+    std::vector<double> CinvV = V;
+    if (m > 0) {
+        solveLU(m, fC, fCPivots, CinvV.data(), nCases);
+        for (int c = 0; c < nCases; c++) {
+            for (int k = 0; k < m; k++) {
+                for (int i = 0; i < p; i++) {
+                    Y(fChanged[i], c) -= fB[i + k * p] * CinvV[k + c * m];
+                }
+            }
+        }
+    }
+
+    // Y = K0^-1 * Y, then Y -= K0^-1 * P * M^-1 * D * P^T * Y.
+    Base.solve(Y);
+    if (p > 0) {
+        std::vector<double> W(p * nCases, 0.);
+        for (int c = 0; c < nCases; c++) {
+            for (int k = 0; k < p; k++) {
+                double y = Y(fChanged[k], c);
+                for (int i = 0; i < p; i++) {
+                    W[i + c * p] += fD[i + k * p] * y;
+                }
+            }
+        }
+        solveLU(p, fM, fMPivots, W.data(), nCases);
+        TPZFMatrix<double> Z(fNBase, nCases, 0.);
+        for (int c = 0; c < nCases; c++) {
+            for (int i = 0; i < p; i++) {
+                Z(fChanged[i], c) = W[i + c * p];
+            }
+        }
+        Base.solve(Z);
+        for (int c = 0; c < nCases; c++) {
+            for (int i = 0; i < fNBase; i++) {
+                Y(i, c) -= Z(i, c);
+            }
+        }
+    }
+
+    // Recovers the new equations: V = C^-1 * (V - B^T * Y).
+    if (m > 0) {
+        for (int c = 0; c < nCases; c++) {
+            for (int k = 0; k < m; k++) {
+                for (int i = 0; i < p; i++) {
+                    V[k + c * m] -= fB[i + k * p] * Y(fChanged[i], c);
+                }
+            }
+        }
+        solveLU(m, fC, fCPivots, V.data(), nCases);
+    }
+
+    for (int c = 0; c < nCases; c++) {
+        for (int i = 0; i < nEquations; i++) {
+            int equation = fEquations[i];
+            F(i, c) = (equation < fNBase) ? Y(equation, c)
+                                          : V[(equation - fNBase) + c * m];
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/** \file TLowRankUpdate.h
+* Contains the declaration of the TLowRankUpdate class.
+*/
+
+#ifndef TLOWRANKUPDATE_H
+#define TLOWRANKUPDATE_H
+
+#include <vector>
+#include "TLinearSolver.h"
+
+//!  A class that solves a modified system with the factorization of the original one.
+/*!
+     A class that solves a system whose matrix differs from an already
+	 factorized base matrix K0 in a few rows and columns, without factorizing
+	 it again. The modified system may also have new equations, coupled only
+	 to the changed rows of K0, and may have lost some of the base equations.
+
+	 The new equations are condensed into the changed rows, which leaves
+	 K0 + P * D * P^T, where P selects the p changed rows. It is solved by the
+	 Sherman-Morrison-Woodbury formula:
+	 (K0 + P D P^T)^-1 = K0^-1 - K0^-1 P (I + D G)^-1 D P^T K0^-1,
+	 with G = P^T K0^-1 P. Preparing the update costs p solves with K0, and
+	 each solve two solves with K0 and a few dense p x p products. The result
+	 is exact up to rounding.
+*/
+class TLowRankUpdate
+{
+public:
+    //! Default constructor.
+    TLowRankUpdate();
+
+    //! Prepares the update for a modified matrix.
+    /*!
+    The equations of the modified system are mapped to an extended space
+    whose first NBase equations are those of K0 and the others are new.
+    Base equations that no equation maps to must be decoupled by the change
+    (zero rows and columns except a non-zero diagonal), and get a zero
+    right-hand side.
+    \param Base the solver holding the factorization of K0.
+    \param NBase the number of equations of K0.
+    \param Equations the equation of the extended space of each equation of
+    the modified system.
+    \param Rows the rows of the entries of the change, in the extended space.
+    \param Cols the columns of the entries of the change, in the extended space.
+    \param Values the values of the entries of the change. Repeated entries
+    are added and both triangles of the symmetric change must be given.
+    \param MaxRank the largest number of changed and new equations accepted.
+    \return false, without preparing anything, if more than MaxRank
+    equations are changed or new.
+    */
+    bool setup(const TLinearSolver& Base, int NBase,
+               const std::vector<int>& Equations, const std::vector<int>& Rows,
+               const std::vector<int>& Cols, const std::vector<double>& Values,
+               int MaxRank);
+
+    //! Gets the number of changed and new equations of the update.
+    int getRank() const;
+
+    //! Solves the modified system for one or more right-hand sides.
+    /*!
+    \param Base the solver holding the factorization of K0, as given to setup().
+    \param F the right-hand sides, one per column, with one row per equation
+    of the modified system. It is overwritten with the solution.
+    */
+    void solve(const TLinearSolver& Base, TPZFMatrix<double>& F) const;
+
+private:
+    // fNBase - number of equations of K0.
+    int fNBase;
+    // fNNew - number of new equations.
+    int fNNew;
+    // fEquations - extended equation of each equation of the modified system.
+    std::vector<int> fEquations;
+    // fChanged - changed equations of K0, in increasing order (P).
+    std::vector<int> fChanged;
+    // fB - coupling of the changed and the new equations (p x m, by columns).
+    std::vector<double> fB;
+    // fC, fCPivots - LU factors of the matrix of the new equations (m x m).
+    std::vector<double> fC;
+    std::vector<int> fCPivots;
+    // fD - change of the changed rows after condensing the new equations (p x p).
+    std::vector<double> fD;
+    // fM, fMPivots - LU factors of the capacitance matrix I + D * G (p x p).
+    std::vector<double> fM;
+    std::vector<int> fMPivots;
+};
+
+#endif // TLOWRANKUPDATE_H
@@ -93,17 +93,17 @@ void TNodalLoad::setStructure(TStructure* Structure)
 }
 
 //! Adds the effects of the nodal load to the vector of loads.
-void TNodalLoad::store(TPZFMatrix<double>& Q)
+void TNodalLoad::store(TPZFMatrix<double>& Q, int Case)
 {
-    int fxDOF = fStructure->getNodeEquations()(fNodeID, 0);
-    int fyDOF = fStructure->getNodeEquations()(fNodeID, 1);
-    int mDOF = fStructure->getNodeEquations()(fNodeID, 2);
+    int fxDOF = fStructure->getNodeEquation(fNodeID, 0);
+    int fyDOF = fStructure->getNodeEquation(fNodeID, 1);
+    int mDOF = fStructure->getNodeEquation(fNodeID, 2);
 
-    Q(fxDOF, 0) += fFx;
-    Q(fyDOF, 0) += fFy;
+    Q(fxDOF, Case) += fFx;
+    Q(fyDOF, Case) += fFy;
     if (mDOF != -1) {
         // Adds the moment load if the node is not hinged.
-        Q(mDOF, 0) += fM;
+        Q(mDOF, Case) += fM;
     }
 }
 
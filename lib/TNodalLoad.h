@@ -102,8 +102,9 @@ public:
     //! Adds the effects of the nodal load to the vector of loads.
     /*!
     \param Q the addres to the vector of loads Q to be modified.
+    \param Case the column of Q (load case) that receives the load.
     */
-    void store(TPZFMatrix<double>& Q);
+    void store(TPZFMatrix<double>& Q, int Case = 0);
 
     //! Prints the load information to std::cout.
     void print();
@@ -0,0 +1,412 @@
+/** \file TPCGSolver.cpp
+* Contains the definitions of the TPCGSolver methods.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include "TPCGSolver.h"
+
+//! Default constructor.
+TPCGSolver::TPCGSolver(EPreconditioner Preconditioner, double Tolerance,
+                       int MaxIterations)
+    : fPreconditioner(Preconditioner),
+      fTolerance(Tolerance),
+      fMaxIterations(MaxIterations),
+      fDim(0),
+      fRowPtr(1, 0),
+      fIterations(0),
+      fResidual(0.) {}
+
+//! Creates a copy of the solver, including its preconditioner.
+TLinearSolver* TPCGSolver::clone() const
+{
+    return new TPCGSolver(*this);
+}
+
+//! Gets the type of the solver.
+ESolverType TPCGSolver::getType() const
+{
+    return EPreconditionedCG;
+}
+
+//! Gets the number of entries stored by the preconditioner.
+int64_t TPCGSolver::getFactorSize() const
+{
+    switch (fPreconditioner) {
+    case EJacobi:
+        return (int64_t)fInvDiagonal.size();
+    case EBlockJacobi:
+        return (int64_t)fBlockFactors.size();
+    case EIncompleteCholesky:
+        return (int64_t)fIncomplete.size();
+    }
+    return 0;
+}
+
+//! Modifies the preconditioner, used from the next factorization on.
+void TPCGSolver::setPreconditioner(EPreconditioner Preconditioner)
+{
+    fPreconditioner = Preconditioner;
+}
+
+//! Gets the preconditioner.
+EPreconditioner TPCGSolver::getPreconditioner() const
+{
+    return fPreconditioner;
+}
+
+//! Modifies the relative residual to be reached.
+void TPCGSolver::setTolerance(double Tolerance)
+{
+    fTolerance = Tolerance;
+}
+
+//! Gets the relative residual to be reached.
+double TPCGSolver::getTolerance() const
+{
+    return fTolerance;
+}
+
+//! Modifies the maximum number of iterations for each right-hand side.
+void TPCGSolver::setMaxIterations(int MaxIterations)
+{
+    fMaxIterations = MaxIterations;
+}
+
+//! Gets the maximum number of iterations for each right-hand side.
+int TPCGSolver::getMaxIterations() const
+{
+    return fMaxIterations;
+}
+
+//! Modifies the blocks of the block Jacobi preconditioner.
+void TPCGSolver::setBlocks(const std::vector<int>& Blocks)
+{
+    fBlocks = Blocks;
+}
+
+//! Gets the number of iterations of the last solve.
+int TPCGSolver::getIterations() const
+{
+    return fIterations;
+}
+
+//! Gets the residual reached by the last solve.
+double TPCGSolver::getResidual() const
+{
+    return fResidual;
+}
+
+//! Stores the matrix and builds the preconditioner.
+void TPCGSolver::factorize(const TSparseBlock& K)
+{
+    fDim = K.Rows();
+    const int* columns = K.getMatrix()->getColumns();
+    const double* values = K.getMatrix()->getValues();
+    int col0 = K.getCol0();
+
+    // Copies the upper triangle of the block. Its diagonal entry is the first
+    // one of each row.
+    fRowPtr.assign(fDim + 1, 0);
+    fColumns.clear();
+    fValues.clear();
+    for (int i = 0; i < fDim; i++) {
+        int64_t first, last;
+        K.getRowRange(i, first, last);
+        for (int64_t k = first; k < last; k++) {
+            int j = columns[k] - col0;
+            if (j < i) continue;
+            fColumns.push_back(j);
+            fValues.push_back(values[k]);
+        }
+        fRowPtr[i + 1] = (int64_t)fColumns.size();
+        if (fRowPtr[i] == fRowPtr[i + 1] || fColumns[fRowPtr[i]] != i ||
+            fValues[fRowPtr[i]] <= 0.) {
+            // Stops debug if K11 is not positive definite (unstable structure).
+            DebugStop();
+        }
+    }
+
+    fInvDiagonal.clear();
+    fBlockPtr.clear();
+    fBlockEquations.clear();
+    fBlockFactorPtr.clear();
+    fBlockFactors.clear();
+    fIncomplete.clear();
+    switch (fPreconditioner) {
+    case EJacobi:
+        fInvDiagonal.resize(fDim);
+        for (int i = 0; i < fDim; i++) {
+            fInvDiagonal[i] = 1. / fValues[fRowPtr[i]];
+        }
+        break;
+    case EBlockJacobi:
+        this->buildBlockJacobi();
+        break;
+    case EIncompleteCholesky:
+        this->buildIncompleteCholesky();
+        break;
+    }
+}
+
+//! Builds the block Jacobi preconditioner.
+void TPCGSolver::buildBlockJacobi()
+{
+    // Groups the equations by block; equations without a block are alone.
+    std::vector<std::pair<int, int>> keys(fDim);
+    for (int i = 0; i < fDim; i++) {
+        int block = (i < (int)fBlocks.size()) ? fBlocks[i] : -1;
+        keys[i] = (block < 0) ? std::make_pair(-1 - i, i) : std::make_pair(block, i);
+    }
+    std::sort(keys.begin(), keys.end());
+    fBlockPtr.assign(1, 0);
+    fBlockEquations.resize(fDim);
+    for (int k = 0; k < fDim; k++) {
+        fBlockEquations[k] = keys[k].second;
+        if (k > 0 && keys[k].first != keys[k - 1].first) fBlockPtr.push_back(k);
+    }
+    fBlockPtr.push_back(fDim);
+    if (fDim == 0) fBlockPtr.assign(1, 0);
+
+    // Factorizes each diagonal block, L * L^T, by rows.
+    int nBlocks = (int)fBlockPtr.size() - 1;
+    fBlockFactorPtr.assign(nBlocks + 1, 0);
+    for (int b = 0; b < nBlocks; b++) {
+        int64_t m = fBlockPtr[b + 1] - fBlockPtr[b];
+        fBlockFactorPtr[b + 1] = fBlockFactorPtr[b] + m * m;
+    }
+    fBlockFactors.assign(fBlockFactorPtr[nBlocks], 0.);
+    for (int b = 0; b < nBlocks; b++) {
+        int m = fBlockPtr[b + 1] - fBlockPtr[b];
+        const int* equations = &fBlockEquations[fBlockPtr[b]];
+        double* block = &fBlockFactors[fBlockFactorPtr[b]];
+        for (int r = 0; r < m; r++) {
+            for (int c = 0; c < m; c++) {
+                int i = std::min(equations[r], equations[c]);
+                int j = std::max(equations[r], equations[c]);
+                auto first = fColumns.begin() + fRowPtr[i];
+                auto last = fColumns.begin() + fRowPtr[i + 1];
+                auto it = std::lower_bound(first, last, j);
+                if (it != last && *it == j) {
+                    block[r * m + c] = fValues[it - fColumns.begin()];
+                }
+            }
+        }
+        for (int j = 0; j < m; j++) {
+            double diag = block[j * m + j];
+            for (int k = 0; k < j; k++) {
+                diag -= block[j * m + k] * block[j * m + k];
+            }
+            if (diag <= 0.) {
+                // Stops debug if K11 is not positive definite (unstable structure).
+                DebugStop();
+            }
+            diag = std::sqrt(diag);
+            block[j * m + j] = diag;
+            for (int i = j + 1; i < m; i++) {
+                double sum = block[i * m + j];
+                for (int k = 0; k < j; k++) {
+                    sum -= block[i * m + k] * block[j * m + k];
+                }
+                block[i * m + j] = sum / diag;
+            }
+        }
+    }
+}
+
+//! Builds the IC(0) preconditioner.
+void TPCGSolver::buildIncompleteCholesky()
+{
+    // The incomplete factorization of a positive definite matrix may break
+    // down; the diagonal is then increased by a growing relative shift until
+    // it succeeds.
+    std::vector<int64_t> position(fDim, -1);
+    double shift = 0.;
+    for (int attempt = 0; attempt < 30; attempt++) {
+        fIncomplete = fValues;
+        for (int i = 0; i < fDim; i++) {
+            fIncomplete[fRowPtr[i]] *= 1. + shift;
+        }
+
+        bool success = true;
+        for (int i = 0; i < fDim && success; i++) {
+            int64_t diag = fRowPtr[i];
+            int64_t end = fRowPtr[i + 1];
+            if (fIncomplete[diag] <= 0.) {
+                success = false;
+                break;
+            }
+            double pivot = std::sqrt(fIncomplete[diag]);
+            fIncomplete[diag] = pivot;
+            for (int64_t p = diag + 1; p < end; p++) {
+                fIncomplete[p] /= pivot;
+            }
+
+            // Updates the rows of the columns of row i, dropping the entries
+            // that are not in the pattern.
+            for (int64_t p = diag + 1; p < end; p++) {
+                int j = fColumns[p];
+                for (int64_t q = fRowPtr[j]; q < fRowPtr[j + 1]; q++) {
+                    position[fColumns[q]] = q;
+                }
+                double uij = fIncomplete[p];
+                for (int64_t q = p; q < end; q++) {
+                    int64_t pos = position[fColumns[q]];
+                    if (pos >= 0) fIncomplete[pos] -= uij * fIncomplete[q];
+                }
+                for (int64_t q = fRowPtr[j]; q < fRowPtr[j + 1]; q++) {
+                    position[fColumns[q]] = -1;
+                }
+            }
+        }
+        if (success) return;
+        shift = (shift == 0.) ? 1e-3 : 2. * shift;
+    }
+
+    // Stops debug if no shift gives a positive incomplete factorization.
+    DebugStop();
+}
+
+//! Computes Y = K * X.
+void TPCGSolver::multiply(const std::vector<double>& X,
+                          std::vector<double>& Y) const
+{
+    std::fill(Y.begin(), Y.end(), 0.);
+    for (int i = 0; i < fDim; i++) {
+        int64_t diag = fRowPtr[i];
+        double xi = X[i];
+        double sum = fValues[diag] * xi;
+        for (int64_t p = diag + 1; p < fRowPtr[i + 1]; p++) {
+            int j = fColumns[p];
+            sum += fValues[p] * X[j];
+            Y[j] += fValues[p] * xi;
+        }
+        Y[i] += sum;
+    }
+}
+
+//! Computes Z = M^-1 * R, where M is the preconditioner.
+void TPCGSolver::precondition(const std::vector<double>& R,
+                              std::vector<double>& Z) const
+{
+    switch (fPreconditioner) {
+    case EJacobi:
+        for (int i = 0; i < fDim; i++) {
+            Z[i] = fInvDiagonal[i] * R[i];
+        }
+        break;
+    case EBlockJacobi:
+        for (int b = 0; b + 1 < (int)fBlockPtr.size(); b++) {
+            int m = fBlockPtr[b + 1] - fBlockPtr[b];
+            const int* equations = &fBlockEquations[fBlockPtr[b]];
+            const double* block = &fBlockFactors[fBlockFactorPtr[b]];
+            double y[16];
+            std::vector<double> large;
+            double* v = y;
+            if (m > 16) {
+                large.resize(m);
+                v = large.data();
+            }
+            for (int i = 0; i < m; i++) {
+                double sum = R[equations[i]];
+                for (int k = 0; k < i; k++) {
+                    sum -= block[i * m + k] * v[k];
+                }
+                v[i] = sum / block[i * m + i];
+            }
+            for (int i = m - 1; i >= 0; i--) {
+                double sum = v[i];
+                for (int k = i + 1; k < m; k++) {
+                    sum -= block[k * m + i] * v[k];
+                }
+                v[i] = sum / block[i * m + i];
+            }
+            for (int i = 0; i < m; i++) {
+                Z[equations[i]] = v[i];
+            }
+        }
+        break;
+    case EIncompleteCholesky:
+        // U^T * y = r, then U * z = y.
+        Z = R;
+        for (int i = 0; i < fDim; i++) {
+            int64_t diag = fRowPtr[i];
+            double zi = Z[i] / fIncomplete[diag];
+            Z[i] = zi;
+            for (int64_t p = diag + 1; p < fRowPtr[i + 1]; p++) {
+                Z[fColumns[p]] -= fIncomplete[p] * zi;
+            }
+        }
+        for (int i = fDim - 1; i >= 0; i--) {
+            int64_t diag = fRowPtr[i];
+            double sum = Z[i];
+            for (int64_t p = diag + 1; p < fRowPtr[i + 1]; p++) {
+                sum -= fIncomplete[p] * Z[fColumns[p]];
+            }
+            Z[i] = sum / fIncomplete[diag];
+        }
+        break;
+    }
+}
+
+//! Solves the system for one or more right-hand sides.
+void TPCGSolver::solve(TPZFMatrix<double>& F) const
+{
+    if (F.Rows() != fDim) {
+        // Stops debug if the dimensions do not match.
+        DebugStop();
+    }
+
+    auto dot = [](const std::vector<double>& a, const std::vector<double>& b) {
+        double sum = 0.;
+        for (size_t i = 0; i < a.size(); i++) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    };
+
+    fIterations = 0;
+    fResidual = 0.;
+    std::vector<double> x(fDim), r(fDim), z(fDim), p(fDim), q(fDim);
+    for (int c = 0; c < (int)F.Cols(); c++) {
+        for (int i = 0; i < fDim; i++) {
+            r[i] = F(i, c);
+        }
+        std::fill(x.begin(), x.end(), 0.);
+        double normF = std::sqrt(dot(r, r));
+
+        int iteration = 0;
+        double residual = 0.;
+        if (normF > 0.) {
+            residual = 1.;
+            this->precondition(r, z);
+            p = z;
+            double rz = dot(r, z);
+            while (residual > fTolerance && iteration < fMaxIterations) {
+                this->multiply(p, q);
+                double alpha = rz / dot(p, q);
+                for (int i = 0; i < fDim; i++) {
+                    x[i] += alpha * p[i];
+                    r[i] -= alpha * q[i];
+                }
+                iteration++;
+                residual = std::sqrt(dot(r, r)) / normF;
+                if (residual <= fTolerance) break;
+
+                this->precondition(r, z);
+                double rzNew = dot(r, z);
+                double beta = rzNew / rz;
+                rz = rzNew;
+                for (int i = 0; i < fDim; i++) {
+                    p[i] = z[i] + beta * p[i];
+                }
+            }
+        }
+        fIterations = std::max(fIterations, iteration);
+        fResidual = std::max(fResidual, residual);
+
+        for (int i = 0; i < fDim; i++) {
+            F(i, c) = x[i];
+        }
+    }
+}
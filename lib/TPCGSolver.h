@@ -0,0 +1,147 @@
+/** \file TPCGSolver.h
+* Contains the declaration of the TPCGSolver class.
+*/
+
+#ifndef TPCGSOLVER_H
+#define TPCGSOLVER_H
+
+#include <vector>
+#include "TLinearSolver.h"
+
+//! Available preconditioners of the conjugate gradient method.
+enum EPreconditioner {
+    //! Diagonal of K11.
+    EJacobi,
+    //! Diagonal blocks of K11 coupling the equations of each node.
+    EBlockJacobi,
+    //! Incomplete Cholesky factorization with the pattern of K11, IC(0).
+    EIncompleteCholesky
+};
+
+//!  A class that solves K11 * Du = F by the preconditioned conjugate gradient method.
+/*!
+     A class that solves K11 * Du = F by the preconditioned conjugate
+	 gradient method. It only needs the products of K11 by vectors, so it
+	 keeps a copy of the upper triangle of K11 in compressed sparse row form
+	 and never stores a factorization with fill-in. Each right-hand side is
+	 iterated until its residual, relative to the right-hand side, drops
+	 below the tolerance or the iteration limit is reached; the iterations
+	 and the residual reached are reported afterwards.
+*/
+class TPCGSolver : public TLinearSolver
+{
+public:
+    //! Default constructor.
+    /*!
+    \param Preconditioner the preconditioner.
+    \param Tolerance the relative residual to be reached.
+    \param MaxIterations the maximum number of iterations for each right-hand side.
+    \return the new TPCGSolver object.
+    */
+    TPCGSolver(EPreconditioner Preconditioner = EJacobi,
+               double Tolerance = 1e-10, int MaxIterations = 10000);
+
+    //! Creates a copy of the solver, including its preconditioner.
+    TLinearSolver* clone() const override;
+
+    //! Gets the type of the solver.
+    ESolverType getType() const override;
+
+    //! Stores the matrix and builds the preconditioner.
+    void factorize(const TSparseBlock& K) override;
+
+    //! Solves the system for one or more right-hand sides.
+    void solve(TPZFMatrix<double>& F) const override;
+
+    //! Gets the number of entries stored by the preconditioner.
+    int64_t getFactorSize() const override;
+
+    //! Modifies the preconditioner, used from the next factorization on.
+    void setPreconditioner(EPreconditioner Preconditioner);
+
+    //! Gets the preconditioner.
+    EPreconditioner getPreconditioner() const;
+
+    //! Modifies the relative residual to be reached.
+    void setTolerance(double Tolerance);
+
+    //! Gets the relative residual to be reached.
+    double getTolerance() const;
+
+    //! Modifies the maximum number of iterations for each right-hand side.
+    void setMaxIterations(int MaxIterations);
+
+    //! Gets the maximum number of iterations for each right-hand side.
+    int getMaxIterations() const;
+
+    //! Modifies the blocks of the block Jacobi preconditioner.
+    /*!
+    \param Blocks the block of each equation. Equations with the same block
+    are coupled; negative blocks hold a single equation.
+    */
+    void setBlocks(const std::vector<int>& Blocks);
+
+    //! Gets the number of iterations of the last solve.
+    /*!
+    \return the largest number of iterations over the right-hand sides.
+    */
+    int getIterations() const;
+
+    //! Gets the residual reached by the last solve.
+    /*!
+    \return the largest residual norm over the right-hand sides, relative to
+    the norm of each right-hand side.
+    */
+    double getResidual() const;
+
+private:
+    //! The preconditioner.
+    EPreconditioner fPreconditioner;
+    //! The relative residual to be reached.
+    double fTolerance;
+    //! The maximum number of iterations for each right-hand side.
+    int fMaxIterations;
+    //! The block of each equation, for the block Jacobi preconditioner.
+    std::vector<int> fBlocks;
+
+    //! The dimension of the matrix.
+    int fDim;
+    //! The position of the first entry of each row of the upper triangle.
+    std::vector<int64_t> fRowPtr;
+    //! The sorted column of each entry of the upper triangle.
+    std::vector<int> fColumns;
+    //! The value of each entry of the upper triangle.
+    std::vector<double> fValues;
+
+    //! The inverse of the diagonal (Jacobi).
+    std::vector<double> fInvDiagonal;
+    //! The first position of each block in fBlockEquations, plus the total.
+    std::vector<int> fBlockPtr;
+    //! The equations of each block (block Jacobi).
+    std::vector<int> fBlockEquations;
+    //! The position of the Cholesky factor of each block in fBlockFactors.
+    std::vector<int64_t> fBlockFactorPtr;
+    //! The dense Cholesky factors of the diagonal blocks, by rows.
+    std::vector<double> fBlockFactors;
+    //! The incomplete factor U, with K11 ~ U^T * U and the pattern of fColumns.
+    std::vector<double> fIncomplete;
+
+    //! The iterations of the last solve.
+    mutable int fIterations;
+    //! The relative residual reached by the last solve.
+    mutable double fResidual;
+
+    //! Computes Y = K * X.
+    void multiply(const std::vector<double>& X, std::vector<double>& Y) const;
+
+    //! Computes Z = M^-1 * R, where M is the preconditioner.
+    void precondition(const std::vector<double>& R, std::vector<double>& Z) const;
+
+    //! Builds the block Jacobi preconditioner.
+    void buildBlockJacobi();
+
+    //! Builds the IC(0) preconditioner.
+    void buildIncompleteCholesky();
+};
+
+#endif // TPCGSOLVER_H
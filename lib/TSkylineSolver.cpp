@@ -0,0 +1,140 @@
+/** \file TSkylineSolver.cpp
+* Contains the definitions of the TSkylineSolver methods.
+*/
+
+#include <algorithm>
+#include "TSkylineSolver.h"
+
+//! Default constructor.
+TSkylineSolver::TSkylineSolver() : fDim(0), fDiagPtr(1, 0) {}
+
+//! Creates a copy of the solver, including its factorization.
+TLinearSolver* TSkylineSolver::clone() const
+{
+    return new TSkylineSolver(*this);
+}
+
+//! Gets the type of the solver.
+ESolverType TSkylineSolver::getType() const
+{
+    return ESkylineLDLt;
+}
+
+//! Gets the number of entries stored in the profile.
+int64_t TSkylineSolver::getFactorSize() const
+{
+    return (int64_t)fValues.size();
+}
+
+//! Factorizes a symmetric matrix and stores its factors.
+void TSkylineSolver::factorize(const TSparseBlock& K)
+{
+    fDim = K.Rows();
+    const int* columns = K.getMatrix()->getColumns();
+    const double* values = K.getMatrix()->getValues();
+    int col0 = K.getCol0();
+
+    // Finds the first nonzero row of each column of the upper triangle.
+    fFirstRow.resize(fDim);
+    for (int j = 0; j < fDim; j++) {
+        fFirstRow[j] = j;
+    }
+    for (int i = 0; i < fDim; i++) {
+        int64_t first, last;
+        K.getRowRange(i, first, last);
+        for (int64_t k = first; k < last; k++) {
+            int j = columns[k] - col0;
+            if (j > i && i < fFirstRow[j]) fFirstRow[j] = i;
+        }
+    }
+
+    // Entry (i, j) is stored at fDiagPtr[j] - (j - i).
+    fDiagPtr.resize(fDim + 1);
+    fDiagPtr[0] = 0;
+    for (int j = 0; j < fDim; j++) {
+        fDiagPtr[j + 1] = fDiagPtr[j] + (j - fFirstRow[j] + 1);
+    }
+    for (int j = 0; j < fDim; j++) {
+        fDiagPtr[j] = fDiagPtr[j + 1] - 1;
+    }
+    fValues.assign(fDim == 0 ? 0 : fDiagPtr[fDim - 1] + 1, 0.);
+
+    // Copies the upper triangle into the profile.
+    for (int i = 0; i < fDim; i++) {
+        int64_t first, last;
+        K.getRowRange(i, first, last);
+        for (int64_t k = first; k < last; k++) {
+            int j = columns[k] - col0;
+            if (j >= i) fValues[fDiagPtr[j] - (j - i)] = values[k];
+        }
+    }
+
+    // Active column LDLt factorization. colJ[i - firstJ] is entry (i, j).
+    for (int j = 0; j < fDim; j++) {
+        int firstJ = fFirstRow[j];
+        double* colJ = &fValues[fDiagPtr[j] - (j - firstJ)];
+
+        // Reduces the off-diagonal entries of column j: g_ij = a_ij - sum
+        // l_ki * g_kj, over the rows k shared by the profiles of i and j.
+        for (int i = firstJ + 1; i < j; i++) {
+            int firstI = fFirstRow[i];
+            const double* colI = &fValues[fDiagPtr[i] - (i - firstI)];
+            int k0 = std::max(firstI, firstJ);
+            double sum = 0.;
+            for (int k = k0; k < i; k++) {
+                sum += colI[k - firstI] * colJ[k - firstJ];
+            }
+            colJ[i - firstJ] -= sum;
+        }
+
+        // Scales them by the pivots and updates the diagonal.
+        double diag = colJ[j - firstJ];
+        for (int i = firstJ; i < j; i++) {
+            double g = colJ[i - firstJ];
+            colJ[i - firstJ] = g / fValues[fDiagPtr[i]];
+            diag -= colJ[i - firstJ] * g;
+        }
+        if (diag <= 0.) {
+            // Stops debug if K11 is not positive definite (unstable structure).
+            DebugStop();
+        }
+        colJ[j - firstJ] = diag;
+    }
+}
+
+//! Solves the factorized system for one or more right-hand sides.
+void TSkylineSolver::solve(TPZFMatrix<double>& F) const
+{
+    if (F.Rows() != fDim) {
+        // Stops debug if the dimensions do not match.
+        DebugStop();
+    }
+
+    for (int c = 0; c < (int)F.Cols(); c++) {
+        // Forward substitution L * y = f.
+        for (int j = 0; j < fDim; j++) {
+            int firstJ = fFirstRow[j];
+            const double* colJ = &fValues[fDiagPtr[j] - (j - firstJ)];
+            double sum = 0.;
+            for (int i = firstJ; i < j; i++) {
+                sum += colJ[i - firstJ] * F(i, c);
+            }
+            F(j, c) -= sum;
+        }
+
+        // Diagonal scaling D * z = y.
+        for (int j = 0; j < fDim; j++) {
+            F(j, c) /= fValues[fDiagPtr[j]];
+        }
+
+        // Back substitution L^T * x = z.
+        for (int j = fDim - 1; j >= 0; j--) {
+            int firstJ = fFirstRow[j];
+            const double* colJ = &fValues[fDiagPtr[j] - (j - firstJ)];
+            double xj = F(j, c);
+            for (int i = firstJ; i < j; i++) {
+                F(i, c) -= colJ[i - firstJ] * xj;
+            }
+        }
+    }
+}
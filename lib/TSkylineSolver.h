@@ -0,0 +1,56 @@
+/** \file TSkylineSolver.h
+* Contains the declaration of the TSkylineSolver class.
+*/
+
+#ifndef TSKYLINESOLVER_H
+#define TSKYLINESOLVER_H
+
+#include <vector>
+#include "TLinearSolver.h"
+
+//!  A class that solves K11 * Du = F by a skyline LDLt factorization.
+/*!
+     A class that solves K11 * Du = F by an LDLt factorization of the matrix
+	 stored in skyline (variable band) form. Only the upper triangle of each
+	 column, from its first nonzero row down to the diagonal, is stored, and
+	 the factors fill in only inside that profile. The cost is about
+	 O(n * b^2) for a matrix of dimension n and mean bandwidth b, so it pays
+	 off together with a bandwidth-reducing equation numbering.
+*/
+class TSkylineSolver : public TLinearSolver
+{
+public:
+    //! Default constructor.
+    TSkylineSolver();
+
+    //! Creates a copy of the solver, including its factorization.
+    TLinearSolver* clone() const override;
+
+    //! Gets the type of the solver.
+    ESolverType getType() const override;
+
+    //! Factorizes a symmetric matrix and stores its factors.
+    void factorize(const TSparseBlock& K) override;
+
+    //! Solves the factorized system for one or more right-hand sides.
+    void solve(TPZFMatrix<double>& F) const override;
+
+    //! Gets the number of entries stored in the profile.
+    int64_t getFactorSize() const override;
+
+private:
+    //! The dimension of the matrix.
+    int fDim;
+    //! The first stored row of each column.
+    std::vector<int> fFirstRow;
+    //! The position of the diagonal entry of each column, plus the total count.
+    std::vector<int64_t> fDiagPtr;
+    //! The stored entries of each column, from the first row to the diagonal.
+    /*!
+    After the factorization, the diagonal entries hold D and the others hold
+    the entries of L^T.
+    */
+    std::vector<double> fValues;
+};
+
+#endif // TSKYLINESOLVER_H
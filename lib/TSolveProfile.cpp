@@ -0,0 +1,237 @@
+/** \file TSolveProfile.cpp
+* Contains the definitions of the TSolveProfile and TPhaseTimer methods.
+*/
+
+#include <cstdlib>
+#include <new>
+#include "TSolveProfile.h"
+
+#ifdef JSTATICS_COUNT_ALLOCATIONS
+
+namespace {
+// gAllocatedBytes - bytes requested by operator new in the current thread.
+thread_local int64_t gAllocatedBytes = 0;
+}
+
+// Replaces the global operator new to count the requested bytes. The array
+// and nothrow forms are replaced too, since the standard library is not
+// required to route them through this one, and the deletes release with
+// free(). The over-aligned forms keep their default definitions.
+void* operator new(std::size_t Size)
+{
+    gAllocatedBytes += (int64_t)Size;
+    void* pointer = std::malloc(Size ? Size : 1);
+    if (pointer == nullptr) throw std::bad_alloc();
+    return pointer;
+}
+
+void* operator new[](std::size_t Size)
+{
+    return operator new(Size);
+}
+
+void* operator new(std::size_t Size, const std::nothrow_t&) noexcept
+{
+    gAllocatedBytes += (int64_t)Size;
+    return std::malloc(Size ? Size : 1);
+}
+
+void* operator new[](std::size_t Size, const std::nothrow_t& Tag) noexcept
+{
+    return operator new(Size, Tag);
+}
+
+void operator delete(void* Pointer) noexcept
+{
+    std::free(Pointer);
+}
+
+void operator delete[](void* Pointer) noexcept
+{
+    std::free(Pointer);
+}
+
+void operator delete(void* Pointer, std::size_t) noexcept
+{
+    std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, std::size_t) noexcept
+{
+    std::free(Pointer);
+}
+
+void operator delete(void* Pointer, const std::nothrow_t&) noexcept
+{
+    std::free(Pointer);
+}
+
+void operator delete[](void* Pointer, const std::nothrow_t&) noexcept
+{
+    std::free(Pointer);
+}
+
+//! Gets the number of bytes allocated so far by the calling thread.
+int64_t getAllocatedBytes()
+{
+    return gAllocatedBytes;
+}
+
+//! Adds to the number of bytes allocated by the calling thread.
+void addAllocatedBytes(int64_t Bytes)
+{
+    gAllocatedBytes += Bytes;
+}
+
+//! Checks if the library counts the allocated bytes (see getAllocatedBytes()).
+bool isCountingAllocations()
+{
+    return true;
+}
+
+#else
+
+//! Gets the number of bytes allocated so far by the calling thread.
+int64_t getAllocatedBytes()
+{
+    return 0;
+}
+
+//! Adds to the number of bytes allocated by the calling thread.
+void addAllocatedBytes(int64_t)
+{
+}
+
+//! Checks if the library counts the allocated bytes (see getAllocatedBytes()).
+bool isCountingAllocations()
+{
+    return false;
+}
+
+#endif
+
+//! Default constructor.
+TSolveProfile::TSolveProfile()
+{
+    reset();
+}
+
+//! Zeroes every phase.
+void TSolveProfile::reset()
+{
+    for (int i = 0; i < ENSolvePhases; i++) {
+        fSeconds[i] = 0.;
+        fCalls[i] = 0;
+        fBytes[i] = 0;
+    }
+}
+
+//! Adds one call of a phase.
+void TSolveProfile::addCall(ESolvePhase Phase, double Seconds, int64_t Bytes)
+{
+    fSeconds[Phase] += Seconds;
+    fCalls[Phase]++;
+    fBytes[Phase] += Bytes;
+}
+
+//! Adds the phases of another profile to this one.
+void TSolveProfile::add(const TSolveProfile& Other)
+{
+    for (int i = 0; i < ENSolvePhases; i++) {
+        fSeconds[i] += Other.fSeconds[i];
+        fCalls[i] += Other.fCalls[i];
+        fBytes[i] += Other.fBytes[i];
+    }
+}
+
+//! Gets the accumulated wall time of a phase, in seconds.
+double TSolveProfile::getSeconds(ESolvePhase Phase) const
+{
+    return fSeconds[Phase];
+}
+
+//! Gets the number of calls of a phase.
+int64_t TSolveProfile::getCalls(ESolvePhase Phase) const
+{
+    return fCalls[Phase];
+}
+
+//! Gets the accumulated bytes allocated by a phase.
+int64_t TSolveProfile::getBytes(ESolvePhase Phase) const
+{
+    return fBytes[Phase];
+}
+
+//! Gets the accumulated wall time of all phases, in seconds.
+double TSolveProfile::getTotalSeconds() const
+{
+    double total = 0.;
+    for (int i = 0; i < ENSolvePhases; i++) {
+        total += fSeconds[i];
+    }
+    return total;
+}
+
+//! Gets the name of a phase, as used in the JSON report.
+const char* TSolveProfile::getPhaseName(ESolvePhase Phase)
+{
+    switch (Phase) {
+    case EEnumerateEquations:
+        return "enumerateEquations";
+    case EPopulateK:
+        return "populateK";
+    case EPopulateQ:
+        return "populateQ";
+    case EPopulateQ0:
+        return "populateQ0";
+    case ESolveDU:
+        return "solveDU";
+    case ESolveQU:
+        return "solveQU";
+    case EInternalLoads:
+        return "internalLoads";
+    default:
+        return "";
+    }
+}
+
+//! Prints the profile as a JSON object.
+void TSolveProfile::printJSON(std::ostream& out) const
+{
+    // Without counting, the bytes are null so they do not read as zero.
+    bool counted = isCountingAllocations();
+    std::streamsize precision = out.precision(9);
+    out << "{" << std::endl;
+    out << "    \"phases\": [" << std::endl;
+    for (int i = 0; i < ENSolvePhases; i++) {
+        out << "        {\"name\": \"" << getPhaseName((ESolvePhase)i)
+            << "\", \"calls\": " << fCalls[i] << ", \"seconds\": " << fSeconds[i]
+            << ", \"bytes\": ";
+        if (counted) {
+            out << fBytes[i];
+        } else {
+            out << "null";
+        }
+        out << "}" << (i + 1 < ENSolvePhases ? "," : "") << std::endl;
+    }
+    out << "    ]," << std::endl;
+    out << "    \"totalSeconds\": " << getTotalSeconds() << "," << std::endl;
+    out << "    \"bytesCounted\": " << (counted ? "true" : "false") << std::endl;
+    out << "}" << std::endl;
+    out.precision(precision);
+}
+
+//! Default constructor.
+TPhaseTimer::TPhaseTimer(TSolveProfile& Profile, ESolvePhase Phase)
+    : fProfile(Profile),
+      fPhase(Phase),
+      fStart(std::chrono::steady_clock::now()),
+      fStartBytes(getAllocatedBytes()) {}
+
+//! Destructor.
+TPhaseTimer::~TPhaseTimer()
+{
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - fStart).count();
+    fProfile.addCall(fPhase, seconds, getAllocatedBytes() - fStartBytes);
+}
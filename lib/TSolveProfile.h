@@ -0,0 +1,147 @@
+/** \file TSolveProfile.h
+* Contains the declaration of the TSolveProfile and TPhaseTimer classes.
+*/
+
+#ifndef TSOLVEPROFILE_H
+#define TSOLVEPROFILE_H
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+//! The phases of TStructure::solve that are measured.
+enum ESolvePhase {
+    //! Enumeration of the degrees of freedom.
+    EEnumerateEquations,
+    //! Assembly of the stiffness matrix K.
+    EPopulateK,
+    //! Assembly of the load vector Q.
+    EPopulateQ,
+    //! Assembly of the equivalent nodal loads Q0.
+    EPopulateQ0,
+    //! Factorization of K11 and solution of the unknown displacements Du.
+    ESolveDU,
+    //! Solution of the support reactions Qu.
+    ESolveQU,
+    //! Calculation of the internal loads of the elements.
+    EInternalLoads,
+    //! The number of phases.
+    ENSolvePhases
+};
+
+//! Gets the number of bytes allocated so far by the calling thread.
+/*!
+The allocations are counted only when the library is built with
+JSTATICS_COUNT_ALLOCATIONS, which replaces the global operator new of every
+program linked to it; otherwise, zero is returned. Over-aligned allocations
+are not counted. The allocations of the tasks that the thread handed to the
+pool of parallelFor() and parallelForEach() are added to it when they finish.
+\return the total size of the memory requested by operator new.
+*/
+int64_t getAllocatedBytes();
+
+//! Adds to the number of bytes allocated by the calling thread.
+/*!
+Moves the allocations of a task run on another thread to the thread it was
+run for. It does nothing when the allocations are not counted.
+\param Bytes the bytes to be added, negative to remove them.
+*/
+void addAllocatedBytes(int64_t Bytes);
+
+//! Checks if the library counts the allocated bytes (see getAllocatedBytes()).
+bool isCountingAllocations();
+
+//!  A class that accumulates the cost of each phase of a solve.
+/*!
+     A class that accumulates, for each phase of TStructure::solve, the wall
+	 time, the number of calls and the bytes allocated by the calling thread.
+	 The values add up over successive solves until reset() is called.
+*/
+class TSolveProfile {
+public:
+    //! Default constructor.
+    /*!
+    \return the new TSolveProfile object, with every phase zeroed.
+    */
+    TSolveProfile();
+
+    //! Zeroes every phase.
+    void reset();
+
+    //! Adds one call of a phase.
+    /*!
+    \param Phase the phase.
+    \param Seconds the wall time of the call.
+    \param Bytes the bytes allocated during the call.
+    */
+    void addCall(ESolvePhase Phase, double Seconds, int64_t Bytes);
+
+    //! Adds the phases of another profile to this one.
+    /*!
+    \param Other the profile to be added.
+    */
+    void add(const TSolveProfile& Other);
+
+    //! Gets the accumulated wall time of a phase, in seconds.
+    double getSeconds(ESolvePhase Phase) const;
+    //! Gets the number of calls of a phase.
+    int64_t getCalls(ESolvePhase Phase) const;
+    //! Gets the accumulated bytes allocated by a phase.
+    int64_t getBytes(ESolvePhase Phase) const;
+    //! Gets the accumulated wall time of all phases, in seconds.
+    double getTotalSeconds() const;
+
+    //! Gets the name of a phase, as used in the JSON report.
+    static const char* getPhaseName(ESolvePhase Phase);
+
+    //! Prints the profile as a JSON object.
+    /*!
+    The object has a "phases" array, with the name, calls, seconds and bytes
+    of each phase, the "totalSeconds" of all of them and "bytesCounted". When
+    the allocations are not counted (see isCountingAllocations()),
+    "bytesCounted" is false and the bytes of each phase are null.
+    \param out the stream the report is printed to.
+    */
+    void printJSON(std::ostream& out) const;
+
+private:
+    //! The accumulated wall time of each phase.
+    double fSeconds[ENSolvePhases];
+    //! The number of calls of each phase.
+    int64_t fCalls[ENSolvePhases];
+    //! The accumulated bytes allocated by each phase.
+    int64_t fBytes[ENSolvePhases];
+};
+
+//!  A class that measures a phase for as long as it is in scope.
+/*!
+     A class that reads the clock and the allocation counter when it is
+	 created and adds the differences to a TSolveProfile when it is destroyed.
+*/
+class TPhaseTimer {
+public:
+    //! Default constructor.
+    /*!
+    \param Profile the profile that receives the measures.
+    \param Phase the phase being measured.
+    \return the new TPhaseTimer object.
+    */
+    TPhaseTimer(TSolveProfile& Profile, ESolvePhase Phase);
+    //! Destructor.
+    ~TPhaseTimer();
+
+    TPhaseTimer(const TPhaseTimer&) = delete;
+    TPhaseTimer& operator=(const TPhaseTimer&) = delete;
+
+private:
+    //! The profile that receives the measures.
+    TSolveProfile& fProfile;
+    //! The phase being measured.
+    ESolvePhase fPhase;
+    //! The time when the phase started.
+    std::chrono::steady_clock::time_point fStart;
+    //! The allocated bytes when the phase started.
+    int64_t fStartBytes;
+};
+
+#endif // TSOLVEPROFILE_H
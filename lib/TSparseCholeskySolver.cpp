@@ -0,0 +1,529 @@
+/** \file TSparseCholeskySolver.cpp
+* Contains the definitions of the TSparseCholeskySolver methods.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include "TSparseCholeskySolver.h"
+#include "Renumbering.h"
+
+namespace {
+
+//! Computes the lower triangle of C = A * B^T for a supernode update.
+/*!
+A holds the rows [Row0, Rows) of the NCols columns of a column-major block
+with leading dimension LD; B is made of its first M1 rows. C is M x M1,
+column-major, and its entries on and below the diagonal are computed. The
+columns of C are computed four at a time, so each entry of A is loaded once
+for four products.
+*/
+void updateProduct(const double* Block, int LD, int NCols, int Row0, int Rows,
+                   int M1, std::vector<double>& C)
+{
+    int m = Rows - Row0;
+    C.assign((size_t)m * M1, 0.);
+    int c = 0;
+    for (; c + 4 <= M1; c += 4) {
+        double* c0 = &C[(size_t)c * m];
+        double* c1 = c0 + m;
+        double* c2 = c1 + m;
+        double* c3 = c2 + m;
+        for (int k = 0; k < NCols; k++) {
+            const double* colK = Block + (int64_t)k * LD + Row0;
+            double b0 = colK[c], b1 = colK[c + 1];
+            double b2 = colK[c + 2], b3 = colK[c + 3];
+            for (int r = c; r < m; r++) {
+                double a = colK[r];
+                c0[r] += a * b0;
+                c1[r] += a * b1;
+                c2[r] += a * b2;
+                c3[r] += a * b3;
+            }
+        }
+    }
+    for (; c < M1; c++) {
+        double* colC = &C[(size_t)c * m];
+        for (int k = 0; k < NCols; k++) {
+            const double* colK = Block + (int64_t)k * LD + Row0;
+            double b = colK[c];
+            for (int r = c; r < m; r++) {
+                colC[r] += colK[r] * b;
+            }
+        }
+    }
+}
+
+//! Factorizes the diagonal block of a supernode and solves its rows below.
+/*!
+The first NCols rows of the column-major block, with leading dimension
+Rows, hold the diagonal block, which is replaced by its Cholesky factor; the
+rows below are replaced by the solution of X * L^T = B.
+*/
+void factorPanel(double* Block, int Rows, int NCols)
+{
+    for (int j = 0; j < NCols; j++) {
+        double* colJ = Block + (int64_t)j * Rows;
+        if (colJ[j] <= 0.) {
+            // Stops debug if K11 is not positive definite (unstable structure).
+            DebugStop();
+        }
+        double diag = std::sqrt(colJ[j]);
+        colJ[j] = diag;
+        for (int r = j + 1; r < Rows; r++) {
+            colJ[r] /= diag;
+        }
+        for (int c = j + 1; c < NCols; c++) {
+            double* colC = Block + (int64_t)c * Rows;
+            double t = colJ[c];
+            if (t == 0.) continue;
+            for (int r = c; r < Rows; r++) {
+                colC[r] -= colJ[r] * t;
+            }
+        }
+    }
+}
+
+//! Builds the elimination tree of a matrix from the rows of its lower triangle.
+std::vector<int> eliminationTree(int Dim, const std::vector<int64_t>& RowPtr,
+                                 const std::vector<int>& ColInd)
+{
+    std::vector<int> parent(Dim, -1), ancestor(Dim, -1);
+    for (int k = 0; k < Dim; k++) {
+        for (int64_t p = RowPtr[k]; p < RowPtr[k + 1]; p++) {
+            // Follows the path from the column to the root of its subtree,
+            // compressing it towards k.
+            int i = ColInd[p];
+            while (i != -1 && i < k) {
+                int next = ancestor[i];
+                ancestor[i] = k;
+                if (next == -1) parent[i] = k;
+                i = next;
+            }
+        }
+    }
+    return parent;
+}
+
+} // namespace
+
+//! Default constructor.
+TSparseCholeskySolver::TSparseCholeskySolver(ESolverType Type)
+    : fType(Type),
+      fDim(0),
+      fMatrixSize(0),
+      fSuperPtr(1, 0),
+      fRowPtr(1, 0),
+      fValuePtr(1, 0) {}
+
+//! Creates a copy of the solver, including its factorization.
+TLinearSolver* TSparseCholeskySolver::clone() const
+{
+    return new TSparseCholeskySolver(*this);
+}
+
+//! Gets the type of the solver.
+ESolverType TSparseCholeskySolver::getType() const
+{
+    return fType;
+}
+
+//! Gets the number of entries stored in the factors.
+int64_t TSparseCholeskySolver::getFactorSize() const
+{
+    int64_t size = 0;
+    for (int s = 0; s < this->getNSupernodes(); s++) {
+        int64_t nCols = fSuperPtr[s + 1] - fSuperPtr[s];
+        int64_t nRows = fRowPtr[s + 1] - fRowPtr[s];
+        size += nCols * (nCols + 1) / 2 + nCols * (nRows - nCols);
+    }
+    return size;
+}
+
+//! Gets the fill-in of the factorization.
+int64_t TSparseCholeskySolver::getFillIn() const
+{
+    return this->getFactorSize() - fMatrixSize;
+}
+
+//! Gets the number of supernodes of L.
+int TSparseCholeskySolver::getNSupernodes() const
+{
+    return (int)fSuperPtr.size() - 1;
+}
+
+//! Builds the ordering and the structure of L of a matrix.
+void TSparseCholeskySolver::analyze(const TSparseBlock& K,
+                                    std::vector<int64_t>& ColPtr,
+                                    std::vector<int>& RowInd,
+                                    std::vector<double>& Values)
+{
+    int n = fDim;
+    const int* columns = K.getMatrix()->getColumns();
+    const double* values = K.getMatrix()->getValues();
+    int col0 = K.getCol0();
+
+    // Collects the upper triangle (i <= j) of the block. A symmetric matrix
+    // stores only these entries; otherwise the lower ones are skipped.
+    std::vector<int> upperI, upperJ;
+    std::vector<double> upperValues;
+    for (int i = 0; i < n; i++) {
+        int64_t first, last;
+        K.getRowRange(i, first, last);
+        for (int64_t k = first; k < last; k++) {
+            int j = columns[k] - col0;
+            if (j < i) continue;
+            upperI.push_back(i);
+            upperJ.push_back(j);
+            upperValues.push_back(values[k]);
+        }
+    }
+    int64_t nEntries = (int64_t)upperI.size();
+    fMatrixSize = nEntries;
+
+    // Graph of the matrix, without the diagonal.
+    std::vector<int> adjPtr(n + 1, 0);
+    for (int64_t k = 0; k < nEntries; k++) {
+        if (upperI[k] == upperJ[k]) continue;
+        adjPtr[upperI[k] + 1]++;
+        adjPtr[upperJ[k] + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        adjPtr[v + 1] += adjPtr[v];
+    }
+    std::vector<int> adj(adjPtr[n]);
+    std::vector<int> next(adjPtr.begin(), adjPtr.end() - 1);
+    for (int64_t k = 0; k < nEntries; k++) {
+        if (upperI[k] == upperJ[k]) continue;
+        adj[next[upperI[k]]++] = upperJ[k];
+        adj[next[upperJ[k]]++] = upperI[k];
+    }
+
+    // Fill-reducing ordering.
+    std::vector<int> order = (fType == ESparseCholeskyND)
+                                 ? nestedDissection(adjPtr, adj)
+                                 : approximateMinimumDegree(adjPtr, adj);
+
+    // Builds the rows (and, if requested, the columns) of the lower triangle
+    // of the matrix permuted by fPerm.
+    std::vector<int> inverse(n);
+    std::vector<int64_t> rowPtr;
+    std::vector<int> colInd;
+    auto permute = [&](bool BuildColumns) {
+        for (int k = 0; k < n; k++) {
+            inverse[fPerm[k]] = k;
+        }
+        rowPtr.assign(n + 1, 0);
+        ColPtr.assign(n + 1, 0);
+        for (int64_t k = 0; k < nEntries; k++) {
+            int a = inverse[upperI[k]];
+            int b = inverse[upperJ[k]];
+            rowPtr[std::max(a, b) + 1]++;
+            ColPtr[std::min(a, b) + 1]++;
+        }
+        for (int k = 0; k < n; k++) {
+            rowPtr[k + 1] += rowPtr[k];
+            ColPtr[k + 1] += ColPtr[k];
+        }
+        colInd.resize(nEntries);
+        std::vector<int64_t> rowNext(rowPtr.begin(), rowPtr.end() - 1);
+        for (int64_t k = 0; k < nEntries; k++) {
+            int a = inverse[upperI[k]];
+            int b = inverse[upperJ[k]];
+            colInd[rowNext[std::max(a, b)]++] = std::min(a, b);
+        }
+        if (!BuildColumns) return;
+        RowInd.resize(nEntries);
+        Values.resize(nEntries);
+        std::vector<int64_t> colNext(ColPtr.begin(), ColPtr.end() - 1);
+        for (int64_t k = 0; k < nEntries; k++) {
+            int a = inverse[upperI[k]];
+            int b = inverse[upperJ[k]];
+            int64_t pos = colNext[std::min(a, b)]++;
+            RowInd[pos] = std::max(a, b);
+            Values[pos] = upperValues[k];
+        }
+    };
+    fPerm = order;
+    permute(false);
+
+    // Postorders the elimination tree, so that the columns of each subtree,
+    // and of each supernode, are consecutive.
+    std::vector<int> parent = eliminationTree(n, rowPtr, colInd);
+    std::vector<int> firstChild(n, -1), sibling(n, -1);
+    for (int j = n - 1; j >= 0; j--) {
+        if (parent[j] == -1) continue;
+        sibling[j] = firstChild[parent[j]];
+        firstChild[parent[j]] = j;
+    }
+    std::vector<int> post;
+    post.reserve(n);
+    std::vector<int> stack;
+    for (int root = 0; root < n; root++) {
+        if (parent[root] != -1) continue;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            int j = stack.back();
+            if (firstChild[j] != -1) {
+                // Descends into the next unvisited child.
+                int child = firstChild[j];
+                firstChild[j] = sibling[child];
+                stack.push_back(child);
+            }
+            else {
+                stack.pop_back();
+                post.push_back(j);
+            }
+        }
+    }
+    for (int k = 0; k < n; k++) {
+        fPerm[k] = order[post[k]];
+    }
+    permute(true);
+    parent = eliminationTree(n, rowPtr, colInd);
+
+    // Counts the entries below the diagonal of each column of L: row k of L
+    // holds the columns of the row subtree of k, reached by walking up the
+    // tree from the columns of row k of the matrix.
+    std::vector<int> count(n, 0), mark(n, -1);
+    for (int k = 0; k < n; k++) {
+        mark[k] = k;
+        for (int64_t p = rowPtr[k]; p < rowPtr[k + 1]; p++) {
+            for (int t = colInd[p]; mark[t] != k; t = parent[t]) {
+                mark[t] = k;
+                count[t]++;
+            }
+        }
+    }
+
+    // Fundamental supernodes: column j + 1 joins the supernode of column j
+    // if j is its only child and their structures match.
+    std::vector<int> nChildren(n, 0);
+    for (int j = 0; j < n; j++) {
+        if (parent[j] != -1) nChildren[parent[j]]++;
+    }
+    std::vector<int> fundamental(1, 0);
+    for (int j = 1; j < n; j++) {
+        if (!(parent[j - 1] == j && count[j - 1] == count[j] + 1 &&
+              nChildren[j] == 1)) {
+            fundamental.push_back(j);
+        }
+    }
+    fundamental.push_back(n);
+
+    // Relaxed supernodes: a supernode is merged with its parent when they are
+    // consecutive and the explicit zeros stored by the merged block stay few.
+    // Frame nodes give supernodes of only three columns, too narrow for the
+    // dense kernels to pay off.
+    fSuperPtr.assign(1, 0);
+    int64_t groupEntries = 0;
+    for (int f = 0; f + 1 < (int)fundamental.size(); f++) {
+        int first = fundamental[f];
+        int last = fundamental[f + 1];
+        int64_t entries = 0;
+        for (int j = first; j < last; j++) {
+            entries += count[j] + 1;
+        }
+        int groupFirst = fSuperPtr.back();
+        if (groupFirst < first && parent[first - 1] >= first &&
+            parent[first - 1] < last) {
+            int64_t nCols = last - groupFirst;
+            int64_t below = count[last - 1];
+            int64_t stored = nCols * (nCols + 1) / 2 + nCols * below;
+            double zeros = 1. - (double)(groupEntries + entries) / stored;
+            bool merge = (nCols <= 4) || (nCols <= 16 && zeros < 0.8) ||
+                         (nCols <= 48 && zeros < 0.1) || (zeros < 0.05);
+            if (merge) {
+                groupEntries += entries;
+                continue;
+            }
+        }
+        if (first > 0) fSuperPtr.push_back(first);
+        groupEntries = entries;
+    }
+    if (n > 0) fSuperPtr.push_back(n);
+    int nSuper = this->getNSupernodes();
+    std::vector<int> superOf(n);
+    for (int s = 0; s < nSuper; s++) {
+        std::fill(superOf.begin() + fSuperPtr[s],
+                  superOf.begin() + fSuperPtr[s + 1], s);
+    }
+
+    // Rows of each supernode: its own columns, then the rows of the structure
+    // of its last column, which holds those of the other columns beyond the
+    // supernode. They are found in increasing order by a second pass over
+    // the row subtrees.
+    fRowPtr.assign(nSuper + 1, 0);
+    fValuePtr.assign(nSuper + 1, 0);
+    for (int s = 0; s < nSuper; s++) {
+        int nCols = fSuperPtr[s + 1] - fSuperPtr[s];
+        int nRows = nCols + count[fSuperPtr[s + 1] - 1];
+        fRowPtr[s + 1] = fRowPtr[s] + nRows;
+        fValuePtr[s + 1] = fValuePtr[s] + (int64_t)nRows * nCols;
+    }
+    fRows.resize(fRowPtr[nSuper]);
+    std::vector<int64_t> rowNext(nSuper);
+    std::vector<int> lastRow(nSuper, -1);
+    for (int s = 0; s < nSuper; s++) {
+        int64_t pos = fRowPtr[s];
+        for (int j = fSuperPtr[s]; j < fSuperPtr[s + 1]; j++) {
+            fRows[pos++] = j;
+        }
+        rowNext[s] = pos;
+    }
+    std::fill(mark.begin(), mark.end(), -1);
+    for (int k = 0; k < n; k++) {
+        mark[k] = k;
+        for (int64_t p = rowPtr[k]; p < rowPtr[k + 1]; p++) {
+            for (int t = colInd[p]; mark[t] != k; t = parent[t]) {
+                mark[t] = k;
+                int s = superOf[t];
+                if (k >= fSuperPtr[s + 1] && lastRow[s] != k) {
+                    lastRow[s] = k;
+                    fRows[rowNext[s]++] = k;
+                }
+            }
+        }
+    }
+}
+
+//! Factorizes a symmetric matrix and stores its factors.
+void TSparseCholeskySolver::factorize(const TSparseBlock& K)
+{
+    fDim = K.Rows();
+    std::vector<int64_t> colPtr;
+    std::vector<int> rowInd;
+    std::vector<double> values;
+    this->analyze(K, colPtr, rowInd, values);
+
+    int nSuper = this->getNSupernodes();
+    fValues.assign(fValuePtr[nSuper], 0.);
+    std::vector<int> superOf(fDim);
+    for (int s = 0; s < nSuper; s++) {
+        std::fill(superOf.begin() + fSuperPtr[s],
+                  superOf.begin() + fSuperPtr[s + 1], s);
+    }
+
+    // Left-looking factorization. Each factorized supernode is linked to the
+    // next supernode its rows update; linkPos is the first of those rows.
+    std::vector<int> head(nSuper, -1), link(nSuper, -1), linkPos(nSuper, 0);
+    std::vector<int> relative(fDim);
+    std::vector<double> product;
+    for (int s = 0; s < nSuper; s++) {
+        int first = fSuperPtr[s];
+        int last = fSuperPtr[s + 1];
+        int nCols = last - first;
+        int nRows = (int)(fRowPtr[s + 1] - fRowPtr[s]);
+        const int* rows = &fRows[fRowPtr[s]];
+        double* block = &fValues[fValuePtr[s]];
+        for (int r = 0; r < nRows; r++) {
+            relative[rows[r]] = r;
+        }
+
+        // Copies the columns of the matrix into the block.
+        for (int j = first; j < last; j++) {
+            double* colJ = block + (int64_t)(j - first) * nRows;
+            for (int64_t p = colPtr[j]; p < colPtr[j + 1]; p++) {
+                colJ[relative[rowInd[p]]] += values[p];
+            }
+        }
+
+        // Subtracts the updates of the descendant supernodes.
+        int d = head[s];
+        while (d != -1) {
+            int nextD = link[d];
+            int dCols = fSuperPtr[d + 1] - fSuperPtr[d];
+            int dRows = (int)(fRowPtr[d + 1] - fRowPtr[d]);
+            const int* dIndexes = &fRows[fRowPtr[d]];
+            const double* dBlock = &fValues[fValuePtr[d]];
+
+            int r1 = linkPos[d];
+            int r2 = r1;
+            while (r2 < dRows && dIndexes[r2] < last) {
+                r2++;
+            }
+            int m = dRows - r1;
+            int m1 = r2 - r1;
+            updateProduct(dBlock, dRows, dCols, r1, dRows, m1, product);
+            for (int c = 0; c < m1; c++) {
+                double* colS = block + (int64_t)(dIndexes[r1 + c] - first) * nRows;
+                const double* colP = &product[(size_t)c * m];
+                for (int r = c; r < m; r++) {
+                    colS[relative[dIndexes[r1 + r]]] -= colP[r];
+                }
+            }
+
+            // Moves the supernode to the list of the next one it updates.
+            linkPos[d] = r2;
+            if (r2 < dRows) {
+                int t = superOf[dIndexes[r2]];
+                link[d] = head[t];
+                head[t] = d;
+            }
+            d = nextD;
+        }
+
+        factorPanel(block, nRows, nCols);
+
+        if (nRows > nCols) {
+            int t = superOf[rows[nCols]];
+            linkPos[s] = nCols;
+            link[s] = head[t];
+            head[t] = s;
+        }
+    }
+}
+
+//! Solves the factorized system for one or more right-hand sides.
+void TSparseCholeskySolver::solve(TPZFMatrix<double>& F) const
+{
+    if (F.Rows() != fDim) {
+        // Stops debug if the dimensions do not match.
+        DebugStop();
+    }
+
+    int nSuper = this->getNSupernodes();
+    std::vector<double> x(fDim);
+    for (int c = 0; c < (int)F.Cols(); c++) {
+        for (int k = 0; k < fDim; k++) {
+            x[k] = F(fPerm[k], c);
+        }
+
+        // Forward substitution L * y = P * f.
+        for (int s = 0; s < nSuper; s++) {
+            int first = fSuperPtr[s];
+            int nCols = fSuperPtr[s + 1] - first;
+            int nRows = (int)(fRowPtr[s + 1] - fRowPtr[s]);
+            const int* rows = &fRows[fRowPtr[s]];
+            const double* block = &fValues[fValuePtr[s]];
+            for (int j = 0; j < nCols; j++) {
+                const double* colJ = block + (int64_t)j * nRows;
+                double xj = x[first + j] / colJ[j];
+                x[first + j] = xj;
+                for (int r = j + 1; r < nRows; r++) {
+                    x[rows[r]] -= colJ[r] * xj;
+                }
+            }
+        }
+
+        // Back substitution L^T * z = y.
+        for (int s = nSuper - 1; s >= 0; s--) {
+            int first = fSuperPtr[s];
+            int nCols = fSuperPtr[s + 1] - first;
+            int nRows = (int)(fRowPtr[s + 1] - fRowPtr[s]);
+            const int* rows = &fRows[fRowPtr[s]];
+            const double* block = &fValues[fValuePtr[s]];
+            for (int j = nCols - 1; j >= 0; j--) {
+                const double* colJ = block + (int64_t)j * nRows;
+                double sum = x[first + j];
+                for (int r = j + 1; r < nRows; r++) {
+                    sum -= colJ[r] * x[rows[r]];
+                }
+                x[first + j] = sum / colJ[j];
+            }
+        }
+
+        for (int k = 0; k < fDim; k++) {
+            F(fPerm[k], c) = x[k];
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/** \file TSparseCholeskySolver.h
+* Contains the declaration of the TSparseCholeskySolver class.
+*/
+
+#ifndef TSPARSECHOLESKYSOLVER_H
+#define TSPARSECHOLESKYSOLVER_H
+
+#include <vector>
+#include "TLinearSolver.h"
+
+//!  A class that solves K11 * Du = F by a supernodal sparse Cholesky factorization.
+/*!
+     A class that solves K11 * Du = F by a sparse Cholesky factorization
+	 P * K11 * P^T = L * L^T. The permutation P is a fill-reducing ordering
+	 of the graph of K11 (approximate minimum degree or nested dissection),
+	 followed by a postorder of the elimination tree. The symbolic analysis
+	 finds the structure of L and groups its columns into supernodes:
+	 consecutive columns that share the same structure below the diagonal.
+	 Each supernode is stored as a dense column-major block, so the numeric
+	 factorization and the solves run on dense matrix-matrix kernels.
+*/
+class TSparseCholeskySolver : public TLinearSolver
+{
+public:
+    //! Default constructor.
+    /*!
+    \param Type the ordering of the solver: ESparseCholeskyAMD or
+    ESparseCholeskyND.
+    \return the new TSparseCholeskySolver object.
+    */
+    TSparseCholeskySolver(ESolverType Type = ESparseCholeskyAMD);
+
+    //! Creates a copy of the solver, including its factorization.
+    TLinearSolver* clone() const override;
+
+    //! Gets the type of the solver.
+    ESolverType getType() const override;
+
+    //! Factorizes a symmetric matrix and stores its factors.
+    void factorize(const TSparseBlock& K) override;
+
+    //! Solves the factorized system for one or more right-hand sides.
+    void solve(TPZFMatrix<double>& F) const override;
+
+    //! Gets the number of entries stored in the factors.
+    int64_t getFactorSize() const override;
+
+    //! Gets the fill-in of the factorization.
+    /*!
+    \return the number of entries of L that are zero in the lower triangle
+    of the factorized matrix.
+    */
+    int64_t getFillIn() const;
+
+    //! Gets the number of supernodes of L.
+    /*!
+    \return the number of supernodes.
+    */
+    int getNSupernodes() const;
+
+private:
+    //! The ordering of the solver.
+    ESolverType fType;
+    //! The dimension of the matrix.
+    int fDim;
+    //! The number of entries of the lower triangle of the factorized matrix.
+    int64_t fMatrixSize;
+    //! The original equation of each pivot.
+    std::vector<int> fPerm;
+    //! The first column of each supernode, plus the dimension.
+    std::vector<int> fSuperPtr;
+    //! The position of the first row of each supernode in fRows, plus the total.
+    std::vector<int64_t> fRowPtr;
+    //! The rows of each supernode, starting with its own columns.
+    std::vector<int> fRows;
+    //! The position of the block of each supernode in fValues, plus the total.
+    std::vector<int64_t> fValuePtr;
+    //! The dense column-major block of each supernode, with its rows of fRows.
+    std::vector<double> fValues;
+
+    //! Builds the ordering and the structure of L of a matrix.
+    /*!
+    \param K the view of the matrix.
+    \param ColPtr receives the position of the first entry of each column of
+    the permuted lower triangle, plus the total count.
+    \param RowInd receives the row of each entry of the permuted lower triangle.
+    \param Values receives the value of each entry of the permuted lower triangle.
+    */
+    void analyze(const TSparseBlock& K, std::vector<int64_t>& ColPtr,
+                 std::vector<int>& RowInd, std::vector<double>& Values);
+};
+
+#endif // TSPARSECHOLESKYSOLVER_H
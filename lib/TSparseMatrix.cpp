@@ -0,0 +1,392 @@
+/** \file TSparseMatrix.cpp
+* Contains the definitions of the TSparseMatrix and TSparseBlock methods.
+*/
+
+#include <algorithm>
+#include "TSparseMatrix.h"
+
+//! Default constructor.
+TSparseMatrix::TSparseMatrix(int Dim)
+    : fDim(Dim),
+      fSymmetric(false),
+      fRowPtr(Dim + 1, 0) {}
+
+//! Copy constructor.
+TSparseMatrix::TSparseMatrix(const TSparseMatrix& Other)
+    : fDim(Other.fDim),
+      fSymmetric(Other.fSymmetric),
+      fRowPtr(Other.fRowPtr),
+      fColumns(Other.fColumns),
+      fValues(Other.fValues) {}
+
+//! Destructor.
+TSparseMatrix::~TSparseMatrix() {}
+
+//! Assignment operator.
+TSparseMatrix& TSparseMatrix::operator=(const TSparseMatrix& Other)
+{
+    if (this != &Other) {
+        fDim = Other.fDim;
+        fSymmetric = Other.fSymmetric;
+        fRowPtr = Other.fRowPtr;
+        fColumns = Other.fColumns;
+        fValues = Other.fValues;
+    }
+    return *this;
+}
+
+//! Builds the sparsity pattern and zeroes all values.
+void TSparseMatrix::setPattern(int Dim, const std::vector<int>& Equations,
+                               int GroupSize, bool Symmetric)
+{
+    int nGroups = (int)Equations.size() / GroupSize;
+    std::vector<int64_t> groupPtr(nGroups + 1);
+    for (int g = 0; g <= nGroups; g++) {
+        groupPtr[g] = (int64_t)g * GroupSize;
+    }
+    this->setPattern(Dim, groupPtr, Equations, Symmetric);
+}
+
+//! Builds the sparsity pattern from groups of different sizes and zeroes all values.
+void TSparseMatrix::setPattern(int Dim, const std::vector<int64_t>& GroupPtr,
+                               const std::vector<int>& Equations, bool Symmetric)
+{
+    fDim = Dim;
+    fSymmetric = Symmetric;
+    int nGroups = (int)GroupPtr.size() - 1;
+
+    // Counts an upper bound of the number of entries of each row.
+    std::vector<int64_t> bound(Dim + 1, 0);
+    for (int g = 0; g < nGroups; g++) {
+        const int* group = Equations.data() + GroupPtr[g];
+        int groupSize = (int)(GroupPtr[g + 1] - GroupPtr[g]);
+        int valid = 0;
+        for (int a = 0; a < groupSize; a++) {
+            if (group[a] >= 0) valid++;
+        }
+        for (int a = 0; a < groupSize; a++) {
+            if (group[a] >= 0) bound[group[a] + 1] += valid;
+        }
+    }
+    for (int i = 0; i < Dim; i++) {
+        bound[i + 1] += bound[i];
+    }
+
+    // Lists the (possibly repeated) columns of each row.
+    std::vector<int> columns(bound[Dim]);
+    std::vector<int64_t> next(bound.begin(), bound.end() - 1);
+    for (int g = 0; g < nGroups; g++) {
+        const int* group = Equations.data() + GroupPtr[g];
+        int groupSize = (int)(GroupPtr[g + 1] - GroupPtr[g]);
+        for (int a = 0; a < groupSize; a++) {
+            if (group[a] < 0) continue;
+            for (int b = 0; b < groupSize; b++) {
+                if (group[b] < 0) continue;
+                if (Symmetric && group[b] < group[a]) continue;
+                columns[next[group[a]]++] = group[b];
+            }
+        }
+    }
+
+    // Sorts the columns of each row and removes the repeated ones. Each row
+    // was filled from bound[i] up to next[i].
+    fRowPtr.assign(Dim + 1, 0);
+    int64_t count = 0;
+    for (int i = 0; i < Dim; i++) {
+        auto first = columns.begin() + bound[i];
+        auto last = columns.begin() + next[i];
+        std::sort(first, last);
+        last = std::unique(first, last);
+        for (auto it = first; it != last; ++it) {
+            columns[count++] = *it;
+        }
+        fRowPtr[i + 1] = count;
+    }
+    columns.resize(count);
+    columns.shrink_to_fit();
+    fColumns.swap(columns);
+    fValues.assign(count, 0.);
+}
+
+//! Gets if only the upper triangle of the matrix is stored.
+bool TSparseMatrix::isSymmetric() const
+{
+    return fSymmetric;
+}
+
+//! Sets all stored values to zero, keeping the pattern.
+void TSparseMatrix::zero()
+{
+    std::fill(fValues.begin(), fValues.end(), 0.);
+}
+
+//! Gets the number of rows of the matrix.
+int TSparseMatrix::Rows() const
+{
+    return fDim;
+}
+
+//! Gets the number of columns of the matrix.
+int TSparseMatrix::Cols() const
+{
+    return fDim;
+}
+
+//! Gets the number of stored entries.
+int64_t TSparseMatrix::getNNZ() const
+{
+    return (int64_t)fValues.size();
+}
+
+//! Gets the position of the first entry of each row.
+const int64_t* TSparseMatrix::getRowPtr() const
+{
+    return fRowPtr.data();
+}
+
+//! Gets the column index of each stored entry.
+const int* TSparseMatrix::getColumns() const
+{
+    return fColumns.data();
+}
+
+//! Gets the value of each stored entry.
+const double* TSparseMatrix::getValues() const
+{
+    return fValues.data();
+}
+
+//! Finds the position of an entry of the pattern.
+int64_t TSparseMatrix::find(int Row, int Col) const
+{
+    auto first = fColumns.begin() + fRowPtr[Row];
+    auto last = fColumns.begin() + fRowPtr[Row + 1];
+    auto it = std::lower_bound(first, last, Col);
+
+    if (it == last || *it != Col) return -1;
+    return (int64_t)(it - fColumns.begin());
+}
+
+//! Gets the range of stored entries of a row that lie in a range of columns.
+void TSparseMatrix::getRowRange(int Row, int Col0, int Cols, int64_t& First,
+                                int64_t& Last) const
+{
+    const int* columns = fColumns.data();
+
+    First = fRowPtr[Row];
+    Last = fRowPtr[Row + 1];
+    First = std::lower_bound(columns + First, columns + Last, Col0) - columns;
+    Last = std::lower_bound(columns + First, columns + Last, Col0 + Cols) -
+           columns;
+}
+
+//! Gets an entry of the matrix.
+double TSparseMatrix::Get(int Row, int Col) const
+{
+    // The entries below the diagonal of a symmetric matrix are transposed.
+    if (fSymmetric && Col < Row) std::swap(Row, Col);
+
+    int64_t pos = find(Row, Col);
+    return (pos < 0) ? 0. : fValues[pos];
+}
+
+//! Adds a value to an entry of the pattern.
+void TSparseMatrix::addValue(int Row, int Col, double Value)
+{
+    int64_t pos = find(Row, Col);
+    if (pos < 0) {
+        // Stops debug if the entry does not belong to the pattern.
+        DebugStop();
+    }
+    fValues[pos] += Value;
+}
+
+//! Adds a dense square block to the matrix.
+void TSparseMatrix::addBlock(const int* Equations,
+                             const TPZFMatrix<double>& Block)
+{
+    int size = (int)Block.Rows();
+
+    for (int a = 0; a < size; a++) {
+        int row = Equations[a];
+        if (row < 0) continue;
+        for (int b = 0; b < size; b++) {
+            if (Equations[b] < 0) continue;
+            if (fSymmetric && Equations[b] < row) continue;
+            this->addValue(row, Equations[b], Block.Get(a, b));
+        }
+    }
+}
+
+//! Adds the 6x6 matrix of an element to the matrix.
+void TSparseMatrix::addBlock(const int* Equations, const TElementMatrix& Block)
+{
+    for (int a = 0; a < 6; a++) {
+        int row = Equations[a];
+        if (row < 0) continue;
+        for (int b = 0; b < 6; b++) {
+            if (Equations[b] < 0) continue;
+            if (fSymmetric && Equations[b] < row) continue;
+            this->addValue(row, Equations[b], Block(a, b));
+        }
+    }
+}
+
+//! Adds a symmetric 6x6 element matrix, given by its upper triangle.
+void TSparseMatrix::addUpperBlock(const int* Equations, const double* Upper,
+                                  int Stride)
+{
+    int k = 0;
+    for (int a = 0; a < 6; a++) {
+        for (int b = a; b < 6; b++, k++) {
+            int row = Equations[a];
+            int col = Equations[b];
+            if (row < 0 || col < 0) continue;
+
+            double value = Upper[k * Stride];
+            if (fSymmetric) {
+                // Stores the entry, or its transposed one, in the upper triangle.
+                this->addValue(std::min(row, col), std::max(row, col), value);
+            }
+            else {
+                this->addValue(row, col, value);
+                if (a != b) this->addValue(col, row, value);
+            }
+        }
+    }
+}
+
+//! Gets a rectangular block of the matrix as a non-owning view.
+TSparseBlock TSparseMatrix::getBlock(int Row0, int Rows, int Col0,
+                                     int Cols) const
+{
+    return TSparseBlock(this, Row0, Rows, Col0, Cols);
+}
+
+//! Converts the matrix into a dense one.
+TPZFMatrix<double> TSparseMatrix::toDense() const
+{
+    return this->getBlock(0, fDim, 0, fDim).toDense();
+}
+
+//! Prints the matrix in dense form.
+void TSparseMatrix::Print(std::ostream& out) const
+{
+    this->toDense().Print(out);
+}
+
+//! Default constructor.
+TSparseBlock::TSparseBlock(const TSparseMatrix* Matrix, int Row0, int Rows,
+                           int Col0, int Cols)
+    : fMatrix(Matrix),
+      fRow0(Row0),
+      fRows(Rows),
+      fCol0(Col0),
+      fCols(Cols) {}
+
+//! Gets the number of rows of the block.
+int TSparseBlock::Rows() const
+{
+    return fRows;
+}
+
+//! Gets the number of columns of the block.
+int TSparseBlock::Cols() const
+{
+    return fCols;
+}
+
+//! Gets an entry of the block.
+double TSparseBlock::Get(int Row, int Col) const
+{
+    return fMatrix->Get(fRow0 + Row, fCol0 + Col);
+}
+
+//! Gets the first column of the block in the viewed matrix.
+int TSparseBlock::getCol0() const
+{
+    return fCol0;
+}
+
+//! Gets the range of stored entries of a row that lie inside the block.
+void TSparseBlock::getRowRange(int Row, int64_t& First, int64_t& Last) const
+{
+    fMatrix->getRowRange(fRow0 + Row, fCol0, fCols, First, Last);
+}
+
+//! Gets the viewed matrix.
+const TSparseMatrix* TSparseBlock::getMatrix() const
+{
+    return fMatrix;
+}
+
+//! Computes Y += Alpha * B * X, where B is the block.
+void TSparseBlock::multAdd(const TDenseBlock& X, TPZFMatrix<double>& Y,
+                           double Alpha, int YRow0) const
+{
+    if (X.Rows() != fCols || Y.Rows() < YRow0 + fRows || X.Cols() != Y.Cols()) {
+        // Stops debug if the dimensions do not match.
+        DebugStop();
+    }
+
+    const int* columns = fMatrix->getColumns();
+    const double* values = fMatrix->getValues();
+
+    for (int i = 0; i < fRows; i++) {
+        int64_t first, last;
+        this->getRowRange(i, first, last);
+        for (int c = 0; c < X.Cols(); c++) {
+            double sum = 0.;
+            for (int64_t k = first; k < last; k++) {
+                sum += values[k] * X.Get(columns[k] - fCol0, c);
+            }
+            Y(YRow0 + i, c) += Alpha * sum;
+        }
+    }
+
+    if (fMatrix->isSymmetric()) {
+        // Entries (i, j) of the block below the diagonal are stored at (j, i):
+        // they are read from the rows of the block columns.
+        for (int j = 0; j < fCols; j++) {
+            int64_t first, last;
+            fMatrix->getRowRange(fCol0 + j, fRow0, fRows, first, last);
+            for (int64_t k = first; k < last; k++) {
+                if (columns[k] <= fCol0 + j) continue;
+                int i = columns[k] - fRow0;
+                for (int c = 0; c < X.Cols(); c++) {
+                    Y(YRow0 + i, c) += Alpha * values[k] * X.Get(j, c);
+                }
+            }
+        }
+    }
+}
+
+//! Converts the block into a dense matrix.
+TPZFMatrix<double> TSparseBlock::toDense() const
+{
+    TPZFMatrix<double> dense(fRows, fCols, 0);
+
+    const int* columns = fMatrix->getColumns();
+    const double* values = fMatrix->getValues();
+
+    for (int i = 0; i < fRows; i++) {
+        int64_t first, last;
+        this->getRowRange(i, first, last);
+        for (int64_t k = first; k < last; k++) {
+            dense(i, columns[k] - fCol0) = values[k];
+        }
+    }
+
+    if (fMatrix->isSymmetric()) {
+        // Entries (i, j) of the block below the diagonal are stored at (j, i).
+        for (int j = 0; j < fCols; j++) {
+            int64_t first, last;
+            fMatrix->getRowRange(fCol0 + j, fRow0, fRows, first, last);
+            for (int64_t k = first; k < last; k++) {
+                if (columns[k] <= fCol0 + j) continue;
+                dense(columns[k] - fRow0, j) = values[k];
+            }
+        }
+    }
+    return dense;
+}
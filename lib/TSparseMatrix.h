@@ -0,0 +1,319 @@
+/** \file TSparseMatrix.h
+* Contains the declaration of the TSparseMatrix and TSparseBlock classes.
+*/
+
+#ifndef TSPARSEMATRIX_H
+#define TSPARSEMATRIX_H
+
+#include <iostream>
+#include <vector>
+#include <cstdint>
+#include "pzfmatrix.h"
+#include "TDenseBlock.h"
+#include "TFixedMatrix.h"
+
+// Forward declaration to TSparseBlock class.
+class TSparseBlock;
+
+//!  A class that implements a square sparse matrix.
+/*!
+     A class that implements a square sparse matrix stored in compressed
+	 sparse row (CSR) format. The sparsity pattern is built once from groups
+	 of coupled equations (e.g. the six equations of each frame element) and
+	 values can then only be added at positions that belong to the pattern.
+	 The column indexes of each row are kept sorted. A symmetric matrix may
+	 store only its upper triangle (Col >= Row); the entries below the
+	 diagonal are then read from their transposed positions.
+*/
+class TSparseMatrix
+{
+public:
+    //! Default constructor.
+    /*!
+    \param Dim the number of rows (and columns) of the matrix.
+    \return the new TSparseMatrix object, with an empty pattern.
+    */
+    TSparseMatrix(int Dim = 0);
+
+    //! Copy constructor.
+    /*!
+    \param Other the TSparseMatrix object to be copied.
+    \return the new TSparseMatrix object.
+    */
+    TSparseMatrix(const TSparseMatrix& Other);
+
+    //! Destructor.
+    ~TSparseMatrix();
+
+    //! Assignment operator.
+    /*!
+    \param Other the TSparseMatrix object to be copied.
+    \return the modified TSparseMatrix object.
+    */
+    TSparseMatrix& operator=(const TSparseMatrix& Other);
+
+    //! Builds the sparsity pattern and zeroes all values.
+    /*!
+    \param Dim the number of rows (and columns) of the matrix.
+    \param Equations the concatenated groups of coupled equations. Every
+    equation of a group is coupled with every other equation of the same
+    group. Negative equations are ignored.
+    \param GroupSize the number of equations of each group.
+    \param Symmetric marks if only the upper triangle is stored.
+    */
+    void setPattern(int Dim, const std::vector<int>& Equations, int GroupSize,
+                    bool Symmetric = false);
+
+    //! Builds the sparsity pattern from groups of different sizes and zeroes all values.
+    /*!
+    \param Dim the number of rows (and columns) of the matrix.
+    \param GroupPtr the position in Equations of the first equation of each
+    group, plus the total number of equations.
+    \param Equations the concatenated groups of coupled equations. Every
+    equation of a group is coupled with every other equation of the same
+    group. Negative equations are ignored.
+    \param Symmetric marks if only the upper triangle is stored.
+    */
+    void setPattern(int Dim, const std::vector<int64_t>& GroupPtr,
+                    const std::vector<int>& Equations, bool Symmetric = false);
+
+    //! Gets if only the upper triangle of the matrix is stored.
+    /*!
+    \return true if the matrix is symmetric and stores its upper triangle.
+    */
+    bool isSymmetric() const;
+
+    //! Sets all stored values to zero, keeping the pattern.
+    void zero();
+
+    //! Gets the number of rows of the matrix.
+    /*!
+    \return the number of rows of the matrix.
+    */
+    int Rows() const;
+
+    //! Gets the number of columns of the matrix.
+    /*!
+    \return the number of columns of the matrix.
+    */
+    int Cols() const;
+
+    //! Gets the number of stored entries.
+    /*!
+    \return the number of entries that belong to the sparsity pattern.
+    */
+    int64_t getNNZ() const;
+
+    //! Gets the position of the first entry of each row.
+    /*!
+    \return an array of Rows() + 1 positions into the column and value arrays.
+    */
+    const int64_t* getRowPtr() const;
+
+    //! Gets the column index of each stored entry.
+    /*!
+    \return an array with the column index of each stored entry.
+    */
+    const int* getColumns() const;
+
+    //! Gets the value of each stored entry.
+    /*!
+    \return an array with the value of each stored entry.
+    */
+    const double* getValues() const;
+
+    //! Gets the range of stored entries of a row that lie in a range of columns.
+    /*!
+    \param Row the row.
+    \param Col0 the first column of the range.
+    \param Cols the number of columns of the range.
+    \param First the position of the first entry of the range.
+    \param Last the position after the last entry of the range.
+    */
+    void getRowRange(int Row, int Col0, int Cols, int64_t& First,
+                     int64_t& Last) const;
+
+    //! Gets an entry of the matrix.
+    /*!
+    \param Row the row of the entry.
+    \param Col the column of the entry.
+    \return the entry value, or zero if it is not part of the pattern.
+    */
+    double Get(int Row, int Col) const;
+
+    //! Adds a value to an entry of the pattern.
+    /*!
+    For a symmetric matrix, only entries of the upper triangle can be added.
+    \param Row the row of the entry.
+    \param Col the column of the entry.
+    \param Value the value to be added.
+    */
+    void addValue(int Row, int Col, double Value);
+
+    //! Adds a dense square block to the matrix.
+    /*!
+    For a symmetric matrix, the block must be symmetric and only the entries
+    that fall in the upper triangle are added.
+    \param Equations the rows (and columns) of the matrix associated with
+    each row of the block. Negative equations are skipped.
+    \param Block the square block to be added.
+    */
+    void addBlock(const int* Equations, const TPZFMatrix<double>& Block);
+
+    //! Adds the 6x6 matrix of an element to the matrix.
+    /*!
+    \param Equations the six rows (and columns) of the matrix associated with
+    each row of the block. Negative equations are skipped.
+    \param Block the element matrix to be added.
+    */
+    void addBlock(const int* Equations, const TElementMatrix& Block);
+
+    //! Adds a symmetric 6x6 element matrix, given by its upper triangle.
+    /*!
+    \param Equations the six rows (and columns) of the matrix associated with
+    each row of the block. Negative equations are skipped.
+    \param Upper the 21 entries of the upper triangle of the block, by rows.
+    \param Stride the distance between two consecutive entries in Upper.
+    */
+    void addUpperBlock(const int* Equations, const double* Upper, int Stride);
+
+    //! Gets a rectangular block of the matrix as a non-owning view.
+    /*!
+    \param Row0 the first row of the block.
+    \param Rows the number of rows of the block.
+    \param Col0 the first column of the block.
+    \param Cols the number of columns of the block.
+    \return the view of the block.
+    */
+    TSparseBlock getBlock(int Row0, int Rows, int Col0, int Cols) const;
+
+    //! Converts the matrix into a dense one.
+    /*!
+    \return the dense form of the matrix.
+    */
+    TPZFMatrix<double> toDense() const;
+
+    //! Prints the matrix in dense form.
+    /*!
+    \param out the stream the matrix is printed to.
+    */
+    void Print(std::ostream& out) const;
+
+private:
+    //! The number of rows (and columns) of the matrix.
+    int fDim;
+    //! Marks if only the upper triangle is stored.
+    bool fSymmetric;
+    //! The position of the first entry of each row, plus the total count.
+    std::vector<int64_t> fRowPtr;
+    //! The sorted column indexes of the entries of each row.
+    std::vector<int> fColumns;
+    //! The values of the stored entries.
+    std::vector<double> fValues;
+
+    //! Finds the position of an entry of the pattern.
+    /*!
+    \param Row the row of the entry.
+    \param Col the column of the entry.
+    \return the position of the entry, or -1 if it is not in the pattern.
+    */
+    int64_t find(int Row, int Col) const;
+};
+
+//!  A class that implements a view of a rectangular block of a TSparseMatrix.
+/*!
+     A class that implements a non-owning view of the rows [Row0, Row0 + Rows)
+	 and columns [Col0, Col0 + Cols) of a TSparseMatrix object. The view is
+	 only valid while the viewed matrix is alive and keeps its pattern. If
+	 the matrix stores only its upper triangle, the entries of the block
+	 below the diagonal are read from their transposed positions, so a block
+	 such as K21 is the transpose of K12 without being stored.
+*/
+class TSparseBlock
+{
+public:
+    //! Default constructor.
+    /*!
+    \param Matrix a pointer to the viewed TSparseMatrix object.
+    \param Row0 the first row of the block.
+    \param Rows the number of rows of the block.
+    \param Col0 the first column of the block.
+    \param Cols the number of columns of the block.
+    \return the new TSparseBlock object.
+    */
+    TSparseBlock(const TSparseMatrix* Matrix = nullptr, int Row0 = 0,
+                 int Rows = 0, int Col0 = 0, int Cols = 0);
+
+    //! Gets the number of rows of the block.
+    /*!
+    \return the number of rows of the block.
+    */
+    int Rows() const;
+
+    //! Gets the number of columns of the block.
+    /*!
+    \return the number of columns of the block.
+    */
+    int Cols() const;
+
+    //! Gets an entry of the block.
+    /*!
+    \param Row the row of the entry, relative to the block.
+    \param Col the column of the entry, relative to the block.
+    \return the entry value.
+    */
+    double Get(int Row, int Col) const;
+
+    //! Gets the first column of the block in the viewed matrix.
+    /*!
+    \return the column of the viewed matrix that is column 0 of the block.
+    */
+    int getCol0() const;
+
+    //! Gets the range of stored entries of a row that lie inside the block.
+    /*!
+    The entries are read with the getColumns() and getValues() arrays of the
+    viewed matrix; their columns must be shifted by getCol0(). For a
+    symmetric matrix, only the entries of the upper triangle are stored.
+    \param Row the row, relative to the block.
+    \param First the position of the first entry of the range.
+    \param Last the position after the last entry of the range.
+    */
+    void getRowRange(int Row, int64_t& First, int64_t& Last) const;
+
+    //! Gets the viewed matrix.
+    /*!
+    \return a pointer to the viewed TSparseMatrix object.
+    */
+    const TSparseMatrix* getMatrix() const;
+
+    //! Computes Y += Alpha * B * X, where B is the block.
+    /*!
+    \param X a matrix (or view) with Cols() rows.
+    \param Y a matrix with as many columns as X.
+    \param Alpha the factor applied to the product.
+    \param YRow0 the row of Y that receives the first row of the product.
+    */
+    void multAdd(const TDenseBlock& X, TPZFMatrix<double>& Y,
+                 double Alpha = 1., int YRow0 = 0) const;
+
+    //! Converts the block into a dense matrix.
+    /*!
+    \return the dense form of the block.
+    */
+    TPZFMatrix<double> toDense() const;
+
+private:
+    //! A pointer to the viewed TSparseMatrix object.
+    const TSparseMatrix* fMatrix;
+    //! The first row of the block.
+    int fRow0;
+    //! The number of rows of the block.
+    int fRows;
+    //! The first column of the block.
+    int fCol0;
+    //! The number of columns of the block.
+    int fCols;
+};
+
+#endif // TSPARSEMATRIX_H
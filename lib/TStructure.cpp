@@ -2,7 +2,15 @@
 * Contains the definitions of the TStructure methods.
 */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
 #include "TStructure.h"
+#include "Renumbering.h"
+#include "Parallel.h"
+#include "ElementKernels.h"
 
 //! Default constructor.
 TStructure::TStructure(const std::vector<TNode>& Nodes,
@@ -15,33 +23,118 @@ TStructure::TStructure(const std::vector<TNode>& Nodes,
     fSupports = Supports;
     fElements = Elements;
 
-    fK = TPZFMatrix<double>(0, 0, 0);
+    fHasEquations = false;
+    fNDOF = 0;
+    fCDOF = 0;
+    fUDOF = 0;
+    fHDOF = 0;
+    fIDOF = 0;
+    fRenumber = false;
+    fCondenseHinges = false;
+    fNSubdomains = 1;
+    fSolverType = EDenseCholesky;
+    fSolver = nullptr;
+    fHasFactorization = false;
+    fFactorSignature = 0;
+    fReusedFactorization = false;
+    fPreconditioner = EJacobi;
+    fTolerance = 1e-10;
+    fMaxIterations = 10000;
+    fSymmetricStorage = true;
+    fNThreads = 0;
+    fMaxUpdateRank = 32;
+    fHasBaseModel = false;
+    fBaseTopology = 0;
+    fBaseUDOF = 0;
+
+    fK = TSparseMatrix(0);
     fQ = TPZFMatrix<double>(0, 0, 0);
     fQ0 = TPZFMatrix<double>(0, 0, 0);
     fD = TPZFMatrix<double>(0, 0, 0);
+    fElementQ0 = TPZFMatrix<double>(0, 0, 0);
 }
 
 //! Copy constructor.
-TStructure::TStructure(const TStructure& Other)
+TStructure::TStructure(const TStructure& Other) : fSolver(nullptr)
 {
+    *this = Other;
+}
+
+//! Destructor.
+TStructure::~TStructure()
+{
+    delete fSolver;
+}
+
+//! Assignment operator.
+TStructure& TStructure::operator=(const TStructure& Other)
+{
+    if (this == &Other) return *this;
+
     fNodes = Other.fNodes;
     fMaterials = Other.fMaterials;
     fSupports = Other.fSupports;
     fElements = Other.fElements;
+    fSubstructures = Other.fSubstructures;
     fNodeEquations = Other.fNodeEquations;
+    fElementEquations = Other.fElementEquations;
+    fHasEquations = Other.fHasEquations;
+    fNDOF = Other.fNDOF;
+    fCDOF = Other.fCDOF;
+    fUDOF = Other.fUDOF;
+    fHDOF = Other.fHDOF;
+    fIDOF = Other.fIDOF;
+    fCondensedSubstructures = Other.fCondensedSubstructures;
+    fElementSubstructures = Other.fElementSubstructures;
+    fSubstructureEquations = Other.fSubstructureEquations;
+    fSubstructureNInterior = Other.fSubstructureNInterior;
     fK = Other.fK;
     fQ = Other.fQ;
     fQ0 = Other.fQ0;
     fD = Other.fD;
+    fElementQ0 = Other.fElementQ0;
+    fSuperelements = Other.fSuperelements;
+    fSubstructureSuperelements = Other.fSubstructureSuperelements;
+    fRenumber = Other.fRenumber;
+    fCondenseHinges = Other.fCondenseHinges;
+    fNSubdomains = Other.fNSubdomains;
+    fSolverType = Other.fSolverType;
+    fPreconditioner = Other.fPreconditioner;
+    fTolerance = Other.fTolerance;
+    fMaxIterations = Other.fMaxIterations;
+    fSymmetricStorage = Other.fSymmetricStorage;
+    fNThreads = Other.fNThreads;
+    fProfile = Other.fProfile;
+    fMaxUpdateRank = Other.fMaxUpdateRank;
+    fHasBaseModel = Other.fHasBaseModel;
+    fBaseTopology = Other.fBaseTopology;
+    fBaseTopologyModel = Other.fBaseTopologyModel;
+    fBaseMaterials = Other.fBaseMaterials;
+    fBaseElementMaterials = Other.fBaseElementMaterials;
+    fBaseElementHinges = Other.fBaseElementHinges;
+    fBaseNodeEquations = Other.fBaseNodeEquations;
+    fBaseElementEquations = Other.fBaseElementEquations;
+    fBaseUDOF = Other.fBaseUDOF;
+
+    delete fSolver;
+    fSolver = (Other.fSolver == nullptr) ? nullptr : Other.fSolver->clone();
+    fHasFactorization = Other.fHasFactorization;
+    fFactorSignature = Other.fFactorSignature;
+    fFactorModel = Other.fFactorModel;
+    fReusedFactorization = Other.fReusedFactorization;
+    return *this;
 }
 
-//! Destructor.
-TStructure::~TStructure() {}
-
 //! Modifies the vector of TNode objects.
 void TStructure::setNodes(const std::vector<TNode>& Nodes)
 {
     fNodes = Nodes;
+    invalidateEquations();
+
+    // The element geometry depends on the node coordinates.
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        fElements[i].invalidateGeometry();
+    }
 }
 
 //! Modifies the vector of TMaterial objects.
@@ -54,12 +147,26 @@ void TStructure::setMaterials(const std::vector<TMaterial>& Materials)
 void TStructure::setSupports(const std::vector<TSupport>& Supports)
 {
     fSupports = Supports;
+    invalidateEquations();
 }
 
 //! Modifies the vector of TElement objects.
 void TStructure::setElements(const std::vector<TElement>& Elements)
 {
     fElements = Elements;
+    invalidateEquations();
+
+    // The given elements may carry geometry computed for other nodes.
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        fElements[i].invalidateGeometry();
+    }
+}
+
+//! Modifies the substructures, each given by the IDs of its elements.
+void TStructure::setSubstructures(const std::vector<std::vector<int>>& Substructures)
+{
+    fSubstructures = Substructures;
+    invalidateEquations();
 }
 
 //! Gets the vector of TNode objects.
@@ -86,6 +193,24 @@ std::vector<TElement> TStructure::getElements()
     return fElements;
 }
 
+//! Gets the substructures, each given by the IDs of its elements.
+const std::vector<std::vector<int>>& TStructure::getSubstructures() const
+{
+    return fSubstructures;
+}
+
+//! Gets one of the TNode objects by reference.
+const TNode& TStructure::getNode(int NodeID) const
+{
+    return fNodes[NodeID];
+}
+
+//! Gets one of the TMaterial objects by reference.
+const TMaterial& TStructure::getMaterial(int MaterialID) const
+{
+    return fMaterials[MaterialID];
+}
+
 //! Gets one of the TElement objects by copy.
 TElement TStructure::getElement(int elementID)
 {
@@ -113,13 +238,80 @@ int TStructure::getSupportID(int NodeID)
 }
 
 //! Gets the matrix of degrees of freedom of the nodes.
-TPZFMatrix<int> TStructure::getNodeEquations()
+const TPZFMatrix<int>& TStructure::getNodeEquations() const
 {
     return fNodeEquations;
 }
 
+//! Gets the degree of freedom of a node in a direction (0: x, 1: y, 2: rotation).
+int TStructure::getNodeEquation(int NodeID, int Direction) const
+{
+    return fNodeEquations.GetVal(NodeID, Direction);
+}
+
+//! Gets the degrees of freedom of all elements, six per element.
+const std::vector<int>& TStructure::getElementEquations() const
+{
+    return fElementEquations;
+}
+
 //! Gets the total number of degrees of freedom of the structure.
 int TStructure::getNDOF() const
+{
+    if (fHasEquations) return fNDOF;
+    return this->countNDOF();
+}
+
+//! Gets the number of constrained degrees of freedom of the structure.
+int TStructure::getCDOF() const
+{
+    if (fHasEquations) return fCDOF;
+    return this->countCDOF();
+}
+
+//! Gets the number of unconstrained degrees of freedom of the structure.
+int TStructure::getUDOF() const
+{
+    if (fHasEquations) return fUDOF;
+    return (this->countNDOF() - this->countCDOF() - this->getHDOF() -
+            this->getIDOF());
+}
+
+//! Gets the number of hinge rotations condensed out of K (see setCondenseHinges()).
+int TStructure::getHDOF() const
+{
+    if (fHasEquations) return fHDOF;
+    if (fCondenseHinges == false) return 0;
+
+    // The hinges of the substructures are interior DOF instead.
+    std::vector<bool> substructure(fElements.size(), false);
+    for (const std::vector<int>& elements : this->getCondensedSubstructures()) {
+        for (int id : elements) substructure[id] = true;
+    }
+    int HDOF = 0;
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        if (substructure[i]) continue;
+        if (fElements[i].getHinge0() == true) HDOF++;
+        if (fElements[i].getHinge1() == true) HDOF++;
+    }
+    return HDOF;
+}
+
+//! Gets the number of interior degrees of freedom of the substructures, condensed out of K.
+int TStructure::getIDOF() const
+{
+    if (fHasEquations) return fIDOF;
+    return this->countIDOF();
+}
+
+//! Gets the number of condensed substructures computed by the last assembly (identical ones share one).
+int TStructure::getNSuperelements() const
+{
+    return (int)fSuperelements.size();
+}
+
+//! Counts the total number of degrees of freedom by scanning the model.
+int TStructure::countNDOF() const
 {
     // DOF counter variable, intialized considering vertical and horizontal
     // displacements.
@@ -174,8 +366,8 @@ int TStructure::getNDOF() const
     return NDOF;
 }
 
-//! Gets the number of constrained degrees of freedom of the structure.
-int TStructure::getCDOF() const
+//! Counts the number of constrained degrees of freedom by scanning the model.
+int TStructure::countCDOF() const
 {
     int CDOF = 0;
     // Counts the number of constrained DOF.
@@ -193,158 +385,646 @@ int TStructure::getCDOF() const
     return CDOF;
 }
 
-//! Gets the number of unconstrained degrees of freedom of the structure.
-int TStructure::getUDOF() const
+//! Counts the number of interior degrees of freedom of the substructures by scanning the model.
+int TStructure::countIDOF() const
+{
+    std::vector<std::vector<int>> substructures = this->getCondensedSubstructures();
+    if (substructures.empty()) return 0;
+
+    std::vector<int> elementSubstructures;
+    std::vector<int> interiorNodes =
+        this->getInteriorNodes(substructures, elementSubstructures);
+
+    // Interior nodes have their displacements and, if an element is rigidly
+    // connected, a rotation. Hinged ends of substructure elements are interior.
+    int IDOF = 0;
+    std::vector<bool> rotation(fNodes.size(), false);
+    for (int n = 0; n < (int)fNodes.size(); n++) {
+        if (interiorNodes[n] >= 0) IDOF += 2;
+    }
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        for (int node = 0; node < 2; node++) {
+            int NodeID = (node == 0) ? fElements[i].getNode0ID() : fElements[i].getNode1ID();
+            bool hinge = (node == 0) ? fElements[i].getHinge0() : fElements[i].getHinge1();
+            if (hinge == true) {
+                if (elementSubstructures[i] >= 0) IDOF++;
+            }
+            else if (interiorNodes[NodeID] >= 0 && rotation[NodeID] == false) {
+                rotation[NodeID] = true;
+                IDOF++;
+            }
+        }
+    }
+    return IDOF;
+}
+
+//! Gets the substructures condensed out of K: the declared ones, or else the subdomains.
+std::vector<std::vector<int>> TStructure::getCondensedSubstructures() const
 {
-    return (this->getNDOF() - this->getCDOF());
+    int nElements = fElements.size();
+    if (!fSubstructures.empty() || fNSubdomains <= 1 || nElements == 0) {
+        return fSubstructures;
+    }
+
+    // Splits the graph of the elements, where two elements are neighbours
+    // when they share a node, into subdomains of about the same size.
+    std::vector<int> nodePtr(fNodes.size() + 1, 0);
+    for (int i = 0; i < nElements; i++) {
+        nodePtr[fElements[i].getNode0ID() + 1]++;
+        nodePtr[fElements[i].getNode1ID() + 1]++;
+    }
+    for (int n = 0; n < (int)fNodes.size(); n++) {
+        nodePtr[n + 1] += nodePtr[n];
+    }
+    std::vector<int> nodeElements(nodePtr.back());
+    std::vector<int> next(nodePtr.begin(), nodePtr.end() - 1);
+    for (int i = 0; i < nElements; i++) {
+        nodeElements[next[fElements[i].getNode0ID()]++] = i;
+        nodeElements[next[fElements[i].getNode1ID()]++] = i;
+    }
+    std::vector<int> adjPtr(1, 0), adj;
+    for (int i = 0; i < nElements; i++) {
+        int NodesIDs[2] = {fElements[i].getNode0ID(), fElements[i].getNode1ID()};
+        for (int node = 0; node < 2; node++) {
+            for (int k = nodePtr[NodesIDs[node]]; k < nodePtr[NodesIDs[node] + 1]; k++) {
+                if (nodeElements[k] != i) adj.push_back(nodeElements[k]);
+            }
+        }
+        adjPtr.push_back(adj.size());
+    }
+    std::vector<int> parts = partitionGraph(adjPtr, adj, std::min(fNSubdomains, nElements));
+
+    std::vector<std::vector<int>> subdomains(std::min(fNSubdomains, nElements));
+    for (int i = 0; i < nElements; i++) {
+        subdomains[parts[i]].push_back(i);
+    }
+    return subdomains;
+}
+
+//! Finds the substructure of each element and the one each node is interior to (-1: none).
+std::vector<int> TStructure::getInteriorNodes(const std::vector<std::vector<int>>& Substructures,
+                                              std::vector<int>& ElementSubstructures) const
+{
+    ElementSubstructures.assign(fElements.size(), -1);
+    for (int s = 0; s < (int)Substructures.size(); s++) {
+        for (int id : Substructures[s]) {
+            if (id < 0 || id >= (int)fElements.size() || ElementSubstructures[id] != -1) {
+                // Stops debug if an element does not exist or is in two substructures.
+                DebugStop();
+            }
+            ElementSubstructures[id] = s;
+        }
+    }
+
+    // A node is interior to a substructure when all its elements belong to
+    // it and it has no support.
+    const int unused = -2;
+    std::vector<int> interiorNodes(fNodes.size(), unused);
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        int NodesIDs[2] = {fElements[i].getNode0ID(), fElements[i].getNode1ID()};
+        for (int node = 0; node < 2; node++) {
+            int& interior = interiorNodes[NodesIDs[node]];
+            if (interior == unused) interior = ElementSubstructures[i];
+            else if (interior != ElementSubstructures[i]) interior = -1;
+        }
+    }
+    for (int i = 0; i < (int)fSupports.size(); i++) {
+        interiorNodes[fSupports[i].getNodeID()] = -1;
+    }
+    for (int& interior : interiorNodes) {
+        if (interior == unused) interior = -1;
+    }
+    return interiorNodes;
 }
 
 //! Enumerates the degrees of freedom of each TElement object.
 void TStructure::enumerateEquations()
 {
+    TPhaseTimer timer(fProfile, EEnumerateEquations);
+
+    // The nodes interior to a substructure, and the hinges of its elements,
+    // are enumerated last.
+    fCondensedSubstructures = this->getCondensedSubstructures();
+    std::vector<int> interiorNodes =
+        this->getInteriorNodes(fCondensedSubstructures, fElementSubstructures);
+
     // Matrix that stores the equations associated with each node.
     TPZFMatrix<int> equations(fNodes.size(), 3, -1);
+    // Mark of the constrained DOF, which are enumerated after the others.
+    const int constrained = -2;
 
-    int CDOF = this->getCDOF();
-    int count = this->getNDOF() - CDOF;
-
-    // Enumerates the constrained DOF.
+    // Marks the constrained DOF.
     for (int i = 0; i < (int)fSupports.size(); i++) {
+        int NodeID = fSupports[i].getNodeID();
         if (fSupports[i].RestrictsFx() == true) {
-            equations(fSupports[i].getNodeID(), 0) = count;
-            count++;
+            equations(NodeID, 0) = constrained;
         }
         if (fSupports[i].RestrictsFy() == true) {
-            equations(fSupports[i].getNodeID(), 1) = count;
-            count++;
+            equations(NodeID, 1) = constrained;
         }
         if (fSupports[i].RestrictsM() == true) {
-            equations(fSupports[i].getNodeID(), 2) = count;
-            count++;
+            equations(NodeID, 2) = constrained;
         }
     }
 
-    // Enumerates the unconstrained DOF.
-    count = 0;
-    for (int i = 0; i < (int)fElements.size(); i++) {
-        int Node0ID = fElements[i].getNode0ID();
-        int Node1ID = fElements[i].getNode1ID();
-        int Node0RotationDOF;
-        int Node1RotationDOF;
+    // Order in which the element ends (2 * element + local node) are visited.
+    // By default the elements are visited in sequence; with renumbering, the
+    // ends are grouped by node and the nodes visited in RCM order.
+    int nEnds = 2 * fElements.size();
+    std::vector<int> ends(nEnds);
+    if (fRenumber == false) {
+        for (int e = 0; e < nEnds; e++) {
+            ends[e] = e;
+        }
+    }
+    else {
+        std::vector<int> endsPtr(fNodes.size() + 1, 0);
+        for (int e = 0; e < nEnds; e++) {
+            endsPtr[fElements[e / 2].getLocalNodesIDs()[e % 2] + 1]++;
+        }
+        std::vector<int> nodeOrder = this->getNodeOrder();
+        std::vector<int> position(fNodes.size() + 1, 0);
+        for (int k = 0; k < (int)nodeOrder.size(); k++) {
+            position[k + 1] = position[k] + endsPtr[nodeOrder[k] + 1];
+        }
+        for (int k = 0; k < (int)nodeOrder.size(); k++) {
+            endsPtr[nodeOrder[k]] = position[k];
+        }
+        for (int e = 0; e < nEnds; e++) {
+            ends[endsPtr[fElements[e / 2].getLocalNodesIDs()[e % 2]]++] = e;
+        }
+    }
 
-        if (equations(Node0ID, 0) == -1) {
-            equations(Node0ID, 0) = count;
+    // Enumerates the unconstrained DOF. Hinged element ends get their own
+    // rotation DOF, stored apart from the node equations, unless they are
+    // condensed.
+    std::vector<int> hingeEquations(nEnds, -1);
+    int count = 0;
+    for (int k = 0; k < nEnds; k++) {
+        TElement& element = fElements[ends[k] / 2];
+        int node = ends[k] % 2;
+        int NodeID = element.getLocalNodesIDs()[node];
+        bool hinge = (node == 0) ? element.getHinge0() : element.getHinge1();
+        bool substructure = fElementSubstructures[ends[k] / 2] >= 0;
+
+        if (interiorNodes[NodeID] >= 0) continue;
+        if (equations(NodeID, 0) == -1) {
+            equations(NodeID, 0) = count;
             count++;
         }
-        if (equations(Node0ID, 1) == -1) {
-            equations(Node0ID, 1) = count;
+        if (equations(NodeID, 1) == -1) {
+            equations(NodeID, 1) = count;
             count++;
         }
-        if (fElements[i].getHinge0() == false) {
-            if (equations(Node0ID, 2) == -1) {
-                equations(Node0ID, 2) = count;
+        if (hinge == false) {
+            if (equations(NodeID, 2) == -1) {
+                equations(NodeID, 2) = count;
                 count++;
             }
-            Node0RotationDOF = equations(Node0ID, 2);
         }
-        else {
-            Node0RotationDOF = count;
+        else if (fCondenseHinges == false && substructure == false) {
+            hingeEquations[ends[k]] = count;
             count++;
         }
+    }
+    fUDOF = count;
 
-        if (equations(Node1ID, 0) == -1) {
-            equations(Node1ID, 0) = count;
+    // Enumerates the constrained DOF.
+    for (int i = 0; i < (int)fSupports.size(); i++) {
+        int NodeID = fSupports[i].getNodeID();
+        if (fSupports[i].RestrictsFx() == true) {
+            equations(NodeID, 0) = count;
             count++;
         }
-        if (equations(Node1ID, 1) == -1) {
-            equations(Node1ID, 1) = count;
+        if (fSupports[i].RestrictsFy() == true) {
+            equations(NodeID, 1) = count;
             count++;
         }
-        if (fElements[i].getHinge1() == false) {
-            if (equations(Node1ID, 2) == -1) {
-                equations(Node1ID, 2) = count;
+        if (fSupports[i].RestrictsM() == true) {
+            equations(NodeID, 2) = count;
+            count++;
+        }
+    }
+    fCDOF = count - fUDOF;
+
+    // Enumerates the condensed hinge rotations. They are kept out of K and
+    // only hold the rotations recovered after the solution.
+    if (fCondenseHinges == true) {
+        for (int e = 0; e < nEnds; e++) {
+            bool hinge = (e % 2 == 0) ? fElements[e / 2].getHinge0()
+                                      : fElements[e / 2].getHinge1();
+            if (hinge == true && fElementSubstructures[e / 2] < 0) {
+                hingeEquations[e] = count;
                 count++;
             }
-            Node1RotationDOF = equations(Node1ID, 2);
         }
-        else {
-            Node1RotationDOF = count;
-            count++;
+    }
+    fHDOF = count - fUDOF - fCDOF;
+
+    // Enumerates the interior DOF of each substructure together: its
+    // interior nodes and the hinges of its elements.
+    int nSubstructures = fCondensedSubstructures.size();
+    std::vector<int> firstInterior(nSubstructures + 1);
+    for (int s = 0; s < nSubstructures; s++) {
+        firstInterior[s] = count;
+        for (int id : fCondensedSubstructures[s]) {
+            for (int node = 0; node < 2; node++) {
+                int NodeID = fElements[id].getLocalNodesIDs()[node];
+                bool hinge = (node == 0) ? fElements[id].getHinge0()
+                                         : fElements[id].getHinge1();
+                if (interiorNodes[NodeID] == s) {
+                    for (int k = 0; k < 2; k++) {
+                        if (equations(NodeID, k) == -1) {
+                            equations(NodeID, k) = count;
+                            count++;
+                        }
+                    }
+                    if (hinge == false && equations(NodeID, 2) == -1) {
+                        equations(NodeID, 2) = count;
+                        count++;
+                    }
+                }
+                if (hinge == true) {
+                    hingeEquations[2 * id + node] = count;
+                    count++;
+                }
+            }
         }
+    }
+    firstInterior[nSubstructures] = count;
+    fNDOF = count;
+    fIDOF = fNDOF - fUDOF - fCDOF - fHDOF;
+
+    // Stores the DOF of the elements.
+    fElementEquations.resize(6 * fElements.size());
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        int Node0ID = fElements[i].getNode0ID();
+        int Node1ID = fElements[i].getNode1ID();
+        int Node0RotationDOF = fElements[i].getHinge0() ? hingeEquations[2 * i]
+                                                        : equations(Node0ID, 2);
+        int Node1RotationDOF = fElements[i].getHinge1()
+                                   ? hingeEquations[2 * i + 1]
+                                   : equations(Node1ID, 2);
+
         fElements[i].setEquations(equations(Node0ID, 0), equations(Node0ID, 1),
                                   Node0RotationDOF, equations(Node1ID, 0),
                                   equations(Node1ID, 1), Node1RotationDOF);
+        for (int j = 0; j < 6; j++) {
+            fElementEquations[6 * i + j] = fElements[i].getEquations()[j];
+        }
+    }
+
+    // Lists the DOF of each substructure: the interior ones, then those of
+    // its boundary nodes that remain in K, in the order they are met.
+    int dim = fUDOF + fCDOF;
+    std::vector<int> mark(dim, -1);
+    fSubstructureEquations.assign(nSubstructures, std::vector<int>());
+    fSubstructureNInterior.resize(nSubstructures);
+    for (int s = 0; s < nSubstructures; s++) {
+        std::vector<int>& list = fSubstructureEquations[s];
+        for (int equation = firstInterior[s]; equation < firstInterior[s + 1]; equation++) {
+            list.push_back(equation);
+        }
+        fSubstructureNInterior[s] = list.size();
+        for (int id : fCondensedSubstructures[s]) {
+            for (int j = 0; j < 6; j++) {
+                int equation = fElementEquations[6 * id + j];
+                if (equation >= 0 && equation < dim && mark[equation] != s) {
+                    mark[equation] = s;
+                    list.push_back(equation);
+                }
+            }
+        }
     }
 
     fNodeEquations = equations;
+    fHasEquations = true;
 }
 
-//! Gets the structure stiffness matrix.
-TPZFMatrix<double> TStructure::getK() const
+//! Marks the enumerated degrees of freedom as outdated.
+void TStructure::invalidateEquations()
 {
-    return fK;
+    fHasEquations = false;
 }
 
-//! Gets the left upper block of the structure stiffness matrix K.
-TPZFMatrix<double> TStructure::getK11() const
+//! Enables numbering the unconstrained DOF in Reverse Cuthill-McKee node order.
+void TStructure::setRenumbering(bool Renumber)
 {
-    int UDOF = this->getUDOF();
-    TPZFMatrix<double> K11(UDOF, UDOF, 0);
+    fRenumber = Renumber;
+    invalidateEquations();
+}
 
-    for (int i = 0; i < UDOF; i++) {
-        for (int j = 0; j < UDOF; j++) {
-            K11(i, j) = fK.Get(i, j);
-        }
-    }
-    return K11;
+//! Gets if the unconstrained DOF are numbered in Reverse Cuthill-McKee node order.
+bool TStructure::getRenumbering() const
+{
+    return fRenumber;
 }
 
-//! Gets the right upper block of the structure stiffness matrix K.
-TPZFMatrix<double> TStructure::getK12() const
+//! Enables condensing the rotations of hinged element ends out of K, element by element.
+void TStructure::setCondenseHinges(bool Condense)
 {
-    int UDOF = this->getUDOF();
-    int CDOF = this->getCDOF();
+    fCondenseHinges = Condense;
+    invalidateEquations();
+}
+
+//! Gets if the rotations of hinged element ends are condensed out of K.
+bool TStructure::getCondenseHinges() const
+{
+    return fCondenseHinges;
+}
+
+//! Modifies the number of subdomains the elements are split into when no substructure is declared (1: none).
+void TStructure::setNumberOfSubdomains(int NSubdomains)
+{
+    fNSubdomains = NSubdomains;
+    invalidateEquations();
+}
+
+//! Gets the number of subdomains the elements are split into when no substructure is declared (1: none).
+int TStructure::getNumberOfSubdomains() const
+{
+    return fNSubdomains;
+}
+
+//! Modifies the method used to solve K11 * Du = F.
+void TStructure::setSolverType(ESolverType Type)
+{
+    fSolverType = Type;
+}
 
-    TPZFMatrix<double> K12(UDOF, CDOF, 0);
+//! Gets the method used to solve K11 * Du = F.
+ESolverType TStructure::getSolverType() const
+{
+    return fSolverType;
+}
+
+//! Gets the solver holding the last factorization of K11 (nullptr before the first solve).
+const TLinearSolver* TStructure::getSolver() const
+{
+    return fSolver;
+}
+
+//! Computes a hash of everything the matrix K and the factorization of K11 depend on.
+uint64_t TStructure::getModelSignature() const
+{
+    // The loads are left out, so models that differ only in loads share a
+    // signature.
+    return hashModel(getModelValues(true));
+}
 
-    for (int i = 0; i < UDOF; i++) {
-        for (int j = 0; j < CDOF; j++) {
-            K12(i, j) = fK.Get(i, UDOF + j);
+//! Lists the values of the model, with or without the materials and hinges of the elements.
+std::vector<int64_t> TStructure::getModelValues(bool Properties) const
+{
+    // The nodes, supports, connectivity and the settings that change the
+    // numbering, K or the solver, and optionally the materials and the hinges
+    // and material of each element, each stored bitwise in one word. Two
+    // models give the same K and factorization of K11 if their lists are equal.
+    std::vector<int64_t> values;
+    values.reserve(32 + 2 * fNodes.size() + 3 * fMaterials.size() +
+                   4 * fSupports.size() + 5 * fElements.size());
+    auto add = [&values](auto Value) {
+        static_assert(sizeof(Value) <= sizeof(int64_t), "Value too large");
+        int64_t word = 0;
+        std::memcpy(&word, &Value, sizeof(Value));
+        values.push_back(word);
+    };
+
+    add(fNodes.size());
+    for (const TNode& node : fNodes) {
+        add(node.getX());
+        add(node.getY());
+    }
+    if (Properties) {
+        add(fMaterials.size());
+        for (const TMaterial& material : fMaterials) {
+            add(material.getE());
+            add(material.getA());
+            add(material.getI());
         }
     }
-    return K12;
+    add(fSupports.size());
+    for (const TSupport& support : fSupports) {
+        add(support.getNodeID());
+        add(support.RestrictsFx());
+        add(support.RestrictsFy());
+        add(support.RestrictsM());
+    }
+    add(fElements.size());
+    for (const TElement& element : fElements) {
+        add(element.getNode0ID());
+        add(element.getNode1ID());
+        if (Properties) {
+            add(element.getHinge0());
+            add(element.getHinge1());
+            add(element.getMaterialID());
+        }
+    }
+
+    add(fSubstructures.size());
+    for (const std::vector<int>& elements : fSubstructures) {
+        add(elements.size());
+        for (int id : elements) add(id);
+    }
+
+    add(fRenumber);
+    add(fCondenseHinges);
+    add(fNSubdomains);
+    add(fSymmetricStorage);
+    add(fSolverType);
+    add(fPreconditioner);
+    add(fTolerance);
+    add(fMaxIterations);
+    return values;
 }
 
-//! Gets the left lower block of the structure stiffness matrix K.
-TPZFMatrix<double> TStructure::getK21() const
+//! Computes a hash of the values of a model (see getModelValues()).
+uint64_t TStructure::hashModel(const std::vector<int64_t>& Values)
 {
-    int CDOF = this->getCDOF();
-    int UDOF = this->getUDOF();
+    // 64-bit FNV-1a hash of the bytes of the values. It only tells different
+    // models apart quickly; equal hashes are confirmed by comparing the values.
+    uint64_t hash = 14695981039346656037ULL;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(Values.data());
+    for (size_t i = 0; i < Values.size() * sizeof(int64_t); i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+//! Gets if the last solve reused K and the factorization of K11 of the previous one.
+bool TStructure::getReusedFactorization() const
+{
+    return fReusedFactorization;
+}
 
-    TPZFMatrix<double> K21(CDOF, UDOF);
+//! Modifies the largest number of changed equations reanalyze() solves without factorizing K11.
+void TStructure::setMaxUpdateRank(int MaxRank)
+{
+    fMaxUpdateRank = MaxRank;
+}
 
-    for (int i = 0; i < CDOF; i++) {
-        for (int j = 0; j < UDOF; j++) {
-            K21(i, j) = fK.Get(UDOF + i, j);
-        }
+//! Gets the largest number of changed equations reanalyze() solves without factorizing K11.
+int TStructure::getMaxUpdateRank() const
+{
+    return fMaxUpdateRank;
+}
+
+//! Modifies the preconditioner of the EPreconditionedCG solver.
+void TStructure::setPreconditioner(EPreconditioner Preconditioner)
+{
+    fPreconditioner = Preconditioner;
+}
+
+//! Gets the preconditioner of the EPreconditionedCG solver.
+EPreconditioner TStructure::getPreconditioner() const
+{
+    return fPreconditioner;
+}
+
+//! Modifies the relative residual the EPreconditionedCG solver must reach.
+void TStructure::setTolerance(double Tolerance)
+{
+    fTolerance = Tolerance;
+}
+
+//! Gets the relative residual the EPreconditionedCG solver must reach.
+double TStructure::getTolerance() const
+{
+    return fTolerance;
+}
+
+//! Modifies the maximum number of iterations of the EPreconditionedCG solver.
+void TStructure::setMaxIterations(int MaxIterations)
+{
+    fMaxIterations = MaxIterations;
+}
+
+//! Gets the maximum number of iterations of the EPreconditionedCG solver.
+int TStructure::getMaxIterations() const
+{
+    return fMaxIterations;
+}
+
+//! Gets the iterations of the last EPreconditionedCG solve (0 for direct solvers).
+int TStructure::getIterations() const
+{
+    if (fSolver == nullptr || fSolver->getType() != EPreconditionedCG) return 0;
+    return static_cast<const TPCGSolver*>(fSolver)->getIterations();
+}
+
+//! Gets the relative residual of the last EPreconditionedCG solve (0 for direct solvers).
+double TStructure::getResidual() const
+{
+    if (fSolver == nullptr || fSolver->getType() != EPreconditionedCG) return 0.;
+    return static_cast<const TPCGSolver*>(fSolver)->getResidual();
+}
+
+//! Gets the wall time, calls and allocated bytes of each phase of the solves.
+const TSolveProfile& TStructure::getProfile() const
+{
+    return fProfile;
+}
+
+//! Zeroes the measures of the phases of the solves.
+void TStructure::resetProfile()
+{
+    fProfile.reset();
+}
+
+//! Enables storing only the upper triangle of the symmetric matrix K.
+void TStructure::setSymmetricStorage(bool Symmetric)
+{
+    fSymmetricStorage = Symmetric;
+}
+
+//! Gets if only the upper triangle of the symmetric matrix K is stored.
+bool TStructure::getSymmetricStorage() const
+{
+    return fSymmetricStorage;
+}
+
+//! Modifies the number of threads used by the element loops (0: all hardware threads).
+void TStructure::setNumberOfThreads(int NThreads)
+{
+    fNThreads = NThreads;
+}
+
+//! Gets the number of threads used by the element loops (0: all hardware threads).
+int TStructure::getNumberOfThreads() const
+{
+    return fNThreads;
+}
+
+//! Orders the nodes to reduce the bandwidth of K11.
+std::vector<int> TStructure::getNodeOrder() const
+{
+    int nNodes = fNodes.size();
+
+    // Builds the node adjacency graph: nodes sharing an element are neighbours.
+    std::vector<int> adjPtr(nNodes + 1, 0);
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        adjPtr[fElements[i].getNode0ID() + 1]++;
+        adjPtr[fElements[i].getNode1ID() + 1]++;
+    }
+    for (int n = 0; n < nNodes; n++) {
+        adjPtr[n + 1] += adjPtr[n];
+    }
+    std::vector<int> adj(adjPtr[nNodes]);
+    std::vector<int> next(adjPtr.begin(), adjPtr.end() - 1);
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        int Node0ID = fElements[i].getNode0ID();
+        int Node1ID = fElements[i].getNode1ID();
+        adj[next[Node0ID]++] = Node1ID;
+        adj[next[Node1ID]++] = Node0ID;
     }
-    return K21;
+
+    return reverseCuthillMcKee(adjPtr, adj);
 }
 
-//! Gets the right lower block of the structure stiffness matrix K.
-TPZFMatrix<double> TStructure::getK22() const
+//! Computes and stores the length, cosine and sine of each TElement object.
+void TStructure::updateGeometry()
+{
+    parallelFor(0, fElements.size(), fNThreads, [this](int First, int Last) {
+        for (int i = First; i < Last; i++) {
+            fElements[i].updateGeometry();
+        }
+    });
+}
+
+//! Gets the (sparse) structure stiffness matrix.
+const TSparseMatrix& TStructure::getK() const
+{
+    return fK;
+}
+
+//! Gets a view of the left upper block of the structure stiffness matrix K.
+TSparseBlock TStructure::getK11() const
 {
-    int CDOF = this->getCDOF();
     int UDOF = this->getUDOF();
+    return fK.getBlock(0, UDOF, 0, UDOF);
+}
 
-    TPZFMatrix<double> K22(CDOF, CDOF);
+//! Gets a view of the right upper block of the structure stiffness matrix K.
+TSparseBlock TStructure::getK12() const
+{
+    int UDOF = this->getUDOF();
+    int CDOF = this->getCDOF();
+    return fK.getBlock(0, UDOF, UDOF, CDOF);
+}
 
-    for (int i = 0; i < CDOF; i++) {
-        for (int j = 0; j < CDOF; j++) {
-            K22(i, j) = fK.Get(UDOF + i, UDOF + j);
-        }
-    }
-    return K22;
+//! Gets a view of the left lower block of the structure stiffness matrix K.
+TSparseBlock TStructure::getK21() const
+{
+    int UDOF = this->getUDOF();
+    int CDOF = this->getCDOF();
+    return fK.getBlock(UDOF, CDOF, 0, UDOF);
+}
+
+//! Gets a view of the right lower block of the structure stiffness matrix K.
+TSparseBlock TStructure::getK22() const
+{
+    int UDOF = this->getUDOF();
+    int CDOF = this->getCDOF();
+    return fK.getBlock(UDOF, CDOF, UDOF, CDOF);
 }
 
 //! Gets the vector of external loads Q.
@@ -353,29 +1033,19 @@ TPZFMatrix<double> TStructure::getQ() const
     return fQ;
 }
 
-//! Gets the known part Qk (applied nodal loads) of the external loads vector Q.
-TPZFMatrix<double> TStructure::getQK() const
+//! Gets a view of the known part Qk (applied nodal loads) of the external loads vector Q.
+TDenseBlock TStructure::getQK() const
 {
     int UDOF = this->getUDOF();
-    TPZFMatrix<double> QK(UDOF, 1, 0);
-
-    for (int i = 0; i < UDOF; i++) {
-        QK(i, 0) = fQ.Get(i, 0);
-    }
-    return QK;
+    return TDenseBlock(&fQ, 0, UDOF);
 }
 
-//! Gets the unknown part Qu (support reactions) of the external loads vector Q.
-TPZFMatrix<double> TStructure::getQU() const
+//! Gets a view of the unknown part Qu (support reactions) of the external loads vector Q.
+TDenseBlock TStructure::getQU() const
 {
     int UDOF = this->getUDOF();
     int CDOF = this->getCDOF();
-    TPZFMatrix<double> QU(CDOF, 1, 0);
-
-    for (int i = 0; i < CDOF; i++) {
-        QU(i, 0) = fQ.Get(UDOF + i, 0);
-    }
-    return QU;
+    return TDenseBlock(&fQ, UDOF, CDOF);
 }
 
 //! Gets the vector of equivalent nodal loads caused by intermediate loads.
@@ -384,29 +1054,19 @@ TPZFMatrix<double> TStructure::getQ0() const
     return fQ0;
 }
 
-//! Gets the known part Qk0 of the equivalent nodal loads vector Q0.
-TPZFMatrix<double> TStructure::getQK0() const
+//! Gets a view of the known part Qk0 of the equivalent nodal loads vector Q0.
+TDenseBlock TStructure::getQK0() const
 {
     int UDOF = this->getUDOF();
-    TPZFMatrix<double> QK0(UDOF, 1, 0);
-
-    for (int i = 0; i < UDOF; i++) {
-        QK0(i, 0) = fQ0.Get(i, 0);
-    }
-    return QK0;
+    return TDenseBlock(&fQ0, 0, UDOF);
 }
 
-//! Gets the unknown part Qu0 of the equivalent nodal loads vector Q0.
-TPZFMatrix<double> TStructure::getQU0() const
+//! Gets a view of the unknown part Qu0 of the equivalent nodal loads vector Q0.
+TDenseBlock TStructure::getQU0() const
 {
     int UDOF = this->getUDOF();
     int CDOF = this->getCDOF();
-    TPZFMatrix<double> Q0U(CDOF, 1, 0);
-
-    for (int i = 0; i < CDOF; i++) {
-        Q0U(i, 0) = fQ0.Get(UDOF + i, 0);
-    }
-    return Q0U;
+    return TDenseBlock(&fQ0, UDOF, CDOF);
 }
 
 //! Gets the vector of nodal displacements.
@@ -415,45 +1075,44 @@ TPZFMatrix<double> TStructure::getD() const
     return fD;
 }
 
-//! Gets the known displacements Dk at constrained degrees of freedom.
-TPZFMatrix<double> TStructure::getDK() const
+//! Gets a view of the known displacements Dk at constrained degrees of freedom.
+TDenseBlock TStructure::getDK() const
 {
     int UDOF = this->getUDOF();
     int CDOF = this->getCDOF();
-    TPZFMatrix<double> DK(CDOF, 1, 0);
-
-    for (int i = 0; i < CDOF; i++) {
-        DK(i, 0) = fD.Get(UDOF + i, 0);
-    }
-    return DK;
+    return TDenseBlock(&fD, UDOF, CDOF);
 }
 
-//! Gets the unknown displacements Du at unconstrained degrees of freedom.
-TPZFMatrix<double> TStructure::getDU() const
+//! Gets a view of the unknown displacements Du at unconstrained degrees of freedom.
+TDenseBlock TStructure::getDU() const
 {
     int UDOF = this->getUDOF();
-    TPZFMatrix<double> DU(UDOF, 1, 0);
+    return TDenseBlock(&fD, 0, UDOF);
+}
 
-    for (int i = 0; i < UDOF; i++) {
-        DU(i, 0) = fD.Get(i, 0);
-    }
-    return DU;
+//! Gets the number of load cases (columns of Q, Q0 and D) of the last solution.
+int TStructure::getNCases() const
+{
+    return (int)fD.Cols();
 }
 
-//! Calculates the internal loads of a given element.
-void TStructure::getInternalLoads(int ElementID, TPZFMatrix<double>& q)
+//! Calculates the internal loads of a given element for a given load case.
+void TStructure::getInternalLoads(int ElementID, TPZFMatrix<double>& q,
+                                  int Case)
 {
-    TPZFMatrix<double> localK = this->getElement(ElementID).getLocalK();
-    TPZFMatrix<double> T = this->getElement(ElementID).getT();
-    TPZFMatrix<double> q0 = this->getElement(ElementID).getQ0();
+    TElement& element = fElements[ElementID];
 
-    TPZFMatrix<double> D(6, 1, 0);
+    TElementVector D;
+    TElementVector q0;
     for (int i = 0; i < 6; i++)
     {
-        D(i, 0) = fD(this->getElement(ElementID).getEquations()[i], 0);
+        D(i, 0) = fD(element.getEquations()[i], Case);
+        q0(i, 0) = fElementQ0(6 * ElementID + i, Case);
     }
 
-    q = localK * T * D + q0;
+    // The displacements are rotated first, so only matrix-vector products
+    // are needed.
+    q = (element.getLocalK() * (element.getT() * D) + q0).toDense();
 }
 
 //! Solve all the steps of structure accordingly to get the final results.
@@ -463,72 +1122,638 @@ void TStructure::solve(std::vector<TNodalLoad>& NodalLoads,
     //std::vector<TSupportDisplacement>& SupportDisplacements,
                        std::vector<TPZFMatrix<double>>& InternalLoads)
 {
-    fD = TPZFMatrix<double>(this->getNDOF(), 1, 0);
-    fQ = TPZFMatrix<double>(this->getNDOF(), 1, 0);
+    std::vector<TLoadCase> loadCases(
+        1, TLoadCase("", NodalLoads, DistrLoads, EndMoments));
+    std::vector<TLoadCaseResult> results;
+    solve(loadCases, results);
 
-    enumerateEquations();
+    // Keeps the initial loads of the single load case in the elements.
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        TElementVector q0;
+        for (int j = 0; j < 6; j++) {
+            q0(j, 0) = fElementQ0(6 * i + j, 0);
+        }
+        fElements[i].setQ0(q0);
+    }
 
-    populateK();
-    populateQ(NodalLoads, EndMoments);
-    populateQ0(DistrLoads);
+    const std::vector<TPZFMatrix<double>>& internalLoads =
+        results[0].getInternalLoads();
+    InternalLoads.insert(InternalLoads.end(), internalLoads.begin(),
+                         internalLoads.end());
+}
+
+//! Solves many load cases at once, with a single factorization of K11.
+void TStructure::solve(std::vector<TLoadCase>& LoadCases,
+                       std::vector<TLoadCaseResult>& Results)
+{
+    updateGeometry();
+
+    // When only the loads changed since the last solve, K and the
+    // factorization of K11 are kept and only Q, Q0 and D are recomputed.
+    std::vector<int64_t> model = getModelValues(true);
+    uint64_t signature = hashModel(model);
+    fReusedFactorization = fHasFactorization && signature == fFactorSignature &&
+                           model == fFactorModel;
+    if (!fReusedFactorization || !fHasEquations) {
+        enumerateEquations();
+    }
+
+    // Each load case is a column of D and Q.
+    int nCases = LoadCases.size();
+    fD = TPZFMatrix<double>(fNDOF, nCases, 0);
+    fQ = TPZFMatrix<double>(fNDOF, nCases, 0);
+
+    if (!fReusedFactorization) {
+        fHasFactorization = false;
+        populateK();
+    }
+    populateQ(LoadCases);
+    populateQ0(LoadCases);
     //populateDK(/*SupportDisplacements*/);
     solveDU();
     solveQU();
+    recoverHinges();
+    recoverSubstructures();
+    if (!fReusedFactorization) {
+        storeBaseModel();
+    }
+    fHasFactorization = true;
+    fFactorSignature = signature;
+    fFactorModel.swap(model);
 
-    for (int i = 0; i < (int)this->getElements().size(); i++) {
-        TPZFMatrix<double> qLocal;
-        getInternalLoads(i, qLocal);
-        InternalLoads.push_back(qLocal);
+    splitResults(LoadCases, Results);
+}
+
+//! Modifies the materials and the elements and solves again, updating the last factorization of K11.
+bool TStructure::reanalyze(const std::vector<TMaterial>& Materials,
+                           const std::vector<TElement>& Elements,
+                           std::vector<TLoadCase>& LoadCases,
+                           std::vector<TLoadCaseResult>& Results)
+{
+    setMaterials(Materials);
+    setElements(Elements);
+
+    // The factorization is updated only for the nodes, supports, connectivity
+    // and settings it was computed for. Otherwise solve() factorizes K11
+    // again, or reuses it if nothing changed.
+    std::vector<int64_t> model = getModelValues(true);
+    if (fHasFactorization && hashModel(model) == fFactorSignature &&
+        model == fFactorModel) {
+        solve(LoadCases, Results);
+        return true;
+    }
+    std::vector<int64_t> topology = getModelValues(false);
+    if (!fHasBaseModel || hashModel(topology) != fBaseTopology ||
+        topology != fBaseTopologyModel) {
+        solve(LoadCases, Results);
+        return false;
+    }
+
+    updateGeometry();
+    enumerateEquations();
+    int nElements = fElements.size();
+
+    // Lists the elements whose material or hinges differ from the base model.
+    std::vector<int> changed;
+    for (int i = 0; i < nElements; i++) {
+        const TMaterial& material = fMaterials[fElements[i].getMaterialID()];
+        const TMaterial& base = fBaseMaterials[fBaseElementMaterials[i]];
+        int hinges = (fElements[i].getHinge0() ? 1 : 0) |
+                     (fElements[i].getHinge1() ? 2 : 0);
+        if (material.getE() != base.getE() || material.getA() != base.getA() ||
+            material.getI() != base.getI() || hinges != fBaseElementHinges[i]) {
+            changed.push_back(i);
+        }
+    }
+
+    // Maps the unconstrained DOF to those of the base model. The node DOF
+    // and the rotations of the ends hinged in both models keep their base
+    // equation. The others (newly hinged ends, or nodes whose ends were all
+    // hinged) become new equations, numbered after the base ones.
+    std::vector<int> equations(fUDOF, -1);
+    for (int n = 0; n < (int)fNodes.size(); n++) {
+        for (int k = 0; k < 3; k++) {
+            int equation = fNodeEquations.GetVal(n, k);
+            int base = fBaseNodeEquations.GetVal(n, k);
+            if (equation >= 0 && equation < fUDOF && base >= 0 && base < fBaseUDOF) {
+                equations[equation] = base;
+            }
+        }
+    }
+    for (int i = 0; i < nElements; i++) {
+        for (int node = 0; node < 2; node++) {
+            bool hinge = (node == 0) ? fElements[i].getHinge0() : fElements[i].getHinge1();
+            if (hinge && (fBaseElementHinges[i] & (1 << node))) {
+                equations[fElementEquations[6 * i + 3 * node + 2]] =
+                    fBaseElementEquations[6 * i + 3 * node + 2];
+            }
+        }
+    }
+    std::vector<char> mapped(fBaseUDOF, 0);
+    int nNew = 0;
+    for (int& equation : equations) {
+        if (equation < 0) equation = fBaseUDOF + nNew++;
+        else mapped[equation] = 1;
+    }
+
+    // The change of K11 is the new minus the base matrix of each changed
+    // element. Base equations left without a DOF (the rotations of ends no
+    // longer hinged) keep only their diagonal, so they decouple.
+    std::vector<int> rows, cols;
+    std::vector<double> values;
+    for (int i : changed) {
+        const TElement& element = fElements[i];
+        double L = element.getL();
+        double lx = element.getCos();
+        double ly = element.getSin();
+        for (int model = 0; model < 2; model++) {
+            bool base = (model == 0);
+            const TMaterial& material = base ? fBaseMaterials[fBaseElementMaterials[i]]
+                                             : fMaterials[element.getMaterialID()];
+            double E = material.getE();
+            double A = material.getA();
+            double I = material.getI();
+            double upper[kElementKEntries];
+            computeElementsK(1, &L, &lx, &ly, &E, &A, &I, upper);
+            TElementMatrix K = unpackElementK(upper, 1);
+
+            const int* elementEquations = base ? &fBaseElementEquations[6 * i]
+                                               : &fElementEquations[6 * i];
+            int UDOF = base ? fBaseUDOF : fUDOF;
+            for (int a = 0; a < 6; a++) {
+                int row = elementEquations[a];
+                if (row >= UDOF) continue;
+                for (int b = 0; b < 6; b++) {
+                    int col = elementEquations[b];
+                    if (col >= UDOF) continue;
+                    rows.push_back(base ? row : equations[row]);
+                    cols.push_back(base ? col : equations[col]);
+                    values.push_back(base ? -K(a, b) : K(a, b));
+                }
+                if (base && !mapped[row]) {
+                    rows.push_back(row);
+                    cols.push_back(row);
+                    values.push_back(K(a, a));
+                }
+            }
+        }
+    }
+
+    TLowRankUpdate update;
+    bool updated;
+    {
+        TPhaseTimer timer(fProfile, ESolveDU);
+        updated = update.setup(*fSolver, fBaseUDOF, equations, rows, cols,
+                               values, fMaxUpdateRank);
+    }
+    if (!updated) {
+        // Too many equations changed: factorizing K11 again is cheaper.
+        solve(LoadCases, Results);
+        return false;
+    }
+
+    // K, Q and Q0 are assembled for the modified model as usual; only the
+    // solution of K11 * Du = F goes through the update. fSolver keeps the
+    // base model, which no longer matches K.
+    int nCases = LoadCases.size();
+    fD = TPZFMatrix<double>(fNDOF, nCases, 0);
+    fQ = TPZFMatrix<double>(fNDOF, nCases, 0);
+    fHasFactorization = false;
+    fReusedFactorization = false;
+    populateK();
+    populateQ(LoadCases);
+    populateQ0(LoadCases);
+    solveDU(&update);
+    solveQU();
+    recoverHinges();
+    recoverSubstructures();
+
+    splitResults(LoadCases, Results);
+    return true;
+}
+
+//! Splits D and Q by load case and computes the internal loads of each one.
+void TStructure::splitResults(std::vector<TLoadCase>& LoadCases,
+                              std::vector<TLoadCaseResult>& Results)
+{
+    TPhaseTimer timer(fProfile, EInternalLoads);
+    int nCases = LoadCases.size();
+    Results.clear();
+    Results.reserve(nCases);
+    for (int c = 0; c < nCases; c++) {
+        TPZFMatrix<double> D(fNDOF, 1, 0);
+        TPZFMatrix<double> Q(fNDOF, 1, 0);
+        for (int i = 0; i < fNDOF; i++) {
+            D(i, 0) = fD(i, c);
+            Q(i, 0) = fQ(i, c);
+        }
+
+        std::vector<TPZFMatrix<double>> internalLoads(fElements.size());
+        for (int i = 0; i < (int)fElements.size(); i++) {
+            getInternalLoads(i, internalLoads[i], c);
+        }
+        Results.push_back(
+            TLoadCaseResult(LoadCases[c].getName(), D, Q, internalLoads));
+    }
+}
+
+//! Groups the elements in colors, so that no two elements of a color share a node.
+void TStructure::colorElements(std::vector<int>& ColorPtr,
+                               std::vector<int>& ColorElements) const
+{
+    int nNodes = fNodes.size();
+    int nElements = fElements.size();
+
+    // Lists the elements connected to each node.
+    std::vector<int> nodePtr(nNodes + 1, 0);
+    for (int i = 0; i < nElements; i++) {
+        nodePtr[fElements[i].getNode0ID() + 1]++;
+        nodePtr[fElements[i].getNode1ID() + 1]++;
+    }
+    for (int n = 0; n < nNodes; n++) {
+        nodePtr[n + 1] += nodePtr[n];
+    }
+    std::vector<int> nodeElements(nodePtr[nNodes]);
+    std::vector<int> next(nodePtr.begin(), nodePtr.end() - 1);
+    for (int i = 0; i < nElements; i++) {
+        nodeElements[next[fElements[i].getNode0ID()]++] = i;
+        nodeElements[next[fElements[i].getNode1ID()]++] = i;
+    }
+
+    // Greedy coloring, in element order: each element gets the smallest
+    // color not used by an element sharing one of its nodes.
+    std::vector<int> colors(nElements, -1);
+    std::vector<int> used;
+    int nColors = 0;
+    for (int i = 0; i < nElements; i++) {
+        int NodesIDs[2] = {fElements[i].getNode0ID(), fElements[i].getNode1ID()};
+        for (int node = 0; node < 2; node++) {
+            for (int k = nodePtr[NodesIDs[node]]; k < nodePtr[NodesIDs[node] + 1]; k++) {
+                int color = colors[nodeElements[k]];
+                if (color >= 0) used[color] = i;
+            }
+        }
+        int color = 0;
+        while (color < nColors && used[color] == i) {
+            color++;
+        }
+        if (color == nColors) {
+            used.push_back(-1);
+            nColors++;
+        }
+        colors[i] = color;
+    }
+
+    // Lists the elements of each color, in increasing order.
+    ColorPtr.assign(nColors + 1, 0);
+    for (int i = 0; i < nElements; i++) {
+        ColorPtr[colors[i] + 1]++;
+    }
+    for (int c = 0; c < nColors; c++) {
+        ColorPtr[c + 1] += ColorPtr[c];
+    }
+    ColorElements.resize(nElements);
+    next.assign(ColorPtr.begin(), ColorPtr.end() - 1);
+    for (int i = 0; i < nElements; i++) {
+        ColorElements[next[colors[i]]++] = i;
     }
 }
 
 //! Assembles the structure stiffness matrix.
 void TStructure::populateK()
 {
-    int NDOF = this->getNDOF();
-    fK = TPZFMatrix<double>(NDOF, NDOF, 0);
+    TPhaseTimer timer(fProfile, EPopulateK);
+
+    // Builds the sparsity pattern from the equations of the elements. The
+    // condensed hinge rotations and interior DOF are left out of K.
+    int dim = fUDOF + fCDOF;
+    std::vector<int> condensedEquations;
+    if (fNDOF > dim) {
+        condensedEquations = fElementEquations;
+        for (int& equation : condensedEquations) {
+            if (equation >= dim) equation = -1;
+        }
+    }
+    const std::vector<int>& equations =
+        (fNDOF > dim) ? condensedEquations : fElementEquations;
+    if (fCondensedSubstructures.empty()) {
+        fK.setPattern(dim, equations, 6, fSymmetricStorage);
+    }
+    else {
+        // A substructure couples all its boundary DOF, through its
+        // condensed matrix, instead of its elements.
+        std::vector<int64_t> groupPtr(1, 0);
+        std::vector<int> groups;
+        for (int i = 0; i < (int)fElements.size(); i++) {
+            if (fElementSubstructures[i] >= 0) continue;
+            groups.insert(groups.end(), &equations[6 * i], &equations[6 * i] + 6);
+            groupPtr.push_back(groups.size());
+        }
+        for (int s = 0; s < (int)fCondensedSubstructures.size(); s++) {
+            const std::vector<int>& list = fSubstructureEquations[s];
+            groups.insert(groups.end(), list.begin() + fSubstructureNInterior[s],
+                          list.end());
+            groupPtr.push_back(groups.size());
+        }
+        fK.setPattern(dim, groupPtr, groups, fSymmetricStorage);
+    }
 
-    for (int i = 0; i < (int)fElements.size(); i++) {
-        TElement elem = fElements[i];
-        TPZFMatrix<double> kLocal = elem.getK();
+    // Elements of the same color share no equation, so their blocks are
+    // added by several threads at once. The colors are added in sequence,
+    // which sums each entry of K in the same order for any number of threads.
+    std::vector<int> colorPtr, coloredElements;
+    colorElements(colorPtr, coloredElements);
+
+    for (int c = 0; c + 1 < (int)colorPtr.size(); c++) {
+        parallelFor(colorPtr[c], colorPtr[c + 1], fNThreads,
+                    [this, &coloredElements, &equations](int First, int Last) {
+            // The element matrices are computed in batches, from contiguous
+            // arrays of element data, and then added to K one by one.
+            const int batchSize = 256;
+            double L[batchSize], lx[batchSize], ly[batchSize];
+            double E[batchSize], A[batchSize], I[batchSize];
+            std::vector<double> upper(kElementKEntries * batchSize);
+
+            for (int first = First; first < Last; first += batchSize) {
+                int n = std::min(batchSize, Last - first);
+                for (int b = 0; b < n; b++) {
+                    const TElement& elem = fElements[coloredElements[first + b]];
+                    const TMaterial& material = fMaterials[elem.getMaterialID()];
+                    L[b] = elem.getL();
+                    lx[b] = elem.getCos();
+                    ly[b] = elem.getSin();
+                    E[b] = material.getE();
+                    A[b] = material.getA();
+                    I[b] = material.getI();
+                }
+                computeElementsK(n, L, lx, ly, E, A, I, upper.data());
+
+                for (int b = 0; b < n; b++) {
+                    int id = coloredElements[first + b];
+                    const TElement& elem = fElements[id];
+                    if (fElementSubstructures[id] >= 0) continue;
+                    if (fCondenseHinges && (elem.getHinge0() || elem.getHinge1())) {
+                        // Pinned-end stiffness: the hinge rotations are
+                        // eliminated from the element matrix.
+                        TElementMatrix K = unpackElementK(&upper[b], n);
+                        if (elem.getHinge0()) condenseElementDOF(K, 2);
+                        if (elem.getHinge1()) condenseElementDOF(K, 5);
+                        packElementK(K, &upper[b], n);
+                    }
+                    fK.addUpperBlock(&equations[6 * id], &upper[b], n);
+                }
+            }
+        });
+    }
 
-        for (int aux1 = 0; aux1 < 6; aux1++) {
-            for (int aux2 = 0; aux2 < 6; aux2++) {
-                fK(elem.getEquations()[aux1], elem.getEquations()[aux2]) +=
-                    kLocal(aux1, aux2);
+    // Adds the condensed matrices of the substructures.
+    condenseSubstructures();
+    for (int s = 0; s < (int)fCondensedSubstructures.size(); s++) {
+        const TSuperelement& superelement =
+            fSuperelements[fSubstructureSuperelements[s]];
+        fK.addBlock(&fSubstructureEquations[s][fSubstructureNInterior[s]],
+                    superelement.getS());
+    }
+}
+
+//! Condenses the subdomains of the domain decomposition to their interfaces, in parallel.
+void TStructure::condenseSubdomains()
+{
+    // Each subdomain is assembled into a sparse matrix and its interior is
+    // factorized on its own thread. The subdomains are all different, so
+    // each one gets its own superelement.
+    int nSubdomains = fCondensedSubstructures.size();
+    fSuperelements.assign(nSubdomains, TSuperelement());
+    fSubstructureSuperelements.resize(nSubdomains);
+    parallelForEach(0, nSubdomains, fNThreads, [this](int s) {
+        const std::vector<int>& list = fSubstructureEquations[s];
+        const std::vector<int>& elements = fCondensedSubstructures[s];
+        int n = list.size();
+        std::vector<int> local(fNDOF, -1);
+        for (int k = 0; k < n; k++) {
+            local[list[k]] = k;
+        }
+
+        std::vector<int> equations(6 * elements.size());
+        for (int k = 0; k < (int)elements.size(); k++) {
+            for (int j = 0; j < 6; j++) {
+                int equation = fElementEquations[6 * elements[k] + j];
+                equations[6 * k + j] = (equation >= 0) ? local[equation] : -1;
             }
         }
-    }
+        TSparseMatrix K;
+        K.setPattern(n, equations, 6, true);
+        for (int k = 0; k < (int)elements.size(); k++) {
+            K.addBlock(&equations[6 * k], fElements[elements[k]].getK());
+        }
+
+        fSuperelements[s].condense(K, fSubstructureNInterior[s], ESparseCholeskyAMD);
+        fSubstructureSuperelements[s] = s;
+    });
 }
 
-//! Stores the effects of loads into Q.
-void TStructure::populateQ(std::vector<TNodalLoad>& NodalLoads,
-                           std::vector<TElementEndMoment>& EndMoments)
+//! Condenses each substructure to its boundary DOF, once per distinct substructure.
+void TStructure::condenseSubstructures()
 {
-    for (int i = 0; i < (int)NodalLoads.size(); i++) {
-        NodalLoads[i].store(fQ);
+    if (fSubstructures.empty() && !fCondensedSubstructures.empty()) {
+        condenseSubdomains();
+        return;
     }
 
-    for (int i = 0; i < (int)EndMoments.size(); i++) {
-        EndMoments[i].store(fQ);
+    // Substructures with the same elements, materials, hinges, numbering
+    // pattern and shape (up to a translation) share one superelement. The
+    // shape is compared with the coordinates rounded to a small fraction of
+    // the size of the substructure. The cache is keyed on the full list of
+    // compared values, so distinct substructures never share a superelement.
+    int nSubstructures = fCondensedSubstructures.size();
+    fSuperelements.clear();
+    fSubstructureSuperelements.assign(nSubstructures, -1);
+    std::map<std::vector<int64_t>, int> cache;
+    std::vector<int> local(fNDOF, -1);
+
+    for (int s = 0; s < nSubstructures; s++) {
+        const std::vector<int>& list = fSubstructureEquations[s];
+        const std::vector<int>& elements = fCondensedSubstructures[s];
+        int n = list.size();
+        for (int k = 0; k < n; k++) {
+            local[list[k]] = k;
+        }
+
+        const TNode& origin = fNodes[fElements[elements[0]].getNode0ID()];
+        double extent = 0.;
+        for (int id : elements) {
+            int NodesIDs[2] = {fElements[id].getNode0ID(), fElements[id].getNode1ID()};
+            for (int node = 0; node < 2; node++) {
+                const TNode& point = fNodes[NodesIDs[node]];
+                extent = std::max(extent, std::abs(point.getX() - origin.getX()));
+                extent = std::max(extent, std::abs(point.getY() - origin.getY()));
+            }
+        }
+        double tolerance = (extent > 0.) ? 1e-9 * extent : 1.;
+
+        std::vector<int64_t> key;
+        key.reserve(2 + 15 * elements.size());
+        auto add = [&key](auto Value) {
+            static_assert(sizeof(Value) <= sizeof(int64_t), "Value too large");
+            int64_t word = 0;
+            std::memcpy(&word, &Value, sizeof(Value));
+            key.push_back(word);
+        };
+        add(n);
+        add(fSubstructureNInterior[s]);
+        for (int id : elements) {
+            const TElement& element = fElements[id];
+            const TMaterial& material = fMaterials[element.getMaterialID()];
+            for (int j = 0; j < 6; j++) {
+                int equation = fElementEquations[6 * id + j];
+                add((equation >= 0) ? local[equation] : -1);
+            }
+            add(element.getHinge0());
+            add(element.getHinge1());
+            add(material.getE());
+            add(material.getA());
+            add(material.getI());
+            int NodesIDs[2] = {element.getNode0ID(), element.getNode1ID()};
+            for (int node = 0; node < 2; node++) {
+                const TNode& point = fNodes[NodesIDs[node]];
+                add(std::llround((point.getX() - origin.getX()) / tolerance));
+                add(std::llround((point.getY() - origin.getY()) / tolerance));
+            }
+        }
+
+        auto found = cache.find(key);
+        if (found != cache.end()) {
+            fSubstructureSuperelements[s] = found->second;
+        }
+        else {
+            // Assembles the dense matrix of the substructure, in the order of
+            // its DOF list, and condenses it.
+            TPZFMatrix<double> K(n, n, 0.);
+            for (int id : elements) {
+                const TElement& element = fElements[id];
+                TElementMatrix Ke = element.getK();
+                const int* equations = &fElementEquations[6 * id];
+                for (int a = 0; a < 6; a++) {
+                    int row = equations[a];
+                    if (row < 0 || local[row] < 0) continue;
+                    for (int b = 0; b < 6; b++) {
+                        int col = equations[b];
+                        if (col < 0 || local[col] < 0) continue;
+                        K(local[row], local[col]) += Ke(a, b);
+                    }
+                }
+            }
+            fSuperelements.push_back(TSuperelement());
+            fSuperelements.back().condense(K, fSubstructureNInterior[s]);
+            fSubstructureSuperelements[s] = fSuperelements.size() - 1;
+            cache.emplace(std::move(key), fSubstructureSuperelements[s]);
+        }
+
+        for (int k = 0; k < n; k++) {
+            local[list[k]] = -1;
+        }
     }
 }
 
-//! Stores the effects of distributed loads into Q0.
-void TStructure::populateQ0(std::vector<TDistributedLoad>& DistrLoads)
+//! Stores the effects of loads into Q, one column per load case.
+void TStructure::populateQ(std::vector<TLoadCase>& LoadCases)
 {
-    fQ0 = TPZFMatrix<double>(this->getNDOF(), 1, 0);
+    TPhaseTimer timer(fProfile, EPopulateQ);
+
+    for (int c = 0; c < (int)LoadCases.size(); c++) {
+        std::vector<TNodalLoad>& NodalLoads = LoadCases[c].getNodalLoads();
+        for (int i = 0; i < (int)NodalLoads.size(); i++) {
+            NodalLoads[i].store(fQ, c);
+        }
 
-    for (int i = 0; i < (int)DistrLoads.size(); i++) {
-        DistrLoads[i].store();
+        std::vector<TElementEndMoment>& EndMoments = LoadCases[c].getEndMoments();
+        for (int i = 0; i < (int)EndMoments.size(); i++) {
+            EndMoments[i].store(fQ, c);
+        }
     }
+}
 
+//! Stores the effects of distributed loads into Q0, one column per load case.
+void TStructure::populateQ0(std::vector<TLoadCase>& LoadCases)
+{
+    TPhaseTimer timer(fProfile, EPopulateQ0);
+
+    int nCases = LoadCases.size();
+
+    // Sums the local initial loads of each element and load case.
+    fElementQ0 = TPZFMatrix<double>(6 * fElements.size(), nCases, 0);
+    for (int c = 0; c < nCases; c++) {
+        std::vector<TDistributedLoad>& DistrLoads = LoadCases[c].getDistrLoads();
+        for (int i = 0; i < (int)DistrLoads.size(); i++) {
+            TElementVector q0 = DistrLoads[i].getLocalQ0();
+            int ElementID = DistrLoads[i].getElementID();
+            for (int j = 0; j < 6; j++) {
+                fElementQ0(6 * ElementID + j, c) += q0(j, 0);
+            }
+        }
+    }
+
+    // Rotates them to global coordinates and adds them to Q0. The loads of
+    // elements with condensed hinges are condensed like their matrices; the
+    // hinge rows keep the loads on the hinge rotations, used to recover them.
+    fQ0 = TPZFMatrix<double>(fNDOF, nCases, 0);
     for (int i = 0; i < (int)fElements.size(); i++)
     {
-        TPZFMatrix<double> q0 = fElements[i].getTT() * fElements[i].getQ0();
-        for (int j = 0; j < 6; j++) {
-            int DOF = fElements[i].getEquations()[j];
-            fQ0(DOF, 0) += q0(j, 0);
+        TElement& element = fElements[i];
+        TElementMatrix TT = element.getTT();
+        bool condensed = fCondenseHinges && fElementSubstructures[i] < 0 &&
+                         (element.getHinge0() || element.getHinge1());
+        TElementMatrix K;
+        if (condensed) K = element.getK();
+        for (int c = 0; c < nCases; c++) {
+            double q0[6];
+            for (int j = 0; j < 6; j++) {
+                double sum = 0.;
+                for (int k = 0; k < 6; k++) {
+                    sum += TT(j, k) * fElementQ0(6 * i + k, c);
+                }
+                q0[j] = sum;
+            }
+            if (condensed) {
+                double hinges[2] = {q0[2], q0[5]};
+                TElementMatrix Kc = K;
+                if (element.getHinge0()) condenseElementDOF(Kc, 2, q0);
+                if (element.getHinge1()) condenseElementDOF(Kc, 5, q0);
+                if (element.getHinge0()) q0[2] = hinges[0];
+                if (element.getHinge1()) q0[5] = hinges[1];
+            }
+            for (int j = 0; j < 6; j++) {
+                fQ0(element.getEquations()[j], c) += q0[j];
+            }
+        }
+    }
+
+    // The loads on the interior of each substructure reach K through its
+    // boundary; the interior rows keep them, to recover the interior. The
+    // substructures are condensed in parallel and their boundary loads,
+    // which may share rows, added in sequence.
+    int nSubstructures = fCondensedSubstructures.size();
+    std::vector<TPZFMatrix<double>> boundaryLoads(nSubstructures);
+    parallelForEach(0, nSubstructures, fNThreads, [this, nCases, &boundaryLoads](int s) {
+        const TSuperelement& superelement =
+            fSuperelements[fSubstructureSuperelements[s]];
+        const std::vector<int>& list = fSubstructureEquations[s];
+        int nInterior = fSubstructureNInterior[s];
+        TPZFMatrix<double> FI(nInterior, nCases, 0.);
+        for (int c = 0; c < nCases; c++) {
+            for (int k = 0; k < nInterior; k++) {
+                FI(k, c) = fQ.GetVal(list[k], c) - fQ0.GetVal(list[k], c);
+            }
+        }
+        superelement.condenseLoads(FI, boundaryLoads[s]);
+    });
+    for (int s = 0; s < nSubstructures; s++) {
+        const std::vector<int>& list = fSubstructureEquations[s];
+        int nInterior = fSubstructureNInterior[s];
+        for (int c = 0; c < nCases; c++) {
+            for (int k = nInterior; k < (int)list.size(); k++) {
+                fQ0(list[k], c) += boundaryLoads[s](k - nInterior, c);
+            }
         }
     }
 }
@@ -545,25 +1770,73 @@ std::vector<TSupportDisplacement>& supportDisplacements)
 	}
 }*/
 
+//! Computes the factorization of K11 and stores it.
+void TStructure::factorizeK11()
+{
+    if (fSolver == nullptr || fSolver->getType() != fSolverType) {
+        delete fSolver;
+        fSolver = TLinearSolver::create(fSolverType);
+    }
+
+    if (fSolverType == EPreconditionedCG) {
+        // The blocks of the block Jacobi preconditioner are the unconstrained
+        // DOF of each node.
+        TPCGSolver* pcg = static_cast<TPCGSolver*>(fSolver);
+        pcg->setPreconditioner(fPreconditioner);
+        pcg->setTolerance(fTolerance);
+        pcg->setMaxIterations(fMaxIterations);
+        std::vector<int> blocks(fUDOF, -1);
+        for (int n = 0; n < (int)fNodeEquations.Rows(); n++) {
+            for (int k = 0; k < (int)fNodeEquations.Cols(); k++) {
+                int equation = fNodeEquations.GetVal(n, k);
+                if (equation >= 0 && equation < fUDOF) blocks[equation] = n;
+            }
+        }
+        pcg->setBlocks(blocks);
+    }
+
+    // K11 is symmetric positive definite for a stable structure.
+    fSolver->factorize(this->getK11());
+}
+
 //! Calculates the unknown displacements Du and stores them into D.
-void TStructure::solveDU()
+void TStructure::solveDU(const TLowRankUpdate* Update)
 {
+    TPhaseTimer timer(fProfile, ESolveDU);
+
     int UDOF = this->getUDOF();
-    int NDOF = this->getNDOF();
+    int nCases = this->getNCases();
 
     if (UDOF != 0) {
-        TPZFMatrix<double> DU(UDOF, 1, 0);
-        TPZFMatrix<double> invK11;
-        this->getK11().Inverse(invK11, ELU);
-        TPZFMatrix<double> QK = this->getQK();
-        TPZFMatrix<double> K12 = this->getK12();
-        TPZFMatrix<double> DK = this->getDK();
-        TPZFMatrix<double> QK0 = this->getQK0();
+        TDenseBlock QK = this->getQK();
+        TDenseBlock QK0 = this->getQK0();
+
+        // Du = K11^-1 * (Qk - K12 * Dk - Qk0), by forward and back
+        // substitution on the factors of K11. K11 is factorized once and
+        // all load cases are solved as columns of a single right-hand side.
+        TPZFMatrix<double> DU(UDOF, nCases, 0);
+        for (int c = 0; c < nCases; c++) {
+            for (int i = 0; i < UDOF; i++) {
+                DU(i, c) = QK.Get(i, c) - QK0.Get(i, c);
+            }
+        }
+        this->getK12().multAdd(this->getDK(), DU, -1.);
 
-        DU = invK11 * (QK - K12 * DK - QK0);
+        if (Update != nullptr) {
+            // K11 differs from the factorized one by a low-rank change.
+            Update->solve(*fSolver, DU);
+        }
+        else {
+            if (!fReusedFactorization) {
+                factorizeK11();
+            }
+            fSolver->solve(DU);
+        }
 
-        for (int i = 0; i < UDOF; i++) {
-            fD(i, 0) = DU(i, 0);
+        for (int c = 0; c < nCases; c++) {
+            for (int i = 0; i < UDOF; i++) {
+                fD(i, c) = DU(i, c);
+            }
         }
     }
 }
@@ -571,25 +1844,116 @@ void TStructure::solveDU()
 //! Calculates the support reactions and stores them into Q.
 void TStructure::solveQU()
 {
+    TPhaseTimer timer(fProfile, ESolveQU);
+
     int UDOF = this->getUDOF();
     int CDOF = this->getCDOF();
 
-    TPZFMatrix<double> QU(UDOF, 1, 0);
-    TPZFMatrix<double> QU0 = this->getQU0();
-    if (UDOF == 0) {
-        TPZFMatrix<double> K21 = this->getK21();
-        TPZFMatrix<double> DU = this->getDU();
-        QU = K21 * DU + QU0;
+    // Qu = K21 * Du + K22 * Dk + Qu0, accumulated directly into Q.
+    for (int c = 0; c < this->getNCases(); c++) {
+        for (int i = 0; i < CDOF; i++) {
+            fQ(UDOF + i, c) = fQ0(UDOF + i, c);
+        }
     }
-    else {
-        TPZFMatrix<double> K21 = this->getK21();
-        TPZFMatrix<double> DU = this->getDU();
-        TPZFMatrix<double> K22 = this->getK22();
-        TPZFMatrix<double> DK = this->getDK();
-        QU = K21 * DU + K22 * DK + QU0;
+    this->getK21().multAdd(this->getDU(), fQ, 1., UDOF);
+    this->getK22().multAdd(this->getDK(), fQ, 1., UDOF);
+}
+
+//! Keeps what reanalyze() needs of the model whose K11 was just factorized.
+void TStructure::storeBaseModel()
+{
+    // The iterative solver keeps no factorization to be updated, and the
+    // update does not follow the condensed hinges or substructures.
+    fHasBaseModel = fUDOF > 0 && fSolverType != EPreconditionedCG &&
+                    fCondenseHinges == false && fCondensedSubstructures.empty();
+    if (!fHasBaseModel) return;
+
+    fBaseTopologyModel = getModelValues(false);
+    fBaseTopology = hashModel(fBaseTopologyModel);
+    fBaseMaterials = fMaterials;
+    fBaseElementMaterials.resize(fElements.size());
+    fBaseElementHinges.resize(fElements.size());
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        fBaseElementMaterials[i] = fElements[i].getMaterialID();
+        fBaseElementHinges[i] = (fElements[i].getHinge0() ? 1 : 0) |
+                                (fElements[i].getHinge1() ? 2 : 0);
     }
+    fBaseNodeEquations = fNodeEquations;
+    fBaseElementEquations = fElementEquations;
+    fBaseUDOF = fUDOF;
+}
+
+//! Calculates the condensed hinge rotations and stores them into D.
+void TStructure::recoverHinges()
+{
+    if (fHDOF == 0) return;
 
-    for (int i = 0; i < CDOF; i++) {
-        fQ(UDOF + i, 0) = QU(i, 0);
+    // Each hinged end rotates so that the moment at the hinge balances its
+    // loads: K_hh * Dh = -Q0_h - K_hr * Dr, with the full element matrix.
+    // With both ends hinged, the two rotations are solved together.
+    int dim = fUDOF + fCDOF;
+    for (int i = 0; i < (int)fElements.size(); i++) {
+        TElement& element = fElements[i];
+        if (element.getHinge0() == false && element.getHinge1() == false) continue;
+        if (fElementSubstructures[i] >= 0) continue;
+
+        TElementMatrix K = element.getK();
+        const int* equations = element.getEquations();
+        int hinges[2];
+        int nHinges = 0;
+        if (element.getHinge0()) hinges[nHinges++] = 2;
+        if (element.getHinge1()) hinges[nHinges++] = 5;
+
+        for (int c = 0; c < this->getNCases(); c++) {
+            double F[2];
+            for (int h = 0; h < nHinges; h++) {
+                F[h] = -fQ0(equations[hinges[h]], c);
+                for (int j = 0; j < 6; j++) {
+                    if (equations[j] < dim) F[h] -= K(hinges[h], j) * fD(equations[j], c);
+                }
+            }
+            if (nHinges == 1) {
+                fD(equations[hinges[0]], c) = F[0] / K(hinges[0], hinges[0]);
+            }
+            else {
+                double a = K(2, 2), b = K(2, 5), d = K(5, 5);
+                double det = a * d - b * b;
+                fD(equations[2], c) = (d * F[0] - b * F[1]) / det;
+                fD(equations[5], c) = (a * F[1] - b * F[0]) / det;
+            }
+        }
     }
 }
+
+//! Calculates the interior displacements of the substructures and stores them into D.
+void TStructure::recoverSubstructures()
+{
+    // D_I = K_II^-1 * (Qk_I - Q0_I) - X * D_B for each substructure. The
+    // interior rows of the substructures are disjoint, so they are recovered
+    // in parallel.
+    int nCases = this->getNCases();
+    int nSubstructures = fCondensedSubstructures.size();
+    parallelForEach(0, nSubstructures, fNThreads, [this, nCases](int s) {
+        const TSuperelement& superelement =
+            fSuperelements[fSubstructureSuperelements[s]];
+        const std::vector<int>& list = fSubstructureEquations[s];
+        int nInterior = fSubstructureNInterior[s];
+        int nBoundary = list.size() - nInterior;
+        TPZFMatrix<double> FI(nInterior, nCases, 0.);
+        TPZFMatrix<double> DB(nBoundary, nCases, 0.);
+        for (int c = 0; c < nCases; c++) {
+            for (int k = 0; k < nInterior; k++) {
+                FI(k, c) = fQ.GetVal(list[k], c) - fQ0.GetVal(list[k], c);
+            }
+            for (int k = 0; k < nBoundary; k++) {
+                DB(k, c) = fD.GetVal(list[nInterior + k], c);
+            }
+        }
+        superelement.recover(FI, DB);
+        for (int c = 0; c < nCases; c++) {
+            for (int k = 0; k < nInterior; k++) {
+                fD(list[k], c) = FI(k, c);
+            }
+        }
+    });
+}
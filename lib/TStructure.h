@@ -5,6 +5,7 @@
 #ifndef TSTRUCTURE_H
 #define TSTRUCTURE_H
 
+#include <cstdint>
 #include <iostream>
 #include "TNode.h"
 #include "TMaterial.h"
@@ -13,6 +14,14 @@
 #include "TNodalLoad.h"
 #include "TDistributedLoad.h"
 #include "TElementEndMoment.h"
+#include "TLoadCase.h"
+#include "TLoadCaseResult.h"
+#include "TSparseMatrix.h"
+#include "TLinearSolver.h"
+#include "TPCGSolver.h"
+#include "TLowRankUpdate.h"
+#include "TSuperelement.h"
+#include "TSolveProfile.h"
 //#include "TSupportDisplacement.h"
 
 // TStructure class and declarations of its functions.
@@ -27,6 +36,8 @@ public:
     TStructure(const TStructure& Other);
     //! Destructor.
     ~TStructure();
+    //! Assignment operator.
+    TStructure& operator=(const TStructure& Other);
 
     //! Modifies the vector of TNode objects.
     void setNodes(const std::vector<TNode>& Nodes);
@@ -36,6 +47,8 @@ public:
     void setSupports(const std::vector<TSupport>& Supports);
     //! Modifies the vector of TElement objects.
     void setElements(const std::vector<TElement>& Elements);
+    //! Modifies the substructures, each given by the IDs of its elements.
+    void setSubstructures(const std::vector<std::vector<int>>& Substructures);
 
     //! Gets the vector of TNode objects.
     std::vector<TNode> getNodes();
@@ -45,7 +58,13 @@ public:
     std::vector<TSupport> getSupports();
     //! Gets the vector of TElement objects.
     std::vector<TElement> getElements();
+    //! Gets the substructures, each given by the IDs of its elements.
+    const std::vector<std::vector<int>>& getSubstructures() const;
 
+    //! Gets one of the TNode objects by reference.
+    const TNode& getNode(int NodeID) const;
+    //! Gets one of the TMaterial objects by reference.
+    const TMaterial& getMaterial(int MaterialID) const;
     //! Gets one of the TElement objects by copy.
     TElement getElement(int elementID);
     //! Gets the addres of one of the TElement objects.
@@ -53,7 +72,11 @@ public:
     //! Gets a support ID by giving its node ID.
     int getSupportID(int NodeID);
     //! Gets the matrix of degrees of freedom of the nodes.
-    TPZFMatrix<int> getNodeEquations();
+    const TPZFMatrix<int>& getNodeEquations() const;
+    //! Gets the degree of freedom of a node in a direction (0: x, 1: y, 2: rotation).
+    int getNodeEquation(int NodeID, int Direction) const;
+    //! Gets the degrees of freedom of all elements, six per element.
+    const std::vector<int>& getElementEquations() const;
 
     //! Gets the total number of degrees of freedom of the structure.
     int getNDOF() const;
@@ -61,51 +84,142 @@ public:
     int getCDOF() const;
     //! Gets the number of unconstrained degrees of freedom of the structure.
     int getUDOF() const;
+    //! Gets the number of hinge rotations condensed out of K (see setCondenseHinges()).
+    int getHDOF() const;
+    //! Gets the number of interior degrees of freedom of the substructures, condensed out of K.
+    int getIDOF() const;
+    //! Gets the number of condensed substructures computed by the last assembly (identical ones share one).
+    int getNSuperelements() const;
     //! Enumerates the degrees of freedom of each TElement object.
     void enumerateEquations();
+    //! Marks the enumerated degrees of freedom as outdated.
+    void invalidateEquations();
+    //! Enables numbering the unconstrained DOF in Reverse Cuthill-McKee node order.
+    void setRenumbering(bool Renumber);
+    //! Gets if the unconstrained DOF are numbered in Reverse Cuthill-McKee node order.
+    bool getRenumbering() const;
+    //! Enables condensing the rotations of hinged element ends out of K, element by element.
+    void setCondenseHinges(bool Condense);
+    //! Gets if the rotations of hinged element ends are condensed out of K.
+    bool getCondenseHinges() const;
+    //! Modifies the number of subdomains the elements are split into when no substructure is declared (1: none).
+    void setNumberOfSubdomains(int NSubdomains);
+    //! Gets the number of subdomains the elements are split into when no substructure is declared (1: none).
+    int getNumberOfSubdomains() const;
+    //! Modifies the method used to solve K11 * Du = F.
+    void setSolverType(ESolverType Type);
+    //! Gets the method used to solve K11 * Du = F.
+    ESolverType getSolverType() const;
+    //! Gets the solver holding the last factorization of K11 (nullptr before the first solve).
+    const TLinearSolver* getSolver() const;
+    //! Computes a hash of everything the matrix K and the factorization of K11 depend on.
+    uint64_t getModelSignature() const;
+    //! Gets if the last solve reused K and the factorization of K11 of the previous one.
+    bool getReusedFactorization() const;
+    //! Modifies the preconditioner of the EPreconditionedCG solver.
+    void setPreconditioner(EPreconditioner Preconditioner);
+    //! Gets the preconditioner of the EPreconditionedCG solver.
+    EPreconditioner getPreconditioner() const;
+    //! Modifies the relative residual the EPreconditionedCG solver must reach.
+    void setTolerance(double Tolerance);
+    //! Gets the relative residual the EPreconditionedCG solver must reach.
+    double getTolerance() const;
+    //! Modifies the maximum number of iterations of the EPreconditionedCG solver.
+    void setMaxIterations(int MaxIterations);
+    //! Gets the maximum number of iterations of the EPreconditionedCG solver.
+    int getMaxIterations() const;
+    //! Gets the iterations of the last EPreconditionedCG solve (0 for direct solvers).
+    int getIterations() const;
+    //! Gets the relative residual of the last EPreconditionedCG solve (0 for direct solvers).
+    double getResidual() const;
+    //! Gets the wall time, calls and allocated bytes of each phase of the solves.
+    const TSolveProfile& getProfile() const;
+    //! Zeroes the measures of the phases of the solves.
+    void resetProfile();
+    //! Enables storing only the upper triangle of the symmetric matrix K.
+    void setSymmetricStorage(bool Symmetric);
+    //! Gets if only the upper triangle of the symmetric matrix K is stored.
+    bool getSymmetricStorage() const;
+    //! Modifies the number of threads used by the element loops (0: all hardware threads).
+    void setNumberOfThreads(int NThreads);
+    //! Gets the number of threads used by the element loops (0: all hardware threads).
+    int getNumberOfThreads() const;
+    //! Computes and stores the length, cosine and sine of each TElement object.
+    void updateGeometry();
 
-    //! Gets the structure stiffness matrix.
-    TPZFMatrix<double> getK() const;
-    //! Gets the left upper block of the structure stiffness matrix K.
-    TPZFMatrix<double> getK11() const;
-    //! Gets the right upper block of the structure stiffness matrix K.
-    TPZFMatrix<double> getK12() const;
-    //! Gets the left lower block of the structure stiffness matrix K.
-    TPZFMatrix<double> getK21() const;
-    //! Gets the right lower block of the structure stiffness matrix K.
-    TPZFMatrix<double> getK22() const;
+    //! Gets the (sparse) structure stiffness matrix.
+    const TSparseMatrix& getK() const;
+    //! Gets a view of the left upper block of the structure stiffness matrix K.
+    TSparseBlock getK11() const;
+    //! Gets a view of the right upper block of the structure stiffness matrix K.
+    TSparseBlock getK12() const;
+    //! Gets a view of the left lower block of the structure stiffness matrix K.
+    TSparseBlock getK21() const;
+    //! Gets a view of the right lower block of the structure stiffness matrix K.
+    TSparseBlock getK22() const;
 
     //! Gets the vector of external loads Q.
     TPZFMatrix<double> getQ() const;
-    //! Gets the known part Qk (applied nodal loads) of loads vector Q.
-    TPZFMatrix<double> getQK() const;
-    //! Gets the unknown part Qu (support reactions) of loads vector Q.
-    TPZFMatrix<double> getQU() const;
+    //! Gets a view of the known part Qk (applied nodal loads) of loads vector Q.
+    TDenseBlock getQK() const;
+    //! Gets a view of the unknown part Qu (support reactions) of loads vector Q.
+    TDenseBlock getQU() const;
 
     //! Gets the vector of equivalent nodal loads caused by intermediate loads.
     TPZFMatrix<double> getQ0() const;
-    //! Gets the known part Qk0 of the equivalent nodal loads vector Q0.
-    TPZFMatrix<double> getQK0() const;
-    //! Gets the unknown part Qu0 of the equivalent nodal loads vector Q0.
-    TPZFMatrix<double> getQU0() const;
+    //! Gets a view of the known part Qk0 of the equivalent nodal loads vector Q0.
+    TDenseBlock getQK0() const;
+    //! Gets a view of the unknown part Qu0 of the equivalent nodal loads vector Q0.
+    TDenseBlock getQU0() const;
 
     //! Gets the vector of nodal displacements.
     TPZFMatrix<double> getD() const;
-    //! Gets the known displacements Dk at constrained degrees of freedom.
-    TPZFMatrix<double> getDK() const;
-    //! Gets the unknown displacements Du at unconstrained degrees of freedom.
-    TPZFMatrix<double> getDU() const;
+    //! Gets a view of the known displacements Dk at constrained degrees of freedom.
+    TDenseBlock getDK() const;
+    //! Gets a view of the unknown displacements Du at unconstrained degrees of freedom.
+    TDenseBlock getDU() const;
 
-    //! Calculates the internal loads of a given element.
-    void getInternalLoads(int ElementID, TPZFMatrix<double>& q);
+    //! Gets the number of load cases (columns of Q, Q0 and D) of the last solution.
+    int getNCases() const;
+
+    //! Calculates the internal loads of a given element for a given load case.
+    void getInternalLoads(int ElementID, TPZFMatrix<double>& q, int Case = 0);
 
     //! Solve all the steps of structure accordingly to get the final results.
     void solve(std::vector<TNodalLoad>& NodalLoads,
                std::vector<TDistributedLoad>& DistrLoads,
                std::vector<TElementEndMoment>& EndMoments,
                std::vector<TPZFMatrix<double>>& InternalLoads);
+    //! Solves many load cases at once, with a single factorization of K11.
+    void solve(std::vector<TLoadCase>& LoadCases,
+               std::vector<TLoadCaseResult>& Results);
+    //! Modifies the materials and the elements and solves again, updating the last factorization of K11.
+    bool reanalyze(const std::vector<TMaterial>& Materials,
+                   const std::vector<TElement>& Elements,
+                   std::vector<TLoadCase>& LoadCases,
+                   std::vector<TLoadCaseResult>& Results);
+    //! Modifies the largest number of changed equations reanalyze() solves without factorizing K11.
+    void setMaxUpdateRank(int MaxRank);
+    //! Gets the largest number of changed equations reanalyze() solves without factorizing K11.
+    int getMaxUpdateRank() const;
 
 private:
+    //! Counts the total number of degrees of freedom by scanning the model.
+    int countNDOF() const;
+    //! Counts the number of constrained degrees of freedom by scanning the model.
+    int countCDOF() const;
+    //! Counts the number of interior degrees of freedom of the substructures by scanning the model.
+    int countIDOF() const;
+    //! Gets the substructures condensed out of K: the declared ones, or else the subdomains.
+    std::vector<std::vector<int>> getCondensedSubstructures() const;
+    //! Finds the substructure of each element and the one each node is interior to (-1: none).
+    std::vector<int> getInteriorNodes(const std::vector<std::vector<int>>& Substructures,
+                                      std::vector<int>& ElementSubstructures) const;
+    //! Lists the values of the model, with or without the materials and hinges of the elements.
+    std::vector<int64_t> getModelValues(bool Properties) const;
+    //! Computes a hash of the values of a model (see getModelValues()).
+    static uint64_t hashModel(const std::vector<int64_t>& Values);
+
     // fNodes - vector containing the structure nodes.
     std::vector<TNode> fNodes;
     // fMaterials - vector containing the available materials.
@@ -114,32 +228,129 @@ private:
     std::vector<TSupport> fSupports;
     // fElements - vector containing the structure elements.
     std::vector<TElement> fElements;
+    // fSubstructures - IDs of the elements of each substructure.
+    std::vector<std::vector<int>> fSubstructures;
     // fNodeEquations - matrix containing the DOFs of the nodes.
     TPZFMatrix<int> fNodeEquations;
+    // fElementEquations - vector containing the six DOFs of each element.
+    std::vector<int> fElementEquations;
+    // fHasEquations - marks if the DOF data below is up to date.
+    bool fHasEquations;
+    // fNDOF - total number of degrees of freedom.
+    int fNDOF;
+    // fCDOF - number of constrained degrees of freedom.
+    int fCDOF;
+    // fUDOF - number of unconstrained degrees of freedom.
+    int fUDOF;
+    // fHDOF - number of condensed hinge rotations, numbered after the constrained DOF.
+    int fHDOF;
+    // fIDOF - number of interior DOF of the substructures, numbered after the hinge rotations.
+    int fIDOF;
+    // fCondensedSubstructures - IDs of the elements of each substructure condensed out of K.
+    std::vector<std::vector<int>> fCondensedSubstructures;
+    // fElementSubstructures - substructure of each element (-1: none).
+    std::vector<int> fElementSubstructures;
+    // fSubstructureEquations - DOF of each substructure, the interior ones first.
+    std::vector<std::vector<int>> fSubstructureEquations;
+    // fSubstructureNInterior - number of interior DOF of each substructure.
+    std::vector<int> fSubstructureNInterior;
 
-    // fK - structure stiffness matrix.
-    TPZFMatrix<double> fK;
-    // fQ - structure external load vector.
+    // fK - structure stiffness matrix, with the pattern of the element equations.
+    TSparseMatrix fK;
+    // fQ - structure external load vector (one column per load case).
     TPZFMatrix<double> fQ;
-    // fQ0 - initial forces caused by intermediate loads.
+    // fQ0 - initial forces caused by intermediate loads (one column per load case).
     TPZFMatrix<double> fQ0;
-    // fD - structure displacement vector.
+    // fD - structure displacement vector (one column per load case).
     TPZFMatrix<double> fD;
+    // fElementQ0 - local initial loads of the elements (six rows per element).
+    TPZFMatrix<double> fElementQ0;
+    // fSuperelements - condensed stiffness of the distinct substructures.
+    std::vector<TSuperelement> fSuperelements;
+    // fSubstructureSuperelements - index in fSuperelements of each substructure.
+    std::vector<int> fSubstructureSuperelements;
+    // fRenumber - marks if the unconstrained DOF are numbered in RCM node order.
+    bool fRenumber;
+    // fCondenseHinges - marks if the hinged end rotations are condensed out of K.
+    bool fCondenseHinges;
+    // fNSubdomains - number of subdomains of the domain decomposition (1: none).
+    int fNSubdomains;
+    // fSolverType - method used to solve K11 * Du = F.
+    ESolverType fSolverType;
+    // fSolver - solver holding the factorization of K11 (owned).
+    TLinearSolver* fSolver;
+    // fHasFactorization - marks if fK and fSolver hold the model of fFactorSignature.
+    bool fHasFactorization;
+    // fFactorSignature - model signature (see getModelSignature()) of fK and fSolver.
+    uint64_t fFactorSignature;
+    // fFactorModel - model values (see getModelValues()) of fK and fSolver.
+    std::vector<int64_t> fFactorModel;
+    // fReusedFactorization - marks if the last solve reused fK and fSolver.
+    bool fReusedFactorization;
+    // fPreconditioner - preconditioner of the EPreconditionedCG solver.
+    EPreconditioner fPreconditioner;
+    // fTolerance - relative residual the EPreconditionedCG solver must reach.
+    double fTolerance;
+    // fMaxIterations - maximum number of iterations of the EPreconditionedCG solver.
+    int fMaxIterations;
+    // fSymmetricStorage - marks if only the upper triangle of K is stored.
+    bool fSymmetricStorage;
+    // fNThreads - number of threads used by the element loops (0: all hardware threads).
+    int fNThreads;
+    // fProfile - wall time, calls and allocated bytes of each phase of the solves.
+    TSolveProfile fProfile;
+    // fMaxUpdateRank - largest number of changed equations solved by an update of fSolver.
+    int fMaxUpdateRank;
+    // fHasBaseModel - marks if fSolver holds the factorization of the base model below.
+    bool fHasBaseModel;
+    // fBaseTopology - hash of the nodes, supports, connectivity and settings of the base model.
+    uint64_t fBaseTopology;
+    // fBaseTopologyModel - values of the nodes, supports, connectivity and settings of the base model.
+    std::vector<int64_t> fBaseTopologyModel;
+    // fBaseMaterials - materials of the base model.
+    std::vector<TMaterial> fBaseMaterials;
+    // fBaseElementMaterials - material ID of each element of the base model.
+    std::vector<int> fBaseElementMaterials;
+    // fBaseElementHinges - hinges of each element of the base model (bit 0: node 0, bit 1: node 1).
+    std::vector<char> fBaseElementHinges;
+    // fBaseNodeEquations, fBaseElementEquations, fBaseUDOF - DOF of the base model.
+    TPZFMatrix<int> fBaseNodeEquations;
+    std::vector<int> fBaseElementEquations;
+    int fBaseUDOF;
 
+    //! Groups the elements in colors, so that no two elements of a color share a node.
+    void colorElements(std::vector<int>& ColorPtr,
+                       std::vector<int>& ColorElements) const;
     //! Assembles the structure stiffness matrix.
     void populateK();
-    //! Stores the effects of loads into Q.
-    void populateQ(std::vector<TNodalLoad>& NodalLoads,
-                   std::vector<TElementEndMoment>& EndMoments);
-    //! Stores the effects of distributed loads into Q0.
-    void populateQ0(std::vector<TDistributedLoad>& DistrLoads);
+    //! Stores the effects of loads into Q, one column per load case.
+    void populateQ(std::vector<TLoadCase>& LoadCases);
+    //! Stores the effects of distributed loads into Q0, one column per load case.
+    void populateQ0(std::vector<TLoadCase>& LoadCases);
     //! Stores the known displacements into D.
     //void populateDK(/*std::vector<TSupportDisplacement>& supportDisplacements*/);
 
+    //! Orders the nodes to reduce the bandwidth of K11.
+    std::vector<int> getNodeOrder() const;
+    //! Computes the factorization of K11 and stores it.
+    void factorizeK11();
     //! Calculates the unknown displacements Du and stores them into D.
-    void solveDU();
+    void solveDU(const TLowRankUpdate* Update = nullptr);
     //! Calculates the support reactions and stores them into Q.
     void solveQU();
+    //! Calculates the condensed hinge rotations and stores them into D.
+    void recoverHinges();
+    //! Condenses each substructure to its boundary DOF, once per distinct substructure.
+    void condenseSubstructures();
+    //! Condenses the subdomains of the domain decomposition to their interfaces, in parallel.
+    void condenseSubdomains();
+    //! Calculates the interior displacements of the substructures and stores them into D.
+    void recoverSubstructures();
+    //! Keeps what reanalyze() needs of the model whose K11 was just factorized.
+    void storeBaseModel();
+    //! Splits D and Q by load case and computes the internal loads of each one.
+    void splitResults(std::vector<TLoadCase>& LoadCases,
+                      std::vector<TLoadCaseResult>& Results);
 };
 
 #endif // TSTRUCTURE_H
@@ -0,0 +1,184 @@
+/** \file TSuperelement.cpp
+* Contains the definitions of the TSuperelement methods.
+*/
+
+#include <algorithm>
+#include "TSuperelement.h"
+
+//! Default constructor.
+TSuperelement::TSuperelement() : fNInterior(0), fNBoundary(0), fSolver(nullptr) {}
+
+//! Copy constructor.
+TSuperelement::TSuperelement(const TSuperelement& Other) : fSolver(nullptr)
+{
+    this->operator=(Other);
+}
+
+//! Destructor.
+TSuperelement::~TSuperelement()
+{
+    delete fSolver;
+}
+
+//! Assignment operator.
+TSuperelement& TSuperelement::operator=(const TSuperelement& Other)
+{
+    if (this == &Other) return *this;
+    fNInterior = Other.fNInterior;
+    fNBoundary = Other.fNBoundary;
+    fFactor = Other.fFactor;
+    fX = Other.fX;
+    fK = Other.fK;
+    fS = Other.fS;
+    delete fSolver;
+    fSolver = (Other.fSolver != nullptr) ? Other.fSolver->clone() : nullptr;
+    return *this;
+}
+
+//! Condenses the stiffness matrix of a substructure.
+void TSuperelement::condense(const TPZFMatrix<double>& K, int NInterior)
+{
+    int n = K.Rows();
+    fNInterior = NInterior;
+    fNBoundary = n - NInterior;
+
+    // K_II is symmetric positive definite unless the interior is a mechanism
+    // with the boundary fixed.
+    fFactor = TPZFMatrix<double>(fNInterior, fNInterior, 0.);
+    fX = TPZFMatrix<double>(fNInterior, fNBoundary, 0.);
+    for (int j = 0; j < fNInterior; j++) {
+        for (int i = 0; i < fNInterior; i++) {
+            fFactor(i, j) = K.GetVal(i, j);
+        }
+    }
+    for (int j = 0; j < fNBoundary; j++) {
+        for (int i = 0; i < fNInterior; i++) {
+            fX(i, j) = K.GetVal(i, fNInterior + j);
+        }
+    }
+    if (fNInterior > 0) {
+        fFactor.Decompose_Cholesky();
+        fFactor.Subst_Forward(&fX);
+        fFactor.Subst_Backward(&fX);
+    }
+
+    // S = K_BB - K_BI * X.
+    fS = TPZFMatrix<double>(fNBoundary, fNBoundary, 0.);
+    for (int j = 0; j < fNBoundary; j++) {
+        for (int i = 0; i < fNBoundary; i++) {
+            double sum = K.GetVal(fNInterior + i, fNInterior + j);
+            for (int k = 0; k < fNInterior; k++) {
+                sum -= K.GetVal(fNInterior + i, k) * fX.GetVal(k, j);
+            }
+            fS(i, j) = sum;
+        }
+    }
+}
+
+//! Condenses the sparse stiffness matrix of a large substructure.
+void TSuperelement::condense(const TSparseMatrix& K, int NInterior, ESolverType Type)
+{
+    int n = K.Rows();
+    fNInterior = NInterior;
+    fNBoundary = n - NInterior;
+    fFactor = TPZFMatrix<double>();
+    fX = TPZFMatrix<double>();
+    fK = K;
+    delete fSolver;
+    fSolver = TLinearSolver::create(Type);
+
+    // S = K_BB - K_BI * K_II^-1 * K_IB. The columns of K_IB are solved a
+    // few at a time, to bound the memory.
+    fS = fK.getBlock(fNInterior, fNBoundary, fNInterior, fNBoundary).toDense();
+    if (fNInterior == 0) return;
+
+    fSolver->factorize(fK.getBlock(0, fNInterior, 0, fNInterior));
+    TSparseBlock KIB = fK.getBlock(0, fNInterior, fNInterior, fNBoundary);
+    TSparseBlock KBI = fK.getBlock(fNInterior, fNBoundary, 0, fNInterior);
+    const int blockSize = 64;
+    for (int first = 0; first < fNBoundary; first += blockSize) {
+        int m = std::min(blockSize, fNBoundary - first);
+        TPZFMatrix<double> E(fNBoundary, m, 0.);
+        for (int j = 0; j < m; j++) {
+            E(first + j, j) = 1.;
+        }
+        TPZFMatrix<double> Y(fNInterior, m, 0.);
+        KIB.multAdd(E, Y);
+        fSolver->solve(Y);
+        TPZFMatrix<double> SY(fNBoundary, m, 0.);
+        KBI.multAdd(Y, SY);
+        for (int j = 0; j < m; j++) {
+            for (int i = 0; i < fNBoundary; i++) {
+                fS(i, first + j) -= SY(i, j);
+            }
+        }
+    }
+}
+
+//! Gets the number of interior equations.
+int TSuperelement::getNInterior() const
+{
+    return fNInterior;
+}
+
+//! Gets the number of boundary equations.
+int TSuperelement::getNBoundary() const
+{
+    return fNBoundary;
+}
+
+//! Gets the condensed stiffness matrix S of the boundary equations.
+const TPZFMatrix<double>& TSuperelement::getS() const
+{
+    return fS;
+}
+
+//! Computes the boundary loads equivalent to interior loads.
+void TSuperelement::condenseLoads(const TPZFMatrix<double>& FI,
+                                  TPZFMatrix<double>& FB) const
+{
+    // K_BI * K_II^-1 * FI = X^T * FI, as K is symmetric.
+    int nCases = FI.Cols();
+    FB = TPZFMatrix<double>(fNBoundary, nCases, 0.);
+    if (fSolver != nullptr) {
+        if (fNInterior == 0) return;
+        TPZFMatrix<double> Y = FI;
+        fSolver->solve(Y);
+        fK.getBlock(fNInterior, fNBoundary, 0, fNInterior).multAdd(Y, FB);
+        return;
+    }
+    for (int c = 0; c < nCases; c++) {
+        for (int j = 0; j < fNBoundary; j++) {
+            double sum = 0.;
+            for (int k = 0; k < fNInterior; k++) {
+                sum += fX.GetVal(k, j) * FI.GetVal(k, c);
+            }
+            FB(j, c) = sum;
+        }
+    }
+}
+
+//! Recovers the interior displacements from the boundary ones.
+void TSuperelement::recover(TPZFMatrix<double>& FI,
+                            const TPZFMatrix<double>& DB) const
+{
+    if (fNInterior == 0) return;
+
+    if (fSolver != nullptr) {
+        // K_II^-1 * (FI - K_IB * DB).
+        fK.getBlock(0, fNInterior, fNInterior, fNBoundary).multAdd(DB, FI, -1.);
+        fSolver->solve(FI);
+        return;
+    }
+    fFactor.Subst_Forward(&FI);
+    fFactor.Subst_Backward(&FI);
+    for (int c = 0; c < FI.Cols(); c++) {
+        for (int j = 0; j < fNBoundary; j++) {
+            double d = DB.GetVal(j, c);
+            if (d == 0.) continue;
+            for (int i = 0; i < fNInterior; i++) {
+                FI(i, c) -= fX.GetVal(i, j) * d;
+            }
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/** \file TSuperelement.h
+* Contains the declaration of the TSuperelement class.
+*/
+
+#ifndef TSUPERELEMENT_H
+#define TSUPERELEMENT_H
+
+#include "pzfmatrix.h"
+#include "TSparseMatrix.h"
+#include "TLinearSolver.h"
+
+//!  A class that holds the stiffness of a substructure condensed to its boundary.
+/*!
+     A class that holds the stiffness of a substructure condensed to its
+	 boundary equations. Its matrix is split into interior (I) and boundary
+	 (B) equations, and the interior ones are eliminated:
+	 S = K_BB - K_BI * K_II^-1 * K_IB (the Schur complement).
+	 The factor of K_II and X = K_II^-1 * K_IB are kept, so the loads of the
+	 interior can be condensed and its displacements recovered for any number
+	 of load cases. Identical substructures share one TSuperelement.
+
+	 Large substructures (the subdomains of a domain decomposition) are
+	 condensed from a sparse matrix instead: K_II is factorized by a sparse
+	 solver and X is not stored, so the loads are condensed and the interior
+	 recovered with one solve per load case.
+*/
+class TSuperelement
+{
+public:
+    //! Default constructor.
+    TSuperelement();
+
+    //! Copy constructor.
+    TSuperelement(const TSuperelement& Other);
+
+    //! Destructor.
+    ~TSuperelement();
+
+    //! Assignment operator.
+    TSuperelement& operator=(const TSuperelement& Other);
+
+    //! Condenses the stiffness matrix of a substructure.
+    /*!
+    \param K the symmetric matrix of the substructure, with the interior
+    equations first.
+    \param NInterior the number of interior equations.
+    */
+    void condense(const TPZFMatrix<double>& K, int NInterior);
+
+    //! Condenses the sparse stiffness matrix of a large substructure.
+    /*!
+    \param K the symmetric matrix of the substructure, with the interior
+    equations first. It is kept to condense the loads and recover the interior.
+    \param NInterior the number of interior equations.
+    \param Type the solver used to factorize K_II.
+    */
+    void condense(const TSparseMatrix& K, int NInterior, ESolverType Type);
+
+    //! Gets the number of interior equations.
+    int getNInterior() const;
+    //! Gets the number of boundary equations.
+    int getNBoundary() const;
+    //! Gets the condensed stiffness matrix S of the boundary equations.
+    const TPZFMatrix<double>& getS() const;
+
+    //! Computes the boundary loads equivalent to interior loads.
+    /*!
+    \param FI the interior loads, one column per load case.
+    \param FB receives K_BI * K_II^-1 * FI, the loads the interior transmits
+    to the boundary when the boundary is fixed.
+    */
+    void condenseLoads(const TPZFMatrix<double>& FI, TPZFMatrix<double>& FB) const;
+
+    //! Recovers the interior displacements from the boundary ones.
+    /*!
+    \param FI the interior loads, one column per load case. It is
+    overwritten with the interior displacements K_II^-1 * FI - X * DB.
+    \param DB the boundary displacements, one column per load case.
+    */
+    void recover(TPZFMatrix<double>& FI, const TPZFMatrix<double>& DB) const;
+
+private:
+    //! The number of interior equations.
+    int fNInterior;
+    //! The number of boundary equations.
+    int fNBoundary;
+    //! The Cholesky factor of K_II (dense form only).
+    TPZFMatrix<double> fFactor;
+    //! The interior displacements caused by unit boundary displacements, K_II^-1 * K_IB (dense form only).
+    TPZFMatrix<double> fX;
+    //! The matrix of the substructure (sparse form only).
+    TSparseMatrix fK;
+    //! The solver holding the factorization of K_II (sparse form only, else nullptr).
+    TLinearSolver* fSolver;
+    //! The condensed stiffness matrix of the boundary equations.
+    TPZFMatrix<double> fS;
+};
+
+#endif // TSUPERELEMENT_H